@@ -0,0 +1,22 @@
+#include "benchmark.h"
+
+#include <libbase/runtime_assert.h>
+#include <libbase/timer.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+double benchmark(const std::string &name, const std::function<void()> &f, int iterations) {
+    rassert(iterations > 0, 4398127313, iterations);
+    double best = std::numeric_limits<double>::max();
+    for (int it = 0; it < iterations; ++it) {
+        Timer t;
+        f();
+        best = std::min(best, t.elapsed());
+    }
+    std::cout << "[benchmark] " << std::left << std::setw(48) << name << " " << std::fixed << std::setprecision(4)
+              << best << " sec" << std::endl;
+    return best;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+// Runs f() iterations times, prints and returns the best wall time (in seconds).
+double benchmark(const std::string &name, const std::function<void()> &f, int iterations = 3);
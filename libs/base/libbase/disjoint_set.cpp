@@ -47,4 +47,95 @@ bool DisjointSetUnion::unite(std::size_t a, std::size_t b, std::source_location
 std::size_t DisjointSetUnion::set_size(std::size_t x, std::source_location loc) const {
     const std::size_t r = find(x, loc);
     return sz_[r];
-}
\ No newline at end of file
+}
+
+template <typename Index>
+DisjointSet<Index>::DisjointSet(std::size_t n) : data_(n, kRootBit | Index(1)) {
+    rassert(n < kRootBit, 2391578193415, n);
+}
+
+template <typename Index>
+Index DisjointSet<Index>::find(Index x) {
+    rassert(x < size(), 2391578193416, x, size());
+    while (!(data_[x] & kRootBit)) {
+        const Index p = data_[x];
+        if (!(data_[p] & kRootBit))
+            data_[x] = data_[p];
+        x = data_[x];
+    }
+    return x;
+}
+
+template <typename Index>
+bool DisjointSet<Index>::unite(Index a, Index b) {
+    a = find(a);
+    b = find(b);
+    if (a == b)
+        return false;
+    Index size_a = data_[a] & ~kRootBit;
+    Index size_b = data_[b] & ~kRootBit;
+    if (size_a < size_b) {
+        std::swap(a, b);
+        std::swap(size_a, size_b);
+    }
+    data_[b] = a;
+    data_[a] = kRootBit | (size_a + size_b);
+    return true;
+}
+
+template <typename Index>
+ConcurrentDisjointSet<Index>::ConcurrentDisjointSet(std::size_t n) : n_(n), parent_(new std::atomic<Index>[n]) {
+    rassert(n <= std::numeric_limits<Index>::max(), 2391578193417, n);
+    for (std::size_t i = 0; i < n; ++i)
+        parent_[i].store(static_cast<Index>(i), std::memory_order_relaxed);
+}
+
+template <typename Index>
+Index ConcurrentDisjointSet<Index>::find(Index x) {
+    rassert(x < n_, 2391578193418, x, n_);
+    while (true) {
+        Index p = parent_[x].load(std::memory_order_acquire);
+        if (p == x)
+            return x;
+        const Index gp = parent_[p].load(std::memory_order_acquire);
+        if (p != gp) {
+            // path splitting: gp is an ancestor of x as well, if somebody changed parent of x meanwhile it is fine too
+            parent_[x].compare_exchange_weak(p, gp, std::memory_order_acq_rel, std::memory_order_relaxed);
+        }
+        x = p;
+    }
+}
+
+template <typename Index>
+bool ConcurrentDisjointSet<Index>::unite(Index a, Index b) {
+    while (true) {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return false;
+        if (a < b)
+            std::swap(a, b);
+        // a > b: link a under b, only if a is still a root
+        Index expected = a;
+        if (parent_[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel, std::memory_order_acquire))
+            return true;
+    }
+}
+
+template <typename Index>
+bool ConcurrentDisjointSet<Index>::same(Index a, Index b) {
+    while (true) {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return true;
+        // a still being a root means that the sets were different at the moment of the check
+        if (parent_[a].load(std::memory_order_acquire) == a)
+            return false;
+    }
+}
+
+template class DisjointSet<std::uint32_t>;
+template class DisjointSet<std::uint64_t>;
+template class ConcurrentDisjointSet<std::uint32_t>;
+template class ConcurrentDisjointSet<std::uint64_t>;
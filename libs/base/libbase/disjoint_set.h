@@ -1,6 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <source_location>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -25,4 +31,58 @@ public:
 private:
     std::vector<std::size_t> parent_;
     std::vector<std::size_t> sz_;
-};
\ No newline at end of file
+};
+
+// Disjoint set union with a single Index word per element (std::uint32_t is enough for images below 2 G pixels):
+// a non-root stores its parent, a root stores kRootBit | size of its set (union by size). 4 bytes per element
+// with std::uint32_t instead of 16 bytes of DisjointSetUnion. find() uses path halving.
+template <typename Index>
+class DisjointSet final {
+  public:
+    static_assert(std::is_unsigned_v<Index>);
+    static constexpr Index kRootBit = Index(1) << (std::numeric_limits<Index>::digits - 1);
+
+    // n < kRootBit: the size of a set of all n elements must not reach the root bit
+    explicit DisjointSet(std::size_t n);
+
+    std::size_t size() const noexcept { return data_.size(); }
+
+    Index find(Index x);
+    // Unites sets containing a and b. Returns true if merged.
+    bool unite(Index a, Index b);
+    bool same(Index a, Index b) { return find(a) == find(b); }
+    Index set_size(Index x) { return data_[find(x)] & ~kRootBit; }
+
+  private:
+    std::vector<Index> data_;
+};
+
+// Lock-free disjoint set union for concurrent unite()/find() from many threads (e.g. inside of OpenMP loops).
+// Roots point to themselves, unite() links the root with the bigger index under the root with the smaller one
+// by CAS (so links never form a cycle, a failed CAS means another thread changed that root - retry),
+// find() never blocks: path splitting replaces parent by grandparent with a CAS that may fail harmlessly.
+// Union by index instead of by size/rank keeps every link a single CAS.
+template <typename Index>
+class ConcurrentDisjointSet final {
+  public:
+    static_assert(std::is_unsigned_v<Index>);
+
+    explicit ConcurrentDisjointSet(std::size_t n);
+
+    std::size_t size() const noexcept { return n_; }
+
+    Index find(Index x);
+    // Unites sets containing a and b. Returns true if this call merged them.
+    bool unite(Index a, Index b);
+    // Linearizable: true if a and b are in the same set at some moment during the call.
+    bool same(Index a, Index b);
+
+  private:
+    std::size_t n_;
+    std::unique_ptr<std::atomic<Index>[]> parent_;
+};
+
+extern template class DisjointSet<std::uint32_t>;
+extern template class DisjointSet<std::uint64_t>;
+extern template class ConcurrentDisjointSet<std::uint32_t>;
+extern template class ConcurrentDisjointSet<std::uint64_t>;
@@ -0,0 +1,67 @@
+#include "disjoint_set.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kElements = 24000000; // pixels of a full-resolution 24 MP board photo
+
+// 4-connected grid edges of a 6000x4000 image in raster order (like labelling pixels), plus random long edges
+std::vector<std::pair<std::uint32_t, std::uint32_t>> makeEdges() {
+    const std::uint32_t w = 6000;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+    edges.reserve(kElements / 2);
+    std::mt19937 rng(239);
+    for (std::uint32_t i = w; i < kElements; i += 4) {
+        edges.emplace_back(i, i - 1);
+        edges.emplace_back(i, i - w);
+    }
+    std::uniform_int_distribution<std::uint32_t> dist(0, kElements - 1);
+    for (int i = 0; i < 1000000; ++i)
+        edges.emplace_back(dist(rng), dist(rng));
+    return edges;
+}
+
+} // namespace
+
+TEST(disjoint_set_benchmark, uniteAndFind) {
+    const auto edges = makeEdges();
+
+    benchmark("DisjointSetUnion (size_t)", [&]() {
+        DisjointSetUnion dsu(kElements);
+        for (const auto &[a, b] : edges)
+            dsu.unite(a, b);
+    });
+    benchmark("DisjointSet<uint32_t>", [&]() {
+        DisjointSet<std::uint32_t> dsu(kElements);
+        for (const auto &[a, b] : edges)
+            dsu.unite(a, b);
+    });
+    benchmark("ConcurrentDisjointSet<uint32_t> 1 thread", [&]() {
+        ConcurrentDisjointSet<std::uint32_t> dsu(kElements);
+        for (const auto &[a, b] : edges)
+            dsu.unite(a, b);
+    });
+
+    const unsigned threadsCount = std::max(2u, std::thread::hardware_concurrency());
+    benchmark("ConcurrentDisjointSet<uint32_t> " + std::to_string(threadsCount) + " threads", [&]() {
+        ConcurrentDisjointSet<std::uint32_t> dsu(kElements);
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < threadsCount; ++t) {
+            threads.emplace_back([&, t]() {
+                for (std::size_t i = t; i < edges.size(); i += threadsCount)
+                    dsu.unite(edges[i].first, edges[i].second);
+            });
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+    });
+}
@@ -2,9 +2,12 @@
 
 #include <gtest/gtest.h>
 
+#include <libbase/runtime_assert.h>
+
 #include <cstddef>
 #include <cstdint>
 #include <random>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -279,4 +282,115 @@ TEST(DisjointSetUnion, StressLargeAgainstRefDsu) {
 
         (void)rx2;
     }
-}
\ No newline at end of file
+}
+
+TEST(DisjointSet, MatchesDisjointSetUnion) {
+    const std::size_t N = 100000;
+    std::mt19937 rng(239);
+    std::uniform_int_distribution<std::uint32_t> dist(0, N - 1);
+
+    DisjointSetUnion ref(N);
+    DisjointSet<std::uint32_t> dsu32(N);
+    DisjointSet<std::uint64_t> dsu64(N);
+    EXPECT_EQ(dsu32.size(), N);
+    for (int op = 0; op < 200000; ++op) {
+        const std::uint32_t a = dist(rng);
+        const std::uint32_t b = dist(rng);
+        const bool merged = ref.unite(a, b);
+        ASSERT_EQ(dsu32.unite(a, b), merged);
+        ASSERT_EQ(dsu64.unite(a, b), merged);
+    }
+    for (int i = 0; i < 5000; ++i) {
+        const std::uint32_t x = dist(rng);
+        const std::uint32_t y = dist(rng);
+        const bool same = ref.find(x) == ref.find(y);
+        ASSERT_EQ(dsu32.same(x, y), same);
+        ASSERT_EQ(dsu64.same(x, y), same);
+        ASSERT_EQ(dsu32.set_size(x), ref.set_size(x));
+        ASSERT_EQ(dsu64.set_size(x), ref.set_size(x));
+    }
+}
+
+TEST(DisjointSet, RootBitAndBounds) {
+    EXPECT_EQ(DisjointSet<std::uint32_t>::kRootBit, 0x80000000u);
+    DisjointSet<std::uint32_t> dsu(4);
+    EXPECT_EQ(dsu.set_size(3), 1u);
+    EXPECT_TRUE(dsu.unite(0, 3));
+    EXPECT_FALSE(dsu.unite(3, 0));
+    EXPECT_EQ(dsu.set_size(0), 2u);
+    EXPECT_THROW(dsu.find(4), assertion_error);
+}
+
+TEST(ConcurrentDisjointSet, SequentialMatchesDisjointSetUnion) {
+    const std::size_t N = 10000;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::uint32_t> dist(0, N - 1);
+    DisjointSetUnion ref(N);
+    ConcurrentDisjointSet<std::uint32_t> dsu(N);
+    for (int op = 0; op < 20000; ++op) {
+        const std::uint32_t a = dist(rng);
+        const std::uint32_t b = dist(rng);
+        ASSERT_EQ(dsu.unite(a, b), ref.unite(a, b));
+        const std::uint32_t c = dist(rng);
+        ASSERT_EQ(dsu.same(a, c), ref.find(a) == ref.find(c));
+    }
+    EXPECT_THROW(dsu.find(N), assertion_error);
+}
+
+TEST(ConcurrentDisjointSet, StressManyThreads) {
+    // threads unite random pairs of shared edges concurrently (and query meanwhile),
+    // the final partition must be the same as after sequential unites of all edges
+    const std::size_t N = 200000;
+    const int threadsCount = 8;
+    const int edgesPerThread = 100000;
+
+    std::vector<std::vector<std::pair<std::uint32_t, std::uint32_t>>> edges(threadsCount);
+    std::mt19937 rng(239);
+    std::uniform_int_distribution<std::uint32_t> dist(0, N - 1);
+    for (auto &threadEdges : edges)
+        for (int i = 0; i < edgesPerThread; ++i)
+            threadEdges.emplace_back(dist(rng), dist(rng));
+
+    for (int round = 0; round < 3; ++round) {
+        ConcurrentDisjointSet<std::uint32_t> dsu(N);
+        std::vector<int> merges(threadsCount, 0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadsCount; ++t) {
+            threads.emplace_back([&, t]() {
+                for (const auto &[a, b] : edges[t]) {
+                    merges[t] += dsu.unite(a, b);
+                    // after unite both ends are in one set forever
+                    if (!dsu.same(a, b))
+                        merges[t] = -1000000000;
+                }
+            });
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+
+        DisjointSetUnion ref(N);
+        int refMerges = 0;
+        for (const auto &threadEdges : edges)
+            for (const auto &[a, b] : threadEdges)
+                refMerges += ref.unite(a, b);
+
+        // every successful merge is counted exactly once
+        int totalMerges = 0;
+        for (int m : merges)
+            totalMerges += m;
+        ASSERT_EQ(totalMerges, refMerges);
+
+        // the same partition: roots map one to one
+        std::unordered_map<std::size_t, std::uint32_t> rootOf;
+        std::unordered_map<std::uint32_t, std::size_t> refRootOf;
+        for (std::uint32_t x = 0; x < N; ++x) {
+            const std::size_t r = ref.find(x);
+            const std::uint32_t c = dsu.find(x);
+            auto [it, inserted] = rootOf.try_emplace(r, c);
+            ASSERT_EQ(it->second, c);
+            auto [it2, inserted2] = refRootOf.try_emplace(c, r);
+            ASSERT_EQ(it2->second, r);
+        }
+    }
+}
+
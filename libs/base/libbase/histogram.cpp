@@ -0,0 +1,94 @@
+#include "histogram.h"
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace stats {
+
+Histogram::Histogram(int lo, int hi) : lo_(lo), hi_(hi) {
+    if (lo > hi)
+        throw std::invalid_argument("Histogram: lo > hi");
+    counts_.assign(static_cast<std::size_t>(hi - lo) + 1, 0);
+}
+
+void Histogram::throwOutOfRange(int value) const {
+    throw std::invalid_argument("Histogram: value " + std::to_string(value) + " out of range [" + std::to_string(lo_) +
+                                ", " + std::to_string(hi_) + "]");
+}
+
+void Histogram::merge(const Histogram &other) {
+    if (other.lo_ != lo_ || other.hi_ != hi_)
+        throw std::invalid_argument("Histogram::merge: different ranges");
+    for (std::size_t i = 0; i < counts_.size(); ++i)
+        counts_[i] += other.counts_[i];
+    total_ += other.total_;
+}
+
+std::uint64_t Histogram::count(int value) const {
+    if (value < lo_ || value > hi_)
+        return 0;
+    return counts_[value - lo_];
+}
+
+int Histogram::minValue() const {
+    if (total_ == 0)
+        throw std::invalid_argument("minValue: empty input");
+    return valueAtRank(0);
+}
+
+int Histogram::maxValue() const {
+    if (total_ == 0)
+        throw std::invalid_argument("maxValue: empty input");
+    return valueAtRank(total_ - 1);
+}
+
+int Histogram::valueAtRank(std::uint64_t k) const {
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen > k)
+            return lo_ + static_cast<int>(i);
+    }
+    return hi_;
+}
+
+double Histogram::percentile(double p) const {
+    if (total_ == 0)
+        throw std::invalid_argument("percentile: empty input");
+    if (!(p >= 0.0 && p <= 100.0))
+        throw std::invalid_argument("percentile: p out of range [0,100]");
+
+    const double pos = p / 100.0 * static_cast<double>(total_ - 1);
+    const std::uint64_t i = static_cast<std::uint64_t>(std::floor(pos));
+    const std::uint64_t j = static_cast<std::uint64_t>(std::ceil(pos));
+    const double a = valueAtRank(i);
+    if (j == i)
+        return a;
+    const double b = valueAtRank(j);
+    return a + (pos - static_cast<double>(i)) * (b - a);
+}
+
+double Histogram::mean() const {
+    if (total_ == 0)
+        throw std::invalid_argument("mean: empty input");
+    double sum = 0.0;
+    for (std::size_t i = 0; i < counts_.size(); ++i)
+        sum += static_cast<double>(counts_[i]) * (lo_ + static_cast<int>(i));
+    return sum / static_cast<double>(total_);
+}
+
+std::string summaryStats(const Histogram &histogram) {
+    std::ostringstream out;
+    out << histogram.count() << " values - ";
+    if (histogram.count() == 0) {
+        out << "(empty)";
+        return out.str();
+    }
+    out << "(min=" << histogram.minValue() << " 10%=" << histogram.percentile(10.0)
+        << " median=" << histogram.median() << " 90%=" << histogram.percentile(90.0)
+        << " max=" << histogram.maxValue() << ")";
+    return out.str();
+}
+
+} // namespace stats
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace stats {
+
+// Exact histogram of integer values in [lo, hi] with one bucket per value (e.g. uint8 intensities).
+// Percentiles are computed from cumulative counts in O(hi - lo) without copying or sorting samples
+// and match stats::percentile on the same samples exactly. Histograms with the same range can be merged,
+// so every thread can count its own part and the results are added up.
+class Histogram {
+  public:
+    explicit Histogram(int lo = 0, int hi = 255);
+
+    // Throws std::invalid_argument if value is out of [lo, hi]
+    void add(int value, std::uint64_t count = 1) {
+        if (value < lo_ || value > hi_)
+            throwOutOfRange(value);
+        counts_[value - lo_] += count;
+        total_ += count;
+    }
+
+    template <typename T> void addAll(const std::vector<T> &values) {
+        for (const T &v : values)
+            add(static_cast<int>(v));
+    }
+
+    // Throws std::invalid_argument if ranges differ
+    void merge(const Histogram &other);
+
+    int lo() const noexcept { return lo_; }
+    int hi() const noexcept { return hi_; }
+    std::uint64_t count() const noexcept { return total_; }
+    std::uint64_t count(int value) const;
+
+    // The same semantics as stats::minValue/maxValue/median/percentile, throw std::invalid_argument if empty.
+    int minValue() const;
+    int maxValue() const;
+    double median() const { return percentile(50.0); }
+    double percentile(double p) const;
+    double mean() const;
+
+  private:
+    [[noreturn]] void throwOutOfRange(int value) const;
+    // value of the k-th smallest sample (0-based)
+    int valueAtRank(std::uint64_t k) const;
+
+    int lo_;
+    int hi_;
+    std::uint64_t total_ = 0;
+    std::vector<std::uint64_t> counts_;
+};
+
+// "N values - (min=... 10%=... median=... 90%=... max=...)" like summaryStats for integer vectors
+std::string summaryStats(const Histogram &histogram);
+
+} // namespace stats
@@ -0,0 +1,68 @@
+#include "histogram.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/fast_random.h>
+#include <libbase/stats.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+TEST(Histogram, PercentileMatchesStats) {
+    FastRandom r(239);
+    for (int n : {1, 2, 5, 100, 1001}) {
+        std::vector<std::uint8_t> values;
+        stats::Histogram histogram;
+        for (int i = 0; i < n; ++i) {
+            values.push_back(static_cast<std::uint8_t>(r.nextInt(0, 255)));
+            histogram.add(values.back());
+        }
+        EXPECT_EQ(histogram.count(), static_cast<std::uint64_t>(n));
+        EXPECT_EQ(histogram.minValue(), stats::minValue(values));
+        EXPECT_EQ(histogram.maxValue(), stats::maxValue(values));
+        for (double p : {0.0, 10.0, 33.3, 50.0, 90.0, 100.0})
+            EXPECT_DOUBLE_EQ(histogram.percentile(p), stats::percentile(values, p)) << n << " " << p;
+        EXPECT_EQ(stats::summaryStats(histogram), stats::summaryStats(values));
+    }
+}
+
+TEST(Histogram, CustomRangeAndMean) {
+    stats::Histogram histogram(-10, 10);
+    histogram.addAll(std::vector<int>{-10, -5, 0, 0, 10});
+    EXPECT_EQ(histogram.count(0), 2u);
+    EXPECT_EQ(histogram.count(100), 0u);
+    EXPECT_DOUBLE_EQ(histogram.median(), 0.0);
+    EXPECT_DOUBLE_EQ(histogram.mean(), -1.0);
+    EXPECT_DOUBLE_EQ(histogram.percentile(25), -5.0);
+    EXPECT_THROW(histogram.add(11), std::invalid_argument);
+    EXPECT_THROW(histogram.add(-11), std::invalid_argument);
+}
+
+TEST(Histogram, MergeEqualsSingleHistogram) {
+    FastRandom r(7);
+    stats::Histogram all;
+    std::vector<stats::Histogram> parts(4);
+    for (int i = 0; i < 10000; ++i) {
+        const int v = r.nextInt(0, 255);
+        all.add(v);
+        parts[i % 4].add(v);
+    }
+    stats::Histogram merged;
+    for (const stats::Histogram &part : parts)
+        merged.merge(part);
+    EXPECT_EQ(merged.count(), all.count());
+    for (int v = 0; v < 256; ++v)
+        EXPECT_EQ(merged.count(v), all.count(v));
+
+    EXPECT_THROW(merged.merge(stats::Histogram(0, 100)), std::invalid_argument);
+}
+
+TEST(Histogram, EmptyThrows) {
+    stats::Histogram histogram;
+    EXPECT_THROW(histogram.percentile(50), std::invalid_argument);
+    EXPECT_THROW(histogram.minValue(), std::invalid_argument);
+    EXPECT_EQ(stats::summaryStats(histogram), "0 values - (empty)");
+    histogram.add(3);
+    EXPECT_THROW(histogram.percentile(101), std::invalid_argument);
+}
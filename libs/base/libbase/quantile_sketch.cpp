@@ -0,0 +1,182 @@
+#include "quantile_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace stats {
+
+namespace {
+
+constexpr double kCapacityDecay = 2.0 / 3.0;
+
+inline std::uint32_t xorshift32(std::uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+} // namespace
+
+QuantileSketch::QuantileSketch(int k, std::uint32_t seed) : k_(k), random_state_(seed == 0 ? 239 : seed) {
+    if (k < 8)
+        throw std::invalid_argument("QuantileSketch: k must be >= 8");
+    levels_.resize(1);
+    updateCapacities();
+}
+
+void QuantileSketch::updateCapacities() {
+    capacities_.resize(levels_.size());
+    total_capacity_ = 0;
+    for (std::size_t h = 0; h < levels_.size(); ++h) {
+        const std::size_t depth = levels_.size() - 1 - h;
+        const double c = std::ceil(k_ * std::pow(kCapacityDecay, static_cast<double>(depth)));
+        capacities_[h] = std::max<std::size_t>(2, static_cast<std::size_t>(c));
+        total_capacity_ += capacities_[h];
+    }
+}
+
+void QuantileSketch::add(double value) {
+    if (n_ == 0) {
+        min_ = max_ = value;
+    } else {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+    ++n_;
+    ++retained_;
+    levels_[0].push_back(value);
+    if (retained_ >= total_capacity_)
+        compress();
+}
+
+void QuantileSketch::merge(const QuantileSketch &other) {
+    if (other.k_ != k_)
+        throw std::invalid_argument("QuantileSketch::merge: different k");
+    if (other.n_ == 0)
+        return;
+    if (n_ == 0) {
+        min_ = other.min_;
+        max_ = other.max_;
+    } else {
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+    n_ += other.n_;
+    retained_ += other.retained_;
+    if (levels_.size() < other.levels_.size()) {
+        levels_.resize(other.levels_.size());
+        updateCapacities();
+    }
+    for (std::size_t h = 0; h < other.levels_.size(); ++h)
+        levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+    while (retained_ >= total_capacity_)
+        compress();
+}
+
+void QuantileSketch::compress() {
+    // lazy compression: only the lowest full level is compacted, so level 0 accumulates big batches while
+    // upper levels have spare room, and sorting costs O(log k) per added value on average
+    for (std::size_t h = 0; h < levels_.size(); ++h) {
+        if (levels_[h].size() >= capacities_[h]) {
+            compact(h);
+            return;
+        }
+    }
+}
+
+void QuantileSketch::compact(std::size_t h) {
+    if (h + 1 == levels_.size()) {
+        levels_.emplace_back();
+        updateCapacities();
+    }
+    std::vector<double> &items = levels_[h];
+    std::sort(items.begin(), items.end());
+
+    // odd item out stays on this level, so the total weight stays equal to count()
+    double leftover = 0.0;
+    const bool odd = items.size() % 2 == 1;
+    if (odd) {
+        leftover = items.back();
+        items.pop_back();
+    }
+    std::vector<double> &next = levels_[h + 1];
+    const std::size_t phase = xorshift32(random_state_) & 1u;
+    for (std::size_t i = phase; i < items.size(); i += 2)
+        next.push_back(items[i]);
+    retained_ -= items.size() / 2;
+    items.clear();
+    if (odd)
+        items.push_back(leftover);
+}
+
+double QuantileSketch::minValue() const {
+    if (n_ == 0)
+        throw std::invalid_argument("minValue: empty input");
+    return min_;
+}
+
+double QuantileSketch::maxValue() const {
+    if (n_ == 0)
+        throw std::invalid_argument("maxValue: empty input");
+    return max_;
+}
+
+double QuantileSketch::percentile(double p) const {
+    if (n_ == 0)
+        throw std::invalid_argument("percentile: empty input");
+    if (!(p >= 0.0 && p <= 100.0))
+        throw std::invalid_argument("percentile: p out of range [0,100]");
+    if (p <= 0.0)
+        return min_;
+    if (p >= 100.0)
+        return max_;
+
+    if (isExact()) {
+        // linear interpolation on sorted data, like stats::percentile
+        std::vector<double> v = levels_[0];
+        const double pos = p / 100.0 * static_cast<double>(n_ - 1);
+        const std::size_t i = static_cast<std::size_t>(std::floor(pos));
+        std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(i), v.end());
+        const double a = v[i];
+        if (pos == static_cast<double>(i))
+            return a;
+        const double b = *std::min_element(v.begin() + static_cast<std::ptrdiff_t>(i) + 1, v.end());
+        return a + (pos - static_cast<double>(i)) * (b - a);
+    }
+
+    std::vector<std::pair<double, std::uint64_t>> weighted;
+    weighted.reserve(retained());
+    for (std::size_t h = 0; h < levels_.size(); ++h)
+        for (double v : levels_[h])
+            weighted.emplace_back(v, std::uint64_t(1) << h);
+    std::sort(weighted.begin(), weighted.end());
+
+    const double rank = p / 100.0 * static_cast<double>(n_ - 1);
+    std::uint64_t seen = 0;
+    for (const auto &[v, weight] : weighted) {
+        seen += weight;
+        if (static_cast<double>(seen) > rank)
+            return v;
+    }
+    return max_;
+}
+
+std::string summaryStats(const QuantileSketch &sketch, int decimals) {
+    std::ostringstream out;
+    out << sketch.count() << " values - ";
+    if (sketch.count() == 0) {
+        out << "(empty)";
+        return out.str();
+    }
+    out << std::fixed << std::setprecision(decimals);
+    out << "(min=" << sketch.minValue() << " 10%=" << sketch.percentile(10.0) << " median=" << sketch.median()
+        << " 90%=" << sketch.percentile(90.0) << " max=" << sketch.maxValue() << ")";
+    return out.str();
+}
+
+} // namespace stats
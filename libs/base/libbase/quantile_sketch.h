@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace stats {
+
+// Streaming quantile sketch for floating point values (KLL: Karnin, Lang, Liberty, "Optimal Quantile Approximation
+// in Streams", 2016). Values are kept in levels of compactors, an item of level h stands for 2^h samples; when a level
+// is full it is sorted and every second item (random phase) is promoted to the next level. Capacities shrink
+// geometrically (2/3) for lower levels, so the sketch keeps O(k) items for any number of samples.
+//
+// Rank error of percentile() is ~1.7 / k of count() with high probability (k = 200 -> ~1%), min/max are exact.
+// Until the first compaction (about k samples) all samples are kept and percentile() is exact (equals stats::percentile).
+// Sketches with the same k can be merged (e.g. per-thread sketches), the result has the same error guarantee.
+class QuantileSketch {
+  public:
+    explicit QuantileSketch(int k = 200, std::uint32_t seed = 239);
+
+    void add(double value);
+    template <typename T> void addAll(const std::vector<T> &values) {
+        for (const T &v : values)
+            add(static_cast<double>(v));
+    }
+
+    // Throws std::invalid_argument if k differs
+    void merge(const QuantileSketch &other);
+
+    std::uint64_t count() const noexcept { return n_; }
+    // Number of items stored (memory footprint)
+    std::size_t retained() const noexcept { return retained_; }
+    bool isExact() const noexcept { return levels_.size() == 1; }
+
+    // The same semantics as stats::minValue/maxValue/median/percentile, throw std::invalid_argument if empty.
+    double minValue() const;
+    double maxValue() const;
+    double median() const { return percentile(50.0); }
+    double percentile(double p) const;
+
+  private:
+    void updateCapacities();
+    void compress();
+    void compact(std::size_t level);
+
+    int k_;
+    std::uint32_t random_state_;
+    std::uint64_t n_ = 0;
+    double min_ = 0.0;
+    double max_ = 0.0;
+    std::size_t retained_ = 0;
+    std::size_t total_capacity_ = 0;
+    std::vector<std::size_t> capacities_; // per level, shrink by 2/3 from the top level down
+    std::vector<std::vector<double>> levels_;
+};
+
+// "N values - (min=... 10%=... median=... 90%=... max=...)" like summaryStats for float vectors
+std::string summaryStats(const QuantileSketch &sketch, int decimals = 2);
+
+} // namespace stats
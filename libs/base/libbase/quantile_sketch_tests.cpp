@@ -0,0 +1,92 @@
+#include "quantile_sketch.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/fast_random.h>
+#include <libbase/stats.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// fraction of values that are < v
+double rankOf(const std::vector<double> &sorted, double v) {
+    return static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), v) - sorted.begin()) / sorted.size();
+}
+
+} // namespace
+
+TEST(QuantileSketch, ExactForSmallInputs) {
+    FastRandom r(239);
+    std::vector<float> values;
+    stats::QuantileSketch sketch;
+    for (int i = 0; i < 150; ++i) {
+        values.push_back(r.nextFloat(-5.0f, 5.0f));
+        sketch.add(values.back());
+    }
+    ASSERT_TRUE(sketch.isExact());
+    for (double p : {0.0, 10.0, 33.3, 50.0, 90.0, 100.0})
+        EXPECT_DOUBLE_EQ(sketch.percentile(p), stats::percentile(values, p));
+    EXPECT_EQ(stats::summaryStats(sketch), stats::summaryStats(values));
+}
+
+TEST(QuantileSketch, RankErrorOnLargeStreams) {
+    const int n = 1000000;
+    FastRandom r(239);
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i)
+        values[i] = r.nextFloat() * r.nextFloat(); // skewed distribution
+
+    // random order, sorted and reversed streams
+    std::vector<std::vector<double>> streams = {values, values, values};
+    std::sort(streams[1].begin(), streams[1].end());
+    std::sort(streams[2].rbegin(), streams[2].rend());
+    const std::vector<double> &sorted = streams[1];
+
+    for (const std::vector<double> &stream : streams) {
+        stats::QuantileSketch sketch;
+        sketch.addAll(stream);
+        EXPECT_EQ(sketch.count(), static_cast<std::uint64_t>(n));
+        EXPECT_LT(sketch.retained(), 1000u);
+        EXPECT_EQ(sketch.minValue(), sorted.front());
+        EXPECT_EQ(sketch.maxValue(), sorted.back());
+        for (double p : {1.0, 10.0, 25.0, 50.0, 75.0, 90.0, 99.0})
+            EXPECT_NEAR(rankOf(sorted, sketch.percentile(p)), p / 100.0, 0.02) << p;
+    }
+}
+
+TEST(QuantileSketch, MergedPerThreadSketches) {
+    const int n = 400000;
+    FastRandom r(17);
+    std::vector<double> values(n);
+    std::vector<stats::QuantileSketch> parts;
+    for (int t = 0; t < 8; ++t)
+        parts.emplace_back(200, 100 + t);
+    for (int i = 0; i < n; ++i) {
+        values[i] = r.nextFloat(0.0f, 1000.0f);
+        parts[i % 8].add(values[i]);
+    }
+    std::sort(values.begin(), values.end());
+
+    stats::QuantileSketch merged;
+    for (const stats::QuantileSketch &part : parts)
+        merged.merge(part);
+    EXPECT_EQ(merged.count(), static_cast<std::uint64_t>(n));
+    EXPECT_LT(merged.retained(), 1000u);
+    for (double p : {1.0, 10.0, 50.0, 90.0, 99.0})
+        EXPECT_NEAR(rankOf(values, merged.percentile(p)), p / 100.0, 0.02) << p;
+
+    EXPECT_THROW(merged.merge(stats::QuantileSketch(100)), std::invalid_argument);
+}
+
+TEST(QuantileSketch, EmptyThrows) {
+    stats::QuantileSketch sketch;
+    EXPECT_THROW(sketch.percentile(50), std::invalid_argument);
+    EXPECT_THROW(sketch.minValue(), std::invalid_argument);
+    sketch.add(1.0);
+    EXPECT_DOUBLE_EQ(sketch.median(), 1.0);
+    EXPECT_THROW(sketch.percentile(-1), std::invalid_argument);
+}
@@ -0,0 +1,75 @@
+#include "simd_level.h"
+
+#include <libbase/runtime_assert.h>
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define LIBBASE_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+
+SimdLevel detectSimdLevel() {
+#if defined(LIBBASE_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return SimdLevel::SSE4;
+    return SimdLevel::Scalar;
+#elif defined(LIBBASE_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] >> 19) & 1;
+    const bool fma = (info[2] >> 12) & 1;
+    const bool osxsave = (info[2] >> 27) & 1;
+    bool avx2 = false;
+    if (max_leaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] >> 5) & 1;
+    }
+    if (avx2 && fma)
+        return SimdLevel::AVX2;
+    return sse41 ? SimdLevel::SSE4 : SimdLevel::Scalar;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+std::atomic<int> current_level{-1};
+
+} // namespace
+
+SimdLevel supportedSimdLevel() {
+    static const SimdLevel supported = detectSimdLevel();
+    return supported;
+}
+
+SimdLevel currentSimdLevel() {
+    const int level = current_level.load(std::memory_order_relaxed);
+    return level < 0 ? supportedSimdLevel() : static_cast<SimdLevel>(level);
+}
+
+void setSimdLevel(SimdLevel level) {
+    rassert(static_cast<int>(level) <= static_cast<int>(supportedSimdLevel()), 4512390871, toString(level),
+            toString(supportedSimdLevel()));
+    current_level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+const char *toString(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar:
+        return "scalar";
+    case SimdLevel::SSE4:
+        return "SSE4";
+    case SimdLevel::AVX2:
+        return "AVX2";
+    }
+    return "unknown";
+}
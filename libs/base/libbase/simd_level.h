@@ -0,0 +1,15 @@
+#pragma once
+
+// Instruction sets that hand-written SIMD kernels are specialized for (in increasing order).
+// Kernels are dispatched at runtime, so the same binary runs on any x86-64 CPU (and on other CPUs via Scalar).
+enum class SimdLevel { Scalar = 0, SSE4 = 1, AVX2 = 2 };
+
+// Best level supported by the CPU (AVX2 also requires FMA)
+SimdLevel supportedSimdLevel();
+
+// Level that kernels should use: supportedSimdLevel() by default,
+// can be lowered f.e. to compare implementations in tests or benchmarks.
+SimdLevel currentSimdLevel();
+void setSimdLevel(SimdLevel level);
+
+const char *toString(SimdLevel level);
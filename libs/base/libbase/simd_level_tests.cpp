@@ -0,0 +1,23 @@
+#include "simd_level.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/runtime_assert.h>
+
+#include <iostream>
+
+TEST(simd_level, canBeLoweredAndRestored) {
+    const SimdLevel supported = supportedSimdLevel();
+    std::cout << "supported SIMD level: " << toString(supported) << std::endl;
+    EXPECT_EQ(currentSimdLevel(), supported);
+
+    setSimdLevel(SimdLevel::Scalar);
+    EXPECT_EQ(currentSimdLevel(), SimdLevel::Scalar);
+
+    setSimdLevel(supported);
+    EXPECT_EQ(currentSimdLevel(), supported);
+
+    if (supported != SimdLevel::AVX2) {
+        EXPECT_THROW(setSimdLevel(SimdLevel::AVX2), assertion_error);
+    }
+}
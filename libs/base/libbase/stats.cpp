@@ -127,8 +127,8 @@ template <AllowedType T> double percentile(const std::vector<T> &values, double
     if (j == i)
         return a;
 
-    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(j), v.end());
-    const double b = v[j];
+    // after nth_element everything right of i is >= v[i], the next order statistic is their minimum
+    const double b = *std::min_element(v.begin() + static_cast<std::ptrdiff_t>(j), v.end());
 
     const double t = pos - static_cast<double>(i);
     return a + t * (b - a);
@@ -1,6 +1,9 @@
 #include "blur.h"
 
 #include <libbase/runtime_assert.h>
+#include <libimages/image_view.h>
+
+#include "blur_kernels.h"
 
 #include <algorithm>
 #include <cmath>
@@ -66,177 +69,241 @@ inline T from_f(float v) noexcept {
     }
 }
 
-// --------------------- Image blur: 1 channel ---------------------
+// --------------------- Image blur: 1 or 3 channels ---------------------
 
+// Horizontal pass converts each input row into padded float rows (one per channel - channels are deinterleaved)
+// and writes them into a planar intermediate image, vertical pass combines rows of a plane and converts
+// the result back into interleaved output pixels. Inner loops are SIMD row kernels (see blur_kernels.h).
 template <typename T>
-Image<T> blur_gray(const Image<T>& image, const Kernel1D& k) {
+Image<T> blur_planar(ImageView<const T> image, const Kernel1D& k) {
     const int W = image.width();
     const int H = image.height();
+    const int C = image.channels();
     const int R = k.r;
+    const int taps = 2 * R + 1;
     const float* kw = k.w.data();
-
-    std::vector<float> tmp(static_cast<size_t>(W) * static_cast<size_t>(H), 0.0f);
-
-    #pragma omp parallel for
-    for (int y = 0; y < H; ++y) {
-        const size_t row = static_cast<size_t>(y) * static_cast<size_t>(W);
-
-        const int leftEnd = std::min(R, W);
-        for (int x = 0; x < leftEnd; ++x) {
-            float acc = 0.0f;
-            for (int dx = -R; dx <= R; ++dx) {
-                const int sx = clampi(x + dx, 0, W - 1);
-                acc += kw[dx + R] * to_f(image(y, sx));
-            }
-            tmp[row + static_cast<size_t>(x)] = acc;
-        }
-
-        const int midBegin = R;
-        const int midEnd = W - R;
-        if (midBegin < midEnd) {
-            for (int x = midBegin; x < midEnd; ++x) {
-                float acc = 0.0f;
-                for (int dx = -R; dx <= R; ++dx) {
-                    acc += kw[dx + R] * to_f(image(y, x + dx));
+    const blur_kernels::Kernels& kernels = blur_kernels::currentKernels();
+
+    // plane c occupies rows [c * H, (c + 1) * H)
+    image32f tmp(W, H * C, 1, ImageInit::Uninitialized);
+
+    #pragma omp parallel
+    {
+        std::vector<float> padded(static_cast<size_t>(W + 2 * R));
+
+        #pragma omp for
+        for (int y = 0; y < H; ++y) {
+            const T* src = image.ptr(y);
+            for (int c = 0; c < C; ++c) {
+                // border pixels are replicated
+                for (int x = 0; x < W; ++x) {
+                    padded[R + x] = to_f(src[x * C + c]);
                 }
-                tmp[row + static_cast<size_t>(x)] = acc;
-            }
-        }
-
-        const int rightBegin = std::max(leftEnd, midEnd);
-        for (int x = rightBegin; x < W; ++x) {
-            float acc = 0.0f;
-            for (int dx = -R; dx <= R; ++dx) {
-                const int sx = clampi(x + dx, 0, W - 1);
-                acc += kw[dx + R] * to_f(image(y, sx));
+                std::fill(padded.begin(), padded.begin() + R, padded[R]);
+                std::fill(padded.begin() + R + W, padded.end(), padded[R + W - 1]);
+                kernels.convolve_row(padded.data(), kw, taps, tmp.ptr(c * H + y), W);
             }
-            tmp[row + static_cast<size_t>(x)] = acc;
         }
     }
 
-    Image<T> out(W, H, 1);
+    Image<T> out(W, H, C, ImageInit::Uninitialized);
 
-    #pragma omp parallel for
-    for (int y = 0; y < H; ++y) {
-        const bool midY = (y >= R && y < H - R);
+    #pragma omp parallel
+    {
+        std::vector<const float*> rows(static_cast<size_t>(taps));
+        std::vector<float> acc(static_cast<size_t>(W) * C);
+        std::vector<std::uint8_t> planes8u(std::is_same_v<T, std::uint8_t> ? static_cast<size_t>(W) * C : 0);
 
-        for (int x = 0; x < W; ++x) {
-            float acc = 0.0f;
+        #pragma omp for
+        for (int y = 0; y < H; ++y) {
+            for (int c = 0; c < C; ++c) {
+                for (int d = 0; d < taps; ++d) {
+                    rows[d] = tmp.ptr(c * H + clampi(y + d - R, 0, H - 1));
+                }
+                kernels.convolve_rows(rows.data(), kw, taps, acc.data() + static_cast<size_t>(c) * W, W);
+            }
 
-            if (midY) {
-                for (int dy = -R; dy <= R; ++dy) {
-                    const int sy = y + dy;
-                    acc += kw[dy + R] * tmp[static_cast<size_t>(sy) * static_cast<size_t>(W) + static_cast<size_t>(x)];
+            T* dst = out.ptr(y);
+            if constexpr (std::is_same_v<T, std::uint8_t>) {
+                if (C == 1) {
+                    kernels.store_u8(acc.data(), dst, W);
+                    continue;
+                }
+                for (int c = 0; c < C; ++c) {
+                    kernels.store_u8(acc.data() + static_cast<size_t>(c) * W, planes8u.data() + static_cast<size_t>(c) * W, W);
+                }
+                for (int x = 0; x < W; ++x) {
+                    for (int c = 0; c < C; ++c) {
+                        dst[x * C + c] = planes8u[static_cast<size_t>(c) * W + x];
+                    }
                 }
             } else {
-                for (int dy = -R; dy <= R; ++dy) {
-                    const int sy = clampi(y + dy, 0, H - 1);
-                    acc += kw[dy + R] * tmp[static_cast<size_t>(sy) * static_cast<size_t>(W) + static_cast<size_t>(x)];
+                for (int x = 0; x < W; ++x) {
+                    for (int c = 0; c < C; ++c) {
+                        dst[x * C + c] = from_f<T>(acc[static_cast<size_t>(c) * W + x]);
+                    }
                 }
             }
-
-            out(y, x) = from_f<T>(acc);
         }
     }
 
     return out;
 }
 
-// --------------------- Image blur: 3 channels ---------------------
-
-template <typename T>
-Image<T> blur_rgb(const Image<T>& image, const Kernel1D& k) {
-    const int W = image.width();
-    const int H = image.height();
-    const int R = k.r;
-    const float* kw = k.w.data();
+// --------------------- Image blur: cascade of box blurs ---------------------
 
-    std::vector<float> tmp(static_cast<size_t>(W) * static_cast<size_t>(H) * 3u, 0.0f);
+// Widths of n successive box blurs whose combined variance equals sigma^2 (W. Kovesi, "Fast almost-Gaussian filtering"):
+// m boxes of width wl and n - m boxes of width wl + 2 (all widths odd)
+inline std::vector<int> boxRadiiForGaussian(float sigma, int n) {
+    const double s2 = static_cast<double>(sigma) * sigma;
+    int wl = static_cast<int>(std::floor(std::sqrt(12.0 * s2 / n + 1.0)));
+    if (wl % 2 == 0) --wl;
+    const int wu = wl + 2;
+    const double mIdeal = (12.0 * s2 - n * wl * wl - 4.0 * n * wl - 3.0 * n) / (-4.0 * wl - 4.0);
+    const int m = static_cast<int>(std::lround(mIdeal));
 
-    auto idx3 = [&](int x, int y) -> size_t {
-        return (static_cast<size_t>(y) * static_cast<size_t>(W) + static_cast<size_t>(x)) * 3u;
-    };
+    std::vector<int> radii;
+    for (int i = 0; i < n; ++i) {
+        radii.push_back(((i < m) ? wl : wu) / 2);
+    }
+    return radii;
+}
 
-    #pragma omp parallel for
-    for (int y = 0; y < H; ++y) {
-        const int leftEnd = std::min(R, W);
-        for (int x = 0; x < leftEnd; ++x) {
-            float a0 = 0, a1 = 0, a2 = 0;
-            for (int dx = -R; dx <= R; ++dx) {
-                const int sx = clampi(x + dx, 0, W - 1);
-                const float w = kw[dx + R];
-                a0 += w * to_f(image(y, sx, 0));
-                a1 += w * to_f(image(y, sx, 1));
-                a2 += w * to_f(image(y, sx, 2));
-            }
-            const size_t o = idx3(x, y);
-            tmp[o + 0] = a0; tmp[o + 1] = a1; tmp[o + 2] = a2;
+// Box blur of kLines lines at once with replicated borders via running sums: O(1) per element for any radius.
+// Lines are interleaved (element x of line g is src[x * kLines + g]), so the running sums are independent
+// and the inner loops over g vectorize.
+constexpr int kLines = 8;
+
+inline void boxBlurLines(const float* src, float* dst, int n, int r) {
+    const float inv = 1.0f / static_cast<float>(2 * r + 1);
+    float sum[kLines] = {};
+    for (int k = -r; k <= r; ++k) {
+        const float* p = src + static_cast<size_t>(clampi(k, 0, n - 1)) * kLines;
+        for (int g = 0; g < kLines; ++g) sum[g] += p[g];
+    }
+    for (int x = 0; x < n; ++x) {
+        const float* add = src + static_cast<size_t>(std::min(x + r + 1, n - 1)) * kLines;
+        const float* sub = src + static_cast<size_t>(std::max(x - r, 0)) * kLines;
+        float* out = dst + static_cast<size_t>(x) * kLines;
+        for (int g = 0; g < kLines; ++g) {
+            out[g] = sum[g] * inv;
+            sum[g] += add[g] - sub[g];
         }
+    }
+}
 
-        const int midBegin = R;
-        const int midEnd = W - R;
-        if (midBegin < midEnd) {
-            for (int x = midBegin; x < midEnd; ++x) {
-                float a0 = 0, a1 = 0, a2 = 0;
-                for (int dx = -R; dx <= R; ++dx) {
-                    const int sx = x + dx;
-                    const float w = kw[dx + R];
-                    a0 += w * to_f(image(y, sx, 0));
-                    a1 += w * to_f(image(y, sx, 1));
-                    a2 += w * to_f(image(y, sx, 2));
-                }
-                const size_t o = idx3(x, y);
-                tmp[o + 0] = a0; tmp[o + 1] = a1; tmp[o + 2] = a2;
-            }
-        }
+// Box blur of columns of a strip (n rows of kStrip floats, row y is strip[y * kStrip]) via running sums of whole
+// strip rows, replicated borders.
+constexpr int kStrip = 64;
 
-        const int rightBegin = std::max(leftEnd, midEnd);
-        for (int x = rightBegin; x < W; ++x) {
-            float a0 = 0, a1 = 0, a2 = 0;
-            for (int dx = -R; dx <= R; ++dx) {
-                const int sx = clampi(x + dx, 0, W - 1);
-                const float w = kw[dx + R];
-                a0 += w * to_f(image(y, sx, 0));
-                a1 += w * to_f(image(y, sx, 1));
-                a2 += w * to_f(image(y, sx, 2));
-            }
-            const size_t o = idx3(x, y);
-            tmp[o + 0] = a0; tmp[o + 1] = a1; tmp[o + 2] = a2;
+inline void boxBlurStrip(const float* src, float* dst, int n, int r) {
+    const float inv = 1.0f / static_cast<float>(2 * r + 1);
+    float sum[kStrip] = {};
+    for (int k = -r; k <= r; ++k) {
+        const float* row = src + static_cast<size_t>(clampi(k, 0, n - 1)) * kStrip;
+        for (int i = 0; i < kStrip; ++i) sum[i] += row[i];
+    }
+    for (int y = 0; y < n; ++y) {
+        const float* add = src + static_cast<size_t>(std::min(y + r + 1, n - 1)) * kStrip;
+        const float* sub = src + static_cast<size_t>(std::max(y - r, 0)) * kStrip;
+        float* out = dst + static_cast<size_t>(y) * kStrip;
+        for (int i = 0; i < kStrip; ++i) {
+            out[i] = sum[i] * inv;
+            sum[i] += add[i] - sub[i];
         }
     }
+}
 
-    Image<T> out(W, H, 3);
-
-    #pragma omp parallel for
-    for (int y = 0; y < H; ++y) {
-        const bool midY = (y >= R && y < H - R);
-
-        for (int x = 0; x < W; ++x) {
-            float a0 = 0, a1 = 0, a2 = 0;
+// Approximation of gaussian blur by kBoxPasses successive box blurs (in each direction),
+// cost per pixel doesn't depend on sigma. Planar float intermediate like in blur_planar.
+// Replicating borders of every pass would differ from replicating borders of the source,
+// so lines are extended by P = sum of box radii on each side and passes only clamp at the extended ends
+// (those effects reach at most P pixels inwards, so they never get into the image).
+constexpr int kBoxPasses = 3;
 
-            if (midY) {
-                for (int dy = -R; dy <= R; ++dy) {
-                    const int sy = y + dy;
-                    const float w = kw[dy + R];
-                    const size_t o = idx3(x, sy);
-                    a0 += w * tmp[o + 0];
-                    a1 += w * tmp[o + 1];
-                    a2 += w * tmp[o + 2];
+template <typename T>
+Image<T> blur_box_cascade(ImageView<const T> image, float sigma) {
+    const int W = image.width();
+    const int H = image.height();
+    const int C = image.channels();
+    const std::vector<int> radii = boxRadiiForGaussian(sigma, kBoxPasses);
+    const blur_kernels::Kernels& kernels = blur_kernels::currentKernels();
+
+    int P = 0;
+    for (int r : radii) P += r;
+    const int PW = W + 2 * P;
+    const int PH = H + 2 * P;
+
+    // plane c occupies rows [c * H, (c + 1) * H)
+    image32f planes(W, H * C, 1, ImageInit::Uninitialized);
+
+    const int groups = (H + kLines - 1) / kLines;
+
+    #pragma omp parallel
+    {
+        std::vector<float> lines(static_cast<size_t>(PW) * kLines);
+        std::vector<float> blurred(static_cast<size_t>(PW) * kLines);
+
+        #pragma omp for
+        for (int t = 0; t < groups * C; ++t) {
+            const int c = t / groups;
+            const int y0 = (t % groups) * kLines;
+            for (int g = 0; g < kLines; ++g) {
+                // rows after the last one are just repeated (their results are dropped)
+                const T* src = image.ptr(std::min(y0 + g, H - 1));
+                for (int x = 0; x < PW; ++x) {
+                    lines[static_cast<size_t>(x) * kLines + g] = to_f(src[clampi(x - P, 0, W - 1) * C + c]);
                 }
-            } else {
-                for (int dy = -R; dy <= R; ++dy) {
-                    const int sy = clampi(y + dy, 0, H - 1);
-                    const float w = kw[dy + R];
-                    const size_t o = idx3(x, sy);
-                    a0 += w * tmp[o + 0];
-                    a1 += w * tmp[o + 1];
-                    a2 += w * tmp[o + 2];
+            }
+            for (int r : radii) {
+                boxBlurLines(lines.data(), blurred.data(), PW, r);
+                std::swap(lines, blurred);
+            }
+            for (int g = 0; g < kLines && y0 + g < H; ++g) {
+                float* dst = planes.ptr(c * H + y0 + g);
+                for (int x = 0; x < W; ++x) {
+                    dst[x] = lines[static_cast<size_t>(x + P) * kLines + g];
                 }
             }
+        }
+    }
 
-            out(y, x, 0) = from_f<T>(a0);
-            out(y, x, 1) = from_f<T>(a1);
-            out(y, x, 2) = from_f<T>(a2);
+    // Vertical passes: every strip of kStrip columns is blurred by all passes while it is in cache,
+    // then converted straight into the output.
+    Image<T> out(W, H, C, ImageInit::Uninitialized);
+    const int strips = (W + kStrip - 1) / kStrip;
+
+    #pragma omp parallel
+    {
+        std::vector<float> strip(static_cast<size_t>(PH) * kStrip);
+        std::vector<float> blurred(static_cast<size_t>(PH) * kStrip);
+        std::uint8_t strip8u[kStrip];
+
+        #pragma omp for
+        for (int t = 0; t < strips * C; ++t) {
+            const int c = t / strips;
+            const int x0 = (t % strips) * kStrip;
+            const int n = std::min(kStrip, W - x0);
+            for (int y = 0; y < PH; ++y) {
+                const float* src = planes.ptr(c * H + clampi(y - P, 0, H - 1)) + x0;
+                float* dst = strip.data() + static_cast<size_t>(y) * kStrip;
+                std::copy(src, src + n, dst);
+                std::fill(dst + n, dst + kStrip, 0.0f);
+            }
+            for (int r : radii) {
+                boxBlurStrip(strip.data(), blurred.data(), PH, r);
+                std::swap(strip, blurred);
+            }
+            for (int y = 0; y < H; ++y) {
+                const float* src = strip.data() + static_cast<size_t>(y + P) * kStrip;
+                T* dst = out.ptr(y) + static_cast<size_t>(x0) * C + c;
+                if constexpr (std::is_same_v<T, std::uint8_t>) {
+                    kernels.store_u8(src, strip8u, n);
+                    for (int i = 0; i < n; ++i) dst[i * C] = strip8u[i];
+                } else {
+                    for (int i = 0; i < n; ++i) dst[i * C] = from_f<T>(src[i]);
+                }
+            }
         }
     }
 
@@ -246,8 +313,13 @@ Image<T> blur_rgb(const Image<T>& image, const Kernel1D& k) {
 } // namespace
 
 template <typename T>
-Image<T> blur(const Image<T> &image, float strength) {
-    if (!(strength > 0.0f)) return image;
+Image<T> blur(const Image<T> &image, float strength, BlurMethod method) {
+    return blur(ImageView<const T>(image), strength, method);
+}
+
+template <typename T>
+Image<T> blur(ImageView<const T> image, float strength, BlurMethod method) {
+    if (!(strength > 0.0f)) return image.toImage();
 
     const int W = image.width();
     const int H = image.height();
@@ -255,10 +327,17 @@ Image<T> blur(const Image<T> &image, float strength) {
     rassert(W > 0 && H > 0, 981234001);
     rassert(C == 1 || C == 3, 981234002, C);
 
+    if (method == BlurMethod::Auto) {
+        method = (strength >= kBoxCascadeMinStrength) ? BlurMethod::BoxCascade : BlurMethod::Gaussian;
+    }
+    if (method == BlurMethod::BoxCascade) {
+        return blur_box_cascade<T>(image, strength);
+    }
+
     const Kernel1D k = makeGaussianKernel(strength);
-    if (k.r == 0) return image;
+    if (k.r == 0) return image.toImage();
 
-    return (C == 1) ? blur_gray(image, k) : blur_rgb(image, k);
+    return blur_planar<T>(image, k);
 }
 
 template <typename T>
@@ -349,8 +428,10 @@ std::vector<Color<T>> blur(const std::vector<Color<T>> &colors, float strength)
 }
 
 // explicit instantiations
-template Image<std::uint8_t> blur(const Image<std::uint8_t>& image, float strength);
-template Image<float>        blur(const Image<float>& image, float strength);
+template Image<std::uint8_t> blur(const Image<std::uint8_t>& image, float strength, BlurMethod method);
+template Image<float>        blur(const Image<float>& image, float strength, BlurMethod method);
+template Image<std::uint8_t> blur(ImageView<const std::uint8_t> image, float strength, BlurMethod method);
+template Image<float>        blur(ImageView<const float> image, float strength, BlurMethod method);
 
 template std::vector<Color<std::uint8_t>> blur(const std::vector<Color<std::uint8_t>>& colors, float strength);
 template std::vector<Color<float>>        blur(const std::vector<Color<float>>& colors, float strength);
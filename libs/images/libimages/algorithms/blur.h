@@ -4,9 +4,21 @@
 
 #include <libimages/color.h>
 #include <libimages/image.h>
+#include <libimages/image_view.h>
+
+// Gaussian   - exact separable gaussian kernel with radius ceil(3 * strength), cost per pixel grows with strength
+// BoxCascade - three successive box blurs with the same variance (running sums), cost per pixel doesn't depend
+//              on strength, max error vs Gaussian is within a few intensity levels of 255 (see blur_tests.cpp)
+// Auto       - BoxCascade for strength >= kBoxCascadeMinStrength, Gaussian otherwise
+enum class BlurMethod { Auto, Gaussian, BoxCascade };
+
+constexpr float kBoxCascadeMinStrength = 8.0f;
+
+template <typename T>
+Image<T> blur(const Image<T> &image, float strength, BlurMethod method = BlurMethod::Auto);
 
 template <typename T>
-Image<T> blur(const Image<T> &image, float strength);
+Image<T> blur(ImageView<const T> image, float strength, BlurMethod method = BlurMethod::Auto);
 
 template <typename T>
 std::vector<Color<T>> blur(const std::vector<Color<T>> &colors, float strength);
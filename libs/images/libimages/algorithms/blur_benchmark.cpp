@@ -0,0 +1,49 @@
+#include "blur.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/simd_level.h>
+#include <libimages/algorithms/grayscale.h>
+#include <libimages/benchmark_utils.h>
+
+TEST(blur_benchmark, rgb) {
+    const image8u board = makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight);
+    for (float sigma : {1.0f, 3.0f, 10.0f}) {
+        benchmark("blur rgb 8u sigma=" + std::to_string(static_cast<int>(sigma)), [&]() { blur(board, sigma); });
+    }
+}
+
+TEST(blur_benchmark, gray) {
+    const image32f gray = to_grayscale_float(makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight));
+    for (float sigma : {1.0f, 3.0f, 10.0f}) {
+        benchmark("blur gray 32f sigma=" + std::to_string(static_cast<int>(sigma)), [&]() { blur(gray, sigma); });
+    }
+}
+
+// Every SIMD level on sizes up to full-resolution photos (takes a few minutes):
+//   ./libimages_benchmarks --gtest_filter=blur_benchmark.simdLevels
+TEST(blur_benchmark, simdLevels) {
+    const SimdLevel supported = supportedSimdLevel();
+    for (auto [w, h] : std::vector<std::pair<int, int>>{{1500, 1000}, {3000, 2000}, {6000, 4000}}) {
+        const image8u board = makeBenchmarkBoard(w, h);
+        const std::string size = std::to_string(w) + "x" + std::to_string(h);
+        for (float sigma : {1.0f, 3.0f, 10.0f, 30.0f}) {
+            for (int level = 0; level <= static_cast<int>(supported); ++level) {
+                setSimdLevel(static_cast<SimdLevel>(level));
+                benchmark("blur rgb 8u " + size + " sigma=" + std::to_string(static_cast<int>(sigma)) + " " +
+                              toString(static_cast<SimdLevel>(level)),
+                          [&]() { blur(board, sigma); }, 1);
+            }
+        }
+    }
+    setSimdLevel(supported);
+}
+
+TEST(blur_benchmark, gaussianVsBoxCascade) {
+    const image8u board = makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight);
+    for (float sigma : {3.0f, 8.0f, 15.0f, 30.0f, 60.0f}) {
+        const std::string suffix = " sigma=" + std::to_string(static_cast<int>(sigma));
+        benchmark("blur rgb 8u gaussian" + suffix, [&]() { blur(board, sigma, BlurMethod::Gaussian); });
+        benchmark("blur rgb 8u box cascade" + suffix, [&]() { blur(board, sigma, BlurMethod::BoxCascade); });
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+#include <libbase/simd_level.h>
+
+// Row primitives of the separable image blur (internal header of blur.cpp),
+// implemented for every SimdLevel in blur_kernels_<level>.cpp (each compiled with its own instruction set flags).
+namespace blur_kernels {
+
+    struct Kernels {
+        // Horizontal pass: dst[x] = sum_{d < taps} w[d] * src[x + d], x in [0, n) (src is a row padded by taps - 1)
+        void (*convolve_row)(const float* src, const float* w, int taps, float* dst, int n);
+        // Vertical pass: dst[x] = sum_{d < taps} w[d] * rows[d][x], x in [0, n)
+        void (*convolve_rows)(const float* const* rows, const float* w, int taps, float* dst, int n);
+        // dst[x] = src[x] clamped to [0, 255] and rounded half up
+        void (*store_u8)(const float* src, std::uint8_t* dst, int n);
+    };
+
+    const Kernels& scalarKernels();
+#if defined(LIBIMAGES_X86_SIMD_KERNELS)
+    const Kernels& sse4Kernels();
+    const Kernels& avx2Kernels();
+#endif
+
+    // Kernels for currentSimdLevel() (or the best level below it that is compiled in)
+    const Kernels& currentKernels();
+
+    inline std::uint8_t round_u8(float v) {
+        v = v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v);
+        return static_cast<std::uint8_t>(static_cast<int>(v + 0.5f));
+    }
+
+} // namespace blur_kernels
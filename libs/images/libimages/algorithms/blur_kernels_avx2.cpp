@@ -0,0 +1,94 @@
+#include "blur_kernels.h"
+
+#include <immintrin.h>
+
+// compiled with -mavx2 -mfma (see CMakeLists.txt), 8 floats per register
+
+namespace blur_kernels {
+
+namespace {
+
+void convolve_row(const float* src, const float* w, int taps, float* dst, int n) {
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        for (int d = 0; d < taps; ++d) {
+            const __m256 wd = _mm256_broadcast_ss(w + d);
+            acc0 = _mm256_fmadd_ps(wd, _mm256_loadu_ps(src + x + d), acc0);
+            acc1 = _mm256_fmadd_ps(wd, _mm256_loadu_ps(src + x + d + 8), acc1);
+        }
+        _mm256_storeu_ps(dst + x, acc0);
+        _mm256_storeu_ps(dst + x + 8, acc1);
+    }
+    for (; x < n; ++x) {
+        float acc = 0.0f;
+        for (int d = 0; d < taps; ++d)
+            acc += w[d] * src[x + d];
+        dst[x] = acc;
+    }
+}
+
+void convolve_rows(const float* const* rows, const float* w, int taps, float* dst, int n) {
+    int x = 0;
+    // 32 pixels per iteration stay in registers for all taps
+    for (; x + 32 <= n; x += 32) {
+        __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+        for (int d = 0; d < taps; ++d) {
+            const __m256 wd = _mm256_broadcast_ss(w + d);
+            const float* row = rows[d] + x;
+            acc0 = _mm256_fmadd_ps(wd, _mm256_loadu_ps(row), acc0);
+            acc1 = _mm256_fmadd_ps(wd, _mm256_loadu_ps(row + 8), acc1);
+            acc2 = _mm256_fmadd_ps(wd, _mm256_loadu_ps(row + 16), acc2);
+            acc3 = _mm256_fmadd_ps(wd, _mm256_loadu_ps(row + 24), acc3);
+        }
+        _mm256_storeu_ps(dst + x, acc0);
+        _mm256_storeu_ps(dst + x + 8, acc1);
+        _mm256_storeu_ps(dst + x + 16, acc2);
+        _mm256_storeu_ps(dst + x + 24, acc3);
+    }
+    for (; x + 8 <= n; x += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int d = 0; d < taps; ++d)
+            acc = _mm256_fmadd_ps(_mm256_broadcast_ss(w + d), _mm256_loadu_ps(rows[d] + x), acc);
+        _mm256_storeu_ps(dst + x, acc);
+    }
+    for (; x < n; ++x) {
+        float acc = 0.0f;
+        for (int d = 0; d < taps; ++d)
+            acc += w[d] * rows[d][x];
+        dst[x] = acc;
+    }
+}
+
+void store_u8(const float* src, std::uint8_t* dst, int n) {
+    const __m256 lo = _mm256_setzero_ps();
+    const __m256 hi = _mm256_set1_ps(255.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    // packs work inside of 128-bit lanes, this permutation restores pixels order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int x = 0;
+    for (; x + 32 <= n; x += 32) {
+        __m256i v[4];
+        for (int k = 0; k < 4; ++k) {
+            const __m256 f = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + x + 8 * k), lo), hi);
+            v[k] = _mm256_cvttps_epi32(_mm256_add_ps(f, half));
+        }
+        const __m256i w01 = _mm256_packus_epi32(v[0], v[1]);
+        const __m256i w23 = _mm256_packus_epi32(v[2], v[3]);
+        const __m256i b = _mm256_packus_epi16(w01, w23);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), _mm256_permutevar8x32_epi32(b, order));
+    }
+    for (; x < n; ++x)
+        dst[x] = round_u8(src[x]);
+}
+
+} // namespace
+
+const Kernels& avx2Kernels() {
+    static const Kernels kernels{convolve_row, convolve_rows, store_u8};
+    return kernels;
+}
+
+} // namespace blur_kernels
@@ -0,0 +1,53 @@
+#include "blur_kernels.h"
+
+namespace blur_kernels {
+
+namespace {
+
+void convolve_row(const float* src, const float* w, int taps, float* dst, int n) {
+    for (int x = 0; x < n; ++x) {
+        float acc = 0.0f;
+        for (int d = 0; d < taps; ++d)
+            acc += w[d] * src[x + d];
+        dst[x] = acc;
+    }
+}
+
+void convolve_rows(const float* const* rows, const float* w, int taps, float* dst, int n) {
+    for (int x = 0; x < n; ++x)
+        dst[x] = w[0] * rows[0][x];
+    for (int d = 1; d < taps; ++d) {
+        const float* row = rows[d];
+        const float wd = w[d];
+        for (int x = 0; x < n; ++x)
+            dst[x] += wd * row[x];
+    }
+}
+
+void store_u8(const float* src, std::uint8_t* dst, int n) {
+    for (int x = 0; x < n; ++x)
+        dst[x] = round_u8(src[x]);
+}
+
+} // namespace
+
+const Kernels& scalarKernels() {
+    static const Kernels kernels{convolve_row, convolve_rows, store_u8};
+    return kernels;
+}
+
+const Kernels& currentKernels() {
+#if defined(LIBIMAGES_X86_SIMD_KERNELS)
+    switch (currentSimdLevel()) {
+    case SimdLevel::AVX2:
+        return avx2Kernels();
+    case SimdLevel::SSE4:
+        return sse4Kernels();
+    case SimdLevel::Scalar:
+        break;
+    }
+#endif
+    return scalarKernels();
+}
+
+} // namespace blur_kernels
@@ -0,0 +1,84 @@
+#include "blur_kernels.h"
+
+#include <smmintrin.h>
+
+// compiled with -msse4.1 (see CMakeLists.txt), 4 floats per register, no FMA
+
+namespace blur_kernels {
+
+namespace {
+
+void convolve_row(const float* src, const float* w, int taps, float* dst, int n) {
+    int x = 0;
+    for (; x + 8 <= n; x += 8) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        for (int d = 0; d < taps; ++d) {
+            const __m128 wd = _mm_set1_ps(w[d]);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(wd, _mm_loadu_ps(src + x + d)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(wd, _mm_loadu_ps(src + x + d + 4)));
+        }
+        _mm_storeu_ps(dst + x, acc0);
+        _mm_storeu_ps(dst + x + 4, acc1);
+    }
+    for (; x < n; ++x) {
+        float acc = 0.0f;
+        for (int d = 0; d < taps; ++d)
+            acc += w[d] * src[x + d];
+        dst[x] = acc;
+    }
+}
+
+void convolve_rows(const float* const* rows, const float* w, int taps, float* dst, int n) {
+    int x = 0;
+    // 16 pixels per iteration stay in registers for all taps
+    for (; x + 16 <= n; x += 16) {
+        __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+        for (int d = 0; d < taps; ++d) {
+            const __m128 wd = _mm_set1_ps(w[d]);
+            const float* row = rows[d] + x;
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(wd, _mm_loadu_ps(row)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(wd, _mm_loadu_ps(row + 4)));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(wd, _mm_loadu_ps(row + 8)));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(wd, _mm_loadu_ps(row + 12)));
+        }
+        _mm_storeu_ps(dst + x, acc0);
+        _mm_storeu_ps(dst + x + 4, acc1);
+        _mm_storeu_ps(dst + x + 8, acc2);
+        _mm_storeu_ps(dst + x + 12, acc3);
+    }
+    for (; x < n; ++x) {
+        float acc = 0.0f;
+        for (int d = 0; d < taps; ++d)
+            acc += w[d] * rows[d][x];
+        dst[x] = acc;
+    }
+}
+
+void store_u8(const float* src, std::uint8_t* dst, int n) {
+    const __m128 lo = _mm_setzero_ps();
+    const __m128 hi = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        __m128i v[4];
+        for (int k = 0; k < 4; ++k) {
+            const __m128 f = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + x + 4 * k), lo), hi);
+            v[k] = _mm_cvttps_epi32(_mm_add_ps(f, half));
+        }
+        const __m128i w01 = _mm_packus_epi32(v[0], v[1]);
+        const __m128i w23 = _mm_packus_epi32(v[2], v[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(w01, w23));
+    }
+    for (; x < n; ++x)
+        dst[x] = round_u8(src[x]);
+}
+
+} // namespace
+
+const Kernels& sse4Kernels() {
+    static const Kernels kernels{convolve_row, convolve_rows, store_u8};
+    return kernels;
+}
+
+} // namespace blur_kernels
@@ -3,12 +3,15 @@
 #include <gtest/gtest.h>
 
 #include <libbase/configure_working_directory.h>
+#include <libbase/fast_random.h>
+#include <libbase/simd_level.h>
 #include <libimages/debug_io.h>
 #include <libimages/image.h>
 
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <iostream>
 #include <vector>
 #include <libimages/tests_utils.h>
 
@@ -51,8 +54,127 @@ static image8u visualizeLines(const std::vector<color8u>& a, const std::vector<c
     return img;
 }
 
+template <typename T>
+static Image<T> makeRandomImage(int w, int h, int c, uint32_t seed) {
+    FastRandom r(seed);
+    Image<T> img(w, h, c);
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x)
+            for (int k = 0; k < c; ++k)
+                img(y, x, k) = static_cast<T>(r.nextInt(0, 255));
+    return img;
+}
+
+// straightforward separable gaussian in double precision with replicated borders
+template <typename T>
+static std::vector<double> blurReference(const Image<T>& img, float sigma) {
+    const int R = static_cast<int>(std::ceil(3.0f * sigma));
+    std::vector<double> k(2 * R + 1);
+    double sum = 0.0;
+    for (int i = -R; i <= R; ++i) {
+        k[i + R] = std::exp(-(double) i * i / (2.0 * sigma * sigma));
+        sum += k[i + R];
+    }
+    for (double& v : k) v /= sum;
+
+    const int W = img.width(), H = img.height(), C = img.channels();
+    auto at = [&](int y, int x, int c) { return static_cast<size_t>((y * W + x) * C + c); };
+    std::vector<double> tmp(static_cast<size_t>(W) * H * C), out(tmp.size());
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x)
+            for (int c = 0; c < C; ++c) {
+                double acc = 0.0;
+                for (int d = -R; d <= R; ++d)
+                    acc += k[d + R] * img(y, std::clamp(x + d, 0, W - 1), c);
+                tmp[at(y, x, c)] = acc;
+            }
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x)
+            for (int c = 0; c < C; ++c) {
+                double acc = 0.0;
+                for (int d = -R; d <= R; ++d)
+                    acc += k[d + R] * tmp[at(std::clamp(y + d, 0, H - 1), x, c)];
+                out[at(y, x, c)] = acc;
+            }
+    return out;
+}
+
+template <typename T>
+static double maxDifference(const Image<T>& img, const std::vector<double>& reference) {
+    double maxDiff = 0.0;
+    const int C = img.channels();
+    for (int y = 0; y < img.height(); ++y)
+        for (int x = 0; x < img.width(); ++x)
+            for (int c = 0; c < C; ++c) {
+                const double expected = reference[static_cast<size_t>((y * img.width() + x) * C + c)];
+                maxDiff = std::max(maxDiff, std::abs(static_cast<double>(img(y, x, c)) - expected));
+            }
+    return maxDiff;
+}
+
 } // namespace
 
+TEST(blur, image_all_simd_levels_match_reference) {
+    const SimdLevel supported = supportedSimdLevel();
+    for (int level = 0; level <= static_cast<int>(supported); ++level) {
+        setSimdLevel(static_cast<SimdLevel>(level));
+        // widths are not multiples of SIMD widths to check tails, 1x1 checks border replication
+        for (auto [w, h] : std::vector<std::pair<int, int>>{{1, 1}, {37, 5}, {101, 43}}) {
+            for (float sigma : {0.7f, 2.0f, 5.0f}) {
+                const image8u rgb = makeRandomImage<std::uint8_t>(w, h, 3, 239 + w);
+                EXPECT_LE(maxDifference(blur(rgb, sigma, BlurMethod::Gaussian), blurReference(rgb, sigma)), 0.5 + 1e-3)
+                    << toString(static_cast<SimdLevel>(level)) << " rgb " << w << "x" << h << " sigma=" << sigma;
+
+                const image8u gray = makeRandomImage<std::uint8_t>(w, h, 1, 566 + w);
+                EXPECT_LE(maxDifference(blur(gray, sigma, BlurMethod::Gaussian), blurReference(gray, sigma)), 0.5 + 1e-3)
+                    << toString(static_cast<SimdLevel>(level)) << " gray " << w << "x" << h << " sigma=" << sigma;
+
+                const image32f grayf = makeRandomImage<float>(w, h, 1, 30 + w);
+                EXPECT_LE(maxDifference(blur(grayf, sigma, BlurMethod::Gaussian), blurReference(grayf, sigma)), 1e-3)
+                    << toString(static_cast<SimdLevel>(level)) << " gray32f " << w << "x" << h << " sigma=" << sigma;
+            }
+        }
+    }
+    setSimdLevel(supported);
+}
+
+// Worst case for box cascade approximation: sharp edges (step + thin bright lines) on top of noise
+static image8u makeEdgesImage(int w, int h, int c) {
+    image8u img = makeRandomImage<std::uint8_t>(w, h, c, 777);
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x)
+            for (int k = 0; k < c; ++k) {
+                if (x > w / 2) img(y, x, k) = 255;
+                if (y % 37 == 0 || x % 41 == 0) img(y, x, k) = 255;
+                if (x < w / 2 && y > h / 2) img(y, x, k) = 0;
+            }
+    return img;
+}
+
+TEST(blur, image_box_cascade_accuracy) {
+    // max abs difference from exact gaussian (in 0..255 intensity levels) on sharp edges, measured: 6.5 for sigma=2,
+    // 2.5-3.5 for sigma=4..30 (box cascade is too coarse for small sigma, that is why Auto uses it only from sigma=8)
+    const std::vector<std::pair<float, double>> bounds = {{2.0f, 8.0}, {4.0f, 4.0}, {8.0f, 4.0}, {15.0f, 4.0}, {30.0f, 4.0}};
+    for (auto [sigma, bound] : bounds) {
+        const image8u img = makeEdgesImage(257, 193, 3);
+        const std::vector<double> reference = blurReference(img, sigma);
+        const double diff = maxDifference(blur(img, sigma, BlurMethod::BoxCascade), reference);
+        std::cout << "sigma=" << sigma << " max difference of box cascade from gaussian: " << diff << std::endl;
+        EXPECT_LE(diff, bound) << sigma;
+
+        const image32f gray = makeRandomImage<float>(120, 90, 1, 4);
+        const double diffNoise = maxDifference(blur(gray, sigma, BlurMethod::BoxCascade), blurReference(gray, sigma));
+        EXPECT_LE(diffNoise, bound) << sigma;
+    }
+}
+
+TEST(blur, image_auto_method) {
+    const image8u img = makeEdgesImage(64, 48, 1);
+    EXPECT_EQ(blur(img, 3.0f).toVector(), blur(img, 3.0f, BlurMethod::Gaussian).toVector());
+    EXPECT_EQ(blur(img, kBoxCascadeMinStrength).toVector(),
+              blur(img, kBoxCascadeMinStrength, BlurMethod::BoxCascade).toVector());
+}
+
 TEST(blur, colors_strength0_identity) {
     configureWorkingDirectory();
 
@@ -0,0 +1,211 @@
+#include "connected_components.h"
+
+#include <libbase/runtime_assert.h>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <numeric>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace {
+
+constexpr std::uint8_t kObject = 255;
+
+// Rows per stripe: stripes are labelled independently, the seams between them are merged sequentially
+constexpr int kStripeRows = 64;
+
+void append_runs(const image8u &mask, int y, std::vector<PixelRun> &runs) {
+    const std::uint8_t *row = mask.ptr(y);
+    const int w = mask.width();
+    int x = 0;
+    while (x < w) {
+        while (x < w && row[x] != kObject)
+            ++x;
+        if (x == w)
+            break;
+        const int begin = x;
+        while (x < w && row[x] == kObject)
+            ++x;
+        runs.push_back({y, begin, x, 0});
+    }
+}
+
+void append_runs(const BitMask &mask, int y, std::vector<PixelRun> &runs) {
+    using word_type = BitMask::word_type;
+    const word_type *row = mask.row(y);
+    const int words = static_cast<int>(mask.words_per_row());
+    constexpr int kBits = BitMask::kWordBits;
+    // scans for the next set bit (or the next zero bit when looking for the end of a run) a word at a time
+    auto next = [&](int x, bool set) {
+        int k = x / kBits;
+        if (k >= words)
+            return mask.width();
+        word_type word = (set ? row[k] : ~row[k]) & (~word_type(0) << (x % kBits));
+        while (word == 0) {
+            if (++k == words)
+                return mask.width();
+            word = set ? row[k] : ~row[k];
+        }
+        return std::min(mask.width(), k * kBits + std::countr_zero(word));
+    };
+    int x = next(0, true);
+    while (x < mask.width()) {
+        const int end = next(x, false);
+        runs.push_back({y, x, end, 0});
+        x = next(end, true);
+    }
+}
+
+// Union-find over run indices, the smaller index is always the root, so parent[i] <= i
+std::uint32_t find_root(std::vector<std::uint32_t> &parent, std::uint32_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+void unite(std::vector<std::uint32_t> &parent, std::uint32_t a, std::uint32_t b) {
+    a = find_root(parent, a);
+    b = find_root(parent, b);
+    if (a == b)
+        return;
+    if (a > b)
+        std::swap(a, b);
+    parent[b] = a;
+}
+
+// Unites runs of two consecutive rows that touch (8-connectivity): [a0, a1) and [b0, b1) touch iff a0 <= b1 && b0 <= a1
+void unite_rows(const std::vector<PixelRun> &runs, std::vector<std::uint32_t> &parent, std::uint32_t prev_begin,
+                std::uint32_t prev_end, std::uint32_t cur_begin, std::uint32_t cur_end) {
+    std::uint32_t a = prev_begin;
+    std::uint32_t b = cur_begin;
+    while (a < prev_end && b < cur_end) {
+        if (runs[a].x_begin <= runs[b].x_end && runs[b].x_begin <= runs[a].x_end)
+            unite(parent, a, b);
+        // the run that ends first can't touch anything after the other one
+        if (runs[a].x_end < runs[b].x_end) {
+            ++a;
+        } else {
+            ++b;
+        }
+    }
+}
+
+template <typename Mask>
+ConnectedComponents find_components(const Mask &mask, bool with_openmp) {
+    const int h = mask.height();
+    const int stripes = (h + kStripeRows - 1) / kStripeRows;
+
+    ConnectedComponents result;
+    result.row_runs.assign(static_cast<std::size_t>(h) + 1, 0);
+
+    // 1) runs of every stripe
+    std::vector<std::vector<PixelRun>> stripe_runs(stripes);
+    #pragma omp parallel for schedule(dynamic, 1) if(with_openmp)
+    for (int s = 0; s < stripes; ++s) {
+        for (int y = s * kStripeRows; y < std::min(h, (s + 1) * kStripeRows); ++y) {
+            append_runs(mask, y, stripe_runs[s]);
+        }
+    }
+
+    std::vector<std::size_t> stripe_offset(stripes + 1, 0);
+    for (int s = 0; s < stripes; ++s)
+        stripe_offset[s + 1] = stripe_offset[s] + stripe_runs[s].size();
+    const std::size_t n = stripe_offset[stripes];
+    rassert(n < std::numeric_limits<std::uint32_t>::max(), 5530129871, n);
+    result.runs.resize(n);
+    std::vector<std::uint32_t> parent(n);
+
+    // 2) union-find inside of every stripe, only indices of the stripe are touched
+    #pragma omp parallel for schedule(dynamic, 1) if(with_openmp)
+    for (int s = 0; s < stripes; ++s) {
+        std::copy(stripe_runs[s].begin(), stripe_runs[s].end(), result.runs.begin() + stripe_offset[s]);
+        std::vector<PixelRun>().swap(stripe_runs[s]);
+
+        const std::uint32_t begin = static_cast<std::uint32_t>(stripe_offset[s]);
+        const std::uint32_t end = static_cast<std::uint32_t>(stripe_offset[s + 1]);
+        std::iota(parent.begin() + begin, parent.begin() + end, begin);
+
+        std::uint32_t prev_begin = begin, prev_end = begin;
+        std::uint32_t i = begin;
+        for (int y = s * kStripeRows; y < std::min(h, (s + 1) * kStripeRows); ++y) {
+            const std::uint32_t cur_begin = i;
+            while (i < end && result.runs[i].y == y)
+                ++i;
+            result.row_runs[y] = cur_begin;
+            unite_rows(result.runs, parent, prev_begin, prev_end, cur_begin, i);
+            prev_begin = cur_begin;
+            prev_end = i;
+        }
+    }
+    result.row_runs[h] = static_cast<std::uint32_t>(n);
+
+    // 3) seams between stripes
+    for (int s = 1; s < stripes; ++s) {
+        const int y = s * kStripeRows;
+        unite_rows(result.runs, parent, result.row_runs[y - 1], result.row_runs[y], result.row_runs[y],
+                   result.row_runs[y + 1]);
+    }
+
+    // 4) parent[i] <= i, so one pass in increasing order resolves all roots, roots get provisional labels
+    std::vector<std::uint32_t> provisional(n);
+    std::uint32_t count = 0;
+    for (std::uint32_t i = 0; i < n; ++i) {
+        provisional[i] = parent[i] == i ? count++ : provisional[parent[i]];
+    }
+
+    std::vector<ComponentStats> stats(count);
+    std::vector<double> sum_x(count, 0.0), sum_y(count, 0.0);
+    for (std::uint32_t i = 0; i < n; ++i) {
+        const PixelRun &run = result.runs[i];
+        const std::uint32_t l = provisional[i];
+        ComponentStats &c = stats[l];
+        const double len = run.length();
+        c.bbox.include_pixel(run.x_begin, run.y);
+        c.bbox.include_pixel(run.x_end - 1, run.y);
+        c.area += run.length();
+        sum_x[l] += len * (run.x_begin + run.x_end - 1) / 2.0;
+        sum_y[l] += len * run.y;
+    }
+    for (std::uint32_t l = 0; l < count; ++l) {
+        stats[l].centroid = point2f(static_cast<float>(sum_x[l] / stats[l].area),
+                                    static_cast<float>(sum_y[l] / stats[l].area));
+    }
+
+    // 5) final labels in order of bbox top-left (y, then x)
+    std::vector<std::uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+        const bbox2i &A = stats[a].bbox;
+        const bbox2i &B = stats[b].bbox;
+        if (A.min.y != B.min.y) return A.min.y < B.min.y;
+        if (A.min.x != B.min.x) return A.min.x < B.min.x;
+        return a < b;
+    });
+    std::vector<std::uint32_t> final_label(count);
+    result.components.resize(count);
+    for (std::uint32_t k = 0; k < count; ++k) {
+        final_label[order[k]] = k;
+        result.components[k] = stats[order[k]];
+    }
+    for (std::uint32_t i = 0; i < n; ++i)
+        result.runs[i].label = final_label[provisional[i]];
+
+    return result;
+}
+
+} // namespace
+
+ConnectedComponents findConnectedComponents(const image8u &objectsMask, bool with_openmp) {
+    rassert(objectsMask.channels() == 1, 5530129872, objectsMask.channels());
+    return find_components(objectsMask, with_openmp);
+}
+
+ConnectedComponents findConnectedComponents(const BitMask &objectsMask, bool with_openmp) {
+    return find_components(objectsMask, with_openmp);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <libbase/bbox2.h>
+#include <libbase/point2.h>
+#include <libimages/bit_mask.h>
+#include <libimages/image.h>
+
+// Horizontal run of object pixels [x_begin, x_end) of row y that belongs to component label
+struct PixelRun {
+    int y;
+    int x_begin;
+    int x_end;
+    std::uint32_t label;
+
+    int length() const noexcept { return x_end - x_begin; }
+};
+
+struct ComponentStats {
+    bbox2i bbox;          // half-open pixel bbox
+    std::size_t area = 0; // number of pixels
+    point2f centroid;     // mean of pixel coordinates
+};
+
+// 8-connected components of object pixels, labels are 0..components.size()-1
+// in order of bbox top-left (y, then x), like the objects of splitObjects.
+struct ConnectedComponents {
+    std::vector<PixelRun> runs;          // in raster order
+    std::vector<std::uint32_t> row_runs; // runs of row y are [row_runs[y], row_runs[y + 1])
+    std::vector<ComponentStats> components;
+};
+
+// Run-based labelling: every row is split into object runs, runs are united with overlapping runs
+// (8-connectivity: touching diagonally counts) of the previous row by union-find over 32-bit run indices.
+// Image is processed in stripes of rows in parallel, stripe seams are merged afterwards,
+// so memory is O(runs) instead of O(pixels) and stats are gathered per run, not per pixel.
+//
+// objectsMask: 0 = background, 255 = object (other values are treated as background).
+ConnectedComponents findConnectedComponents(const image8u &objectsMask, bool with_openmp = true);
+ConnectedComponents findConnectedComponents(const BitMask &objectsMask, bool with_openmp = true);
@@ -0,0 +1,142 @@
+#include "connected_components.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/tests_utils.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Flood fill reference: label image (-1 = background) with labels in raster order of the first pixel
+std::vector<int> floodFillLabels(const image8u &mask, int &count) {
+    const int w = mask.width();
+    const int h = mask.height();
+    std::vector<int> labels(static_cast<std::size_t>(w) * h, -1);
+    count = 0;
+    std::vector<point2i> stack;
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x) {
+            if (mask(y, x) != 255 || labels[y * w + x] != -1)
+                continue;
+            labels[y * w + x] = count;
+            stack.push_back({x, y});
+            while (!stack.empty()) {
+                const point2i p = stack.back();
+                stack.pop_back();
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        const int nx = p.x + dx, ny = p.y + dy;
+                        if (nx < 0 || ny < 0 || nx >= w || ny >= h || mask(ny, nx) != 255 || labels[ny * w + nx] != -1)
+                            continue;
+                        labels[ny * w + nx] = count;
+                        stack.push_back({nx, ny});
+                    }
+            }
+            ++count;
+        }
+    return labels;
+}
+
+void expectSameAsFloodFill(const image8u &mask, const ConnectedComponents &cc) {
+    const int w = mask.width();
+    int count = 0;
+    const std::vector<int> reference = floodFillLabels(mask, count);
+    ASSERT_EQ(cc.components.size(), static_cast<std::size_t>(count));
+
+    // runs cover exactly the object pixels, labels are a bijection with the reference labels
+    std::vector<int> toReference(count, -1);
+    std::size_t covered = 0;
+    for (int y = 0; y < mask.height(); ++y) {
+        ASSERT_LE(cc.row_runs[y], cc.row_runs[y + 1]);
+        for (std::uint32_t i = cc.row_runs[y]; i < cc.row_runs[y + 1]; ++i) {
+            const PixelRun &run = cc.runs[i];
+            ASSERT_EQ(run.y, y);
+            ASSERT_LT(run.label, cc.components.size());
+            for (int x = run.x_begin; x < run.x_end; ++x) {
+                const int ref = reference[y * w + x];
+                ASSERT_NE(ref, -1);
+                if (toReference[run.label] == -1)
+                    toReference[run.label] = ref;
+                ASSERT_EQ(toReference[run.label], ref);
+                ++covered;
+            }
+        }
+    }
+    std::size_t objectPixels = 0;
+    for (int v : reference)
+        objectPixels += v != -1;
+    EXPECT_EQ(covered, objectPixels);
+
+    // stats and order
+    for (std::size_t k = 0; k < cc.components.size(); ++k) {
+        bbox2i bbox;
+        std::size_t area = 0;
+        double sx = 0.0, sy = 0.0;
+        for (int y = 0; y < mask.height(); ++y)
+            for (int x = 0; x < w; ++x)
+                if (reference[y * w + x] == toReference[k]) {
+                    bbox.include_pixel(x, y);
+                    ++area;
+                    sx += x;
+                    sy += y;
+                }
+        const ComponentStats &c = cc.components[k];
+        EXPECT_EQ(c.area, area);
+        EXPECT_EQ(c.bbox.min, bbox.min);
+        EXPECT_EQ(c.bbox.max, bbox.max);
+        EXPECT_NEAR(c.centroid.x, sx / area, 1e-3);
+        EXPECT_NEAR(c.centroid.y, sy / area, 1e-3);
+        if (k > 0) {
+            const bbox2i &prev = cc.components[k - 1].bbox;
+            EXPECT_TRUE(prev.min.y < c.bbox.min.y || (prev.min.y == c.bbox.min.y && prev.min.x <= c.bbox.min.x));
+        }
+    }
+}
+
+} // namespace
+
+TEST(connected_components, matchesFloodFill) {
+    // heights cross the stripe seams, widths cross the bit mask words
+    for (int h : {1, 5, 64, 65, 200}) {
+        for (int w : {1, 63, 64, 130}) {
+            const image8u mask = makeRandomMask(w, h, 12, 239 + w * h);
+            for (bool with_openmp : {false, true}) {
+                expectSameAsFloodFill(mask, findConnectedComponents(mask, with_openmp));
+                expectSameAsFloodFill(mask, findConnectedComponents(BitMask::fromImage(mask), with_openmp));
+            }
+        }
+    }
+}
+
+TEST(connected_components, noisyMaskWithDiagonalTouches) {
+    // random pixels make lots of tiny components connected only diagonally
+    image8u mask(150, 150, 1);
+    std::uint32_t state = 7;
+    for (int y = 0; y < 150; ++y)
+        for (int x = 0; x < 150; ++x) {
+            state = state * 1664525u + 1013904223u;
+            mask(y, x) = (state >> 28) < 6 ? 255 : 0;
+        }
+    expectSameAsFloodFill(mask, findConnectedComponents(mask));
+}
+
+TEST(connected_components, diagonalChainAcrossSeam) {
+    // one-pixel diagonal line crosses the stripe seam at y = 64
+    image8u mask(100, 100, 1);
+    for (int i = 0; i < 100; ++i)
+        mask(i, 99 - i) = 255;
+    const ConnectedComponents cc = findConnectedComponents(mask);
+    ASSERT_EQ(cc.components.size(), 1u);
+    EXPECT_EQ(cc.components[0].area, 100u);
+    EXPECT_EQ(cc.runs.size(), 100u);
+}
+
+TEST(connected_components, emptyMask) {
+    const ConnectedComponents cc = findConnectedComponents(image8u(10, 70, 1));
+    EXPECT_TRUE(cc.components.empty());
+    EXPECT_TRUE(cc.runs.empty());
+    EXPECT_EQ(cc.row_runs.size(), 71u);
+}
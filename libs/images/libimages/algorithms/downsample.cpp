@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 
 namespace {
@@ -27,10 +28,106 @@ inline int safe_mid_index(int m) {
     return (m <= 0) ? 0 : (m / 2);
 }
 
+template <typename T>
+inline T from_float(float v) {
+    if constexpr (std::is_same_v<T, std::uint8_t>) {
+        return static_cast<std::uint8_t>(std::clamp(v + 0.5f, 0.0f, 255.0f));
+    } else if constexpr (std::is_integral_v<T>) {
+        return static_cast<T>(std::lround(v));
+    } else {
+        return static_cast<T>(v);
+    }
+}
+
+// Output pixel i covers source interval [i * scale, (i + 1) * scale), scale = extent / n_dst,
+// its taps are source pixels first[i] + k with weights[offset[i] + k] (overlap length / scale, sums to 1)
+struct AreaTaps {
+    std::vector<int> first;
+    std::vector<int> offset;
+    std::vector<float> weights;
+
+    int count(int i) const { return offset[i + 1] - offset[i]; }
+};
+
+AreaTaps area_taps(int n_src, double extent, int n_dst) {
+    AreaTaps taps;
+    taps.first.resize(n_dst);
+    taps.offset.resize(n_dst + 1);
+    const double scale = extent / n_dst;
+    for (int i = 0; i < n_dst; ++i) {
+        const double a = i * scale;
+        const double b = (i + 1) * scale;
+        const int first = std::min(n_src - 1, static_cast<int>(std::floor(a)));
+        const int last = std::min(n_src - 1, static_cast<int>(std::ceil(b)) - 1);
+        taps.first[i] = first;
+        taps.offset[i] = static_cast<int>(taps.weights.size());
+        for (int s = first; s <= std::max(first, last); ++s) {
+            const double overlap = std::min(b, s + 1.0) - std::max(a, static_cast<double>(s));
+            taps.weights.push_back(static_cast<float>(std::max(0.0, overlap) / scale));
+        }
+    }
+    taps.offset[n_dst] = static_cast<int>(taps.weights.size());
+    return taps;
+}
+
+// Separable box filter: rows are resampled to w into a float buffer, then columns to h
+template <typename T>
+void downsample_area(ImageView<const T> image, double srcW, double srcH, Image<T> &out) {
+    const int w = out.width();
+    const int h = out.height();
+    const int ch = image.channels();
+    const AreaTaps xtaps = area_taps(image.width(), srcW, w);
+    const AreaTaps ytaps = area_taps(image.height(), srcH, h);
+    // only rows used by the taps are resampled
+    const int rows = ytaps.first[h - 1] + ytaps.count(h - 1);
+
+    image32f tmp(w, rows, ch, ImageInit::Uninitialized);
+    #pragma omp parallel for schedule(static)
+    for (int j = 0; j < rows; ++j) {
+        const T *src = image.ptr(j);
+        float *dst = tmp.ptr(j);
+        for (int x = 0; x < w; ++x) {
+            const T *p = src + static_cast<size_t>(xtaps.first[x]) * ch;
+            const float *wx = xtaps.weights.data() + xtaps.offset[x];
+            const int n = xtaps.count(x);
+            for (int c = 0; c < ch; ++c) {
+                float sum = 0.0f;
+                for (int k = 0; k < n; ++k)
+                    sum += wx[k] * static_cast<float>(p[k * ch + c]);
+                dst[x * ch + c] = sum;
+            }
+        }
+    }
+
+    const int rowSize = w * ch;
+    #pragma omp parallel
+    {
+        std::vector<float> acc(rowSize);
+        #pragma omp for schedule(static)
+        for (int y = 0; y < h; ++y) {
+            std::fill(acc.begin(), acc.end(), 0.0f);
+            const float *wy = ytaps.weights.data() + ytaps.offset[y];
+            for (int k = 0; k < ytaps.count(y); ++k) {
+                const float *src = tmp.ptr(ytaps.first[y] + k);
+                for (int i = 0; i < rowSize; ++i)
+                    acc[i] += wy[k] * src[i];
+            }
+            T *dst = out.ptr(y);
+            for (int i = 0; i < rowSize; ++i)
+                dst[i] = from_float<T>(acc[i]);
+        }
+    }
+}
+
 } // namespace
 
 template <typename T>
-Image<T> downsample(const Image<T> &image, int w, int h) {
+Image<T> downsample(const Image<T> &image, int w, int h, DownsampleMethod method) {
+    return downsample(ImageView<const T>(image), w, h, method);
+}
+
+template <typename T>
+Image<T> downsample(ImageView<const T> image, int w, int h, DownsampleMethod method) {
     rassert(w > 0 && h > 0, 781234981);
 
     const int srcW = image.width();
@@ -39,23 +136,31 @@ Image<T> downsample(const Image<T> &image, int w, int h) {
     rassert(srcW > 0 && srcH > 0, 781234982);
     rassert(ch == 1 || ch == 3, 781234983, ch);
 
-    Image<T> out(w, h, ch);
+    Image<T> out(w, h, ch, ImageInit::Uninitialized);
+
+    if (method == DownsampleMethod::Area) {
+        downsample_area(image, srcW, srcH, out);
+        return out;
+    }
 
     // Handle degenerate mappings (target size 1) by sampling center in that axis.
     const int sx_center = safe_mid_index<T>(srcW);
     const int sy_center = safe_mid_index<T>(srcH);
 
+    // Source column of every output column is the same for all rows.
+    std::vector<int> srcX(static_cast<size_t>(w));
+    for (int x = 0; x < w; ++x) {
+        srcX[x] = (w == 1) ? sx_center : map_index_round(x, w, srcW);
+    }
+
     for (int y = 0; y < h; ++y) {
         const int sy = (h == 1) ? sy_center : map_index_round(y, h, srcH);
+        const T* src = image.ptr(sy);
+        T* dst = out.ptr(y);
         for (int x = 0; x < w; ++x) {
-            const int sx = (w == 1) ? sx_center : map_index_round(x, w, srcW);
-
-            if (ch == 1) {
-                out(y, x) = image(sy, sx);
-            } else {
-                out(y, x, 0) = image(sy, sx, 0);
-                out(y, x, 1) = image(sy, sx, 1);
-                out(y, x, 2) = image(sy, sx, 2);
+            const T* p = src + static_cast<size_t>(srcX[x]) * ch;
+            for (int c = 0; c < ch; ++c) {
+                dst[x * ch + c] = p[c];
             }
         }
     }
@@ -63,6 +168,18 @@ Image<T> downsample(const Image<T> &image, int w, int h) {
     return out;
 }
 
+template <typename T>
+Image<T> downsampleArea(ImageView<const T> image, double srcW, double srcH, int w, int h) {
+    rassert(w > 0 && h > 0, 781234984, w, h);
+    rassert(image.channels() == 1 || image.channels() == 3, 781234985, image.channels());
+    rassert(srcW > 0.0 && srcW <= image.width() && srcH > 0.0 && srcH <= image.height(), 781234986, srcW, srcH,
+            image.width(), image.height());
+
+    Image<T> out(w, h, image.channels(), ImageInit::Uninitialized);
+    downsample_area(image, srcW, srcH, out);
+    return out;
+}
+
 template <typename T>
 std::vector<Color<T>> downsample(const std::vector<Color<T>> &colors, int n) {
     if (n <= 0) return {};
@@ -88,9 +205,15 @@ std::vector<Color<T>> downsample(const std::vector<Color<T>> &colors, int n) {
 }
 
 // ---- explicit instantiations ----
-template Image<std::uint8_t> downsample(const Image<std::uint8_t>& image, int w, int h);
-template Image<float>        downsample(const Image<float>& image, int w, int h);
-template Image<int>          downsample(const Image<int>& image, int w, int h);
+template Image<std::uint8_t> downsample(const Image<std::uint8_t>& image, int w, int h, DownsampleMethod method);
+template Image<float>        downsample(const Image<float>& image, int w, int h, DownsampleMethod method);
+template Image<int>          downsample(const Image<int>& image, int w, int h, DownsampleMethod method);
+template Image<std::uint8_t> downsample(ImageView<const std::uint8_t> image, int w, int h, DownsampleMethod method);
+template Image<float>        downsample(ImageView<const float> image, int w, int h, DownsampleMethod method);
+template Image<int>          downsample(ImageView<const int> image, int w, int h, DownsampleMethod method);
+template Image<std::uint8_t> downsampleArea(ImageView<const std::uint8_t> image, double srcW, double srcH, int w, int h);
+template Image<float>        downsampleArea(ImageView<const float> image, double srcW, double srcH, int w, int h);
+template Image<int>          downsampleArea(ImageView<const int> image, double srcW, double srcH, int w, int h);
 
 template std::vector<Color<std::uint8_t>> downsample(const std::vector<Color<std::uint8_t>>& colors, int n);
 template std::vector<Color<float>>        downsample(const std::vector<Color<float>>& colors, int n);
@@ -4,9 +4,24 @@
 
 #include <libimages/color.h>
 #include <libimages/image.h>
+#include <libimages/image_view.h>
 
+// Nearest - every output pixel takes one source pixel (endpoints preserved), aliases on large scale factors
+//           so the source has to be blurred first
+// Area    - every output pixel is the average of the source area it covers (fractional coverage of border pixels
+//           is weighted), anti-aliased by itself and O(source pixels) for any scale factor
+enum class DownsampleMethod { Nearest, Area };
+
+template <typename T>
+Image<T> downsample(const Image<T> &image, int w, int h, DownsampleMethod method = DownsampleMethod::Nearest);
+
+template <typename T>
+Image<T> downsample(ImageView<const T> image, int w, int h, DownsampleMethod method = DownsampleMethod::Nearest);
+
+// Area resampling of the top-left srcW x srcH part of the image (fractional sizes allowed, srcW <= width, srcH <= height),
+// e.g. for coarse pyramid levels that cover a bit more than the original image
 template <typename T>
-Image<T> downsample(const Image<T> &image, int w, int h);
+Image<T> downsampleArea(ImageView<const T> image, double srcW, double srcH, int w, int h);
 
 template <typename T>
 std::vector<Color<T>> downsample(const std::vector<Color<T>> &colors, int n);
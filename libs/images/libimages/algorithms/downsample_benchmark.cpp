@@ -0,0 +1,25 @@
+#include "downsample.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/algorithms/blur.h>
+#include <libimages/benchmark_utils.h>
+#include <libimages/image_pyramid.h>
+
+TEST(downsample_benchmark, previews) {
+    // thumbnail of the whole board, as for debug previews
+    const image8u board = makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight);
+    const int w = 300;
+    const int h = 200;
+
+    benchmark("blur + nearest", [&]() { downsample(blur(board, static_cast<float>(board.width()) / w), w, h); });
+    benchmark("area", [&]() { downsample(board, w, h, DownsampleMethod::Area); });
+    benchmark("pyramid build all levels", [&]() {
+        ImagePyramid<std::uint8_t> pyramid(board);
+        pyramid.level(pyramid.levels() - 1);
+    });
+
+    ImagePyramid<std::uint8_t> pyramid(board);
+    pyramid.level(pyramid.levels() - 1);
+    benchmark("pyramid resize (levels cached)", [&]() { pyramid.resize(w, h); });
+}
@@ -241,3 +241,68 @@ TEST(downsample, image_rgb_preserves_channels) {
     debug_io::dump_image(getUnitCaseDebugDir() + "00_src.png", src);
     debug_io::dump_image(getUnitCaseDebugDir() + "01_ds_2x2.png", ds);
 }
+
+TEST(downsample, area_integer_factor_averages_blocks) {
+    image32f src(6, 4, 1);
+    for (int y = 0; y < src.height(); ++y)
+        for (int x = 0; x < src.width(); ++x)
+            src(y, x) = static_cast<float>(x + 10 * y);
+
+    auto ds = downsample(src, 3, 2, DownsampleMethod::Area);
+    ASSERT_EQ(ds.width(), 3);
+    ASSERT_EQ(ds.height(), 2);
+    for (int y = 0; y < 2; ++y)
+        for (int x = 0; x < 3; ++x) {
+            const float expected = (src(2 * y, 2 * x) + src(2 * y, 2 * x + 1) + src(2 * y + 1, 2 * x) + src(2 * y + 1, 2 * x + 1)) / 4;
+            EXPECT_NEAR(ds(y, x), expected, 1e-4f);
+        }
+}
+
+TEST(downsample, area_fractional_coverage) {
+    // 3 -> 2: output pixels cover [0, 1.5) and [1.5, 3)
+    image32f src(3, 1, 1);
+    src(0, 0) = 0.0f;
+    src(0, 1) = 30.0f;
+    src(0, 2) = 90.0f;
+
+    auto ds = downsample(src, 2, 1, DownsampleMethod::Area);
+    EXPECT_NEAR(ds(0, 0), (0.0f * 1.0f + 30.0f * 0.5f) / 1.5f, 1e-4f);
+    EXPECT_NEAR(ds(0, 1), (30.0f * 0.5f + 90.0f * 1.0f) / 1.5f, 1e-4f);
+}
+
+TEST(downsample, area_preserves_mean_and_constants) {
+    image8u src(97, 61, 3);
+    for (int y = 0; y < src.height(); ++y)
+        for (int x = 0; x < src.width(); ++x)
+            for (int c = 0; c < 3; ++c)
+                src(y, x, c) = static_cast<uint8_t>(c == 0 ? 200 : ((x * 7 + y * 13) % 256));
+
+    auto ds = downsample(src, 10, 7, DownsampleMethod::Area);
+    ASSERT_EQ(ds.channels(), 3);
+
+    double srcMean = 0.0, dsMean = 0.0;
+    for (int y = 0; y < src.height(); ++y)
+        for (int x = 0; x < src.width(); ++x)
+            srcMean += src(y, x, 1);
+    srcMean /= src.width() * src.height();
+    for (int y = 0; y < ds.height(); ++y)
+        for (int x = 0; x < ds.width(); ++x) {
+            EXPECT_EQ(ds(y, x, 0), 200);
+            dsMean += ds(y, x, 1);
+        }
+    dsMean /= ds.width() * ds.height();
+    EXPECT_NEAR(dsMean, srcMean, 1.0);
+}
+
+TEST(downsample, area_removes_aliasing) {
+    // 1-pixel checkerboard: nearest keeps picking the same phase, area average gives mid-gray
+    image8u src(64, 64, 1);
+    for (int y = 0; y < src.height(); ++y)
+        for (int x = 0; x < src.width(); ++x)
+            src(y, x) = ((x + y) % 2) ? 255 : 0;
+
+    auto ds = downsample(src, 8, 8, DownsampleMethod::Area);
+    for (int y = 0; y < ds.height(); ++y)
+        for (int x = 0; x < ds.width(); ++x)
+            EXPECT_NEAR(ds(y, x), 128, 1);
+}
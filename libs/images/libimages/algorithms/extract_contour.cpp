@@ -14,9 +14,9 @@ inline bool inBounds(int x, int y, int w, int h) noexcept {
     return x >= 0 && x < w && y >= 0 && y < h;
 }
 
-inline bool isFg(const image8u& m, int x, int y) noexcept {
+inline bool isFg(ImageView<const std::uint8_t> m, int x, int y) {
     if (!inBounds(x, y, m.width(), m.height())) return false;
-    return m(y, x) == kFg;
+    return m.ptr(y)[x] == kFg;
 }
 
 // Clockwise neighbor order in image coordinates (y down):
@@ -62,65 +62,15 @@ inline void rotateToMinYX(std::vector<point2i>& pts) {
     std::rotate(pts.begin(), pts.begin() + best, pts.end());
 }
 
-} // namespace
-
-image8u buildContourMask(const image8u &objectMask) {
-    rassert(objectMask.channels() == 1, 918273645);
-
-    const int w = objectMask.width();
-    const int h = objectMask.height();
-
-    // это новая маска которую мы хотим построить, изначально она заполнена нулями (черная)
-    image8u contour(w, h, 1);
-
-    // DONE для каждого пикселя вам надо сделать следующее
-    // посмотреть на 8 соседей - по стороне и диагонали (будьте аккуратны - не выйдите за пределы картинки)
-    // если среди них только 255 - то наш пиксель внутри объекта, то есть наш пиксель - не граница
-    // если среди них только 0 - то наш пиксель снаружи объекта (фон), то есть наш пиксель - не граница
-    // а вот если среди соседей есть и те и те - то мы на границе!
-    // и в таком случае надо сохранить в нашем пикселе в contour(j, i) число 255
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
-            if (objectMask(y, x) != kFg) continue;
-
-            bool isBoundary = false;
-            for (int k = 0; k < 8; ++k) {
-                const int nx = x + dx8[k];
-                const int ny = y + dy8[k];
-                if (!inBounds(nx, ny, w, h) || objectMask(ny, nx) != kFg) {
-                    isBoundary = true;
-                    break;
-                }
-            }
-            if (isBoundary) contour(y, x) = kFg;
-        }
-    }
-
-    return contour;
-}
-
-std::vector<point2i> extractContour(const image8u &objectContourMask) {
-    rassert(objectContourMask.channels() == 1, 918273646);
-
-    const int w = objectContourMask.width();
-    const int h = objectContourMask.height();
-
-    // Find start: top-most, then left-most contour pixel.
-    point2i start{-1, -1};
-    for (int y = 0; y < h && start.x < 0; ++y) {
-        for (int x = 0; x < w; ++x) {
-            if (objectContourMask(y, x) == kFg) {
-                start = {x, y};
-                break;
-            }
-        }
-    }
-    if (start.x < 0) return {};
-
+// Moore neighbor tracing (8-connected) of the object that contains start, start must be its top-most, then left-most pixel.
+// isFg(x, y) tells if a pixel (any coordinates, also outside of the image) belongs to the object.
+// Result: clockwise loop (image coords), starting at start, without repeating it at the end.
+template <typename IsFg>
+std::vector<point2i> traceContour(point2i start, IsFg isFg, std::size_t maxPixels) {
     // Degenerate: single pixel contour.
     bool hasNeighbor = false;
     for (int k = 0; k < 8; ++k) {
-        if (isFg(objectContourMask, start.x + dx8[k], start.y + dy8[k])) {
+        if (isFg(start.x + dx8[k], start.y + dy8[k])) {
             hasNeighbor = true;
             break;
         }
@@ -142,7 +92,7 @@ std::vector<point2i> extractContour(const image8u &objectContourMask) {
             const int d = (startDir + t) & 7;
             const int nx = p.x + dx8[d];
             const int ny = p.y + dy8[d];
-            if (isFg(objectContourMask, nx, ny)) {
+            if (isFg(nx, ny)) {
                 // new backtrack is neighbor preceding d in clockwise order
                 const int prevd = (d + 7) & 7;
                 point2i newBack{p.x + dx8[prevd], p.y + dy8[prevd]};
@@ -154,7 +104,7 @@ std::vector<point2i> extractContour(const image8u &objectContourMask) {
     };
 
     std::vector<point2i> contour;
-    contour.reserve(static_cast<std::size_t>(w) * static_cast<std::size_t>(h) / 4);
+    contour.reserve(std::min<std::size_t>(maxPixels, 4096));
 
     contour.push_back(p0);
 
@@ -166,7 +116,7 @@ std::vector<point2i> extractContour(const image8u &objectContourMask) {
     point2i cur = p1;
     b = b1;
 
-    const std::size_t safetyLimit = static_cast<std::size_t>(w) * static_cast<std::size_t>(h) + 8;
+    const std::size_t safetyLimit = maxPixels + 8;
 
     while (contour.size() < safetyLimit) {
         auto [nxt, nb] = step(cur, b);
@@ -187,9 +137,135 @@ std::vector<point2i> extractContour(const image8u &objectContourMask) {
     // Deterministic start: rotate to min (y, x).
     rotateToMinYX(contour);
 
+    return contour;
+}
+
+} // namespace
+
+image8u buildContourMask(ImageView<const std::uint8_t> objectMask) {
+    rassert(objectMask.channels() == 1, 918273645);
+
+    const int w = objectMask.width();
+    const int h = objectMask.height();
+
+    // это новая маска которую мы хотим построить, изначально она заполнена нулями (черная)
+    image8u contour(w, h, 1);
+
+    // DONE для каждого пикселя вам надо сделать следующее
+    // посмотреть на 8 соседей - по стороне и диагонали (будьте аккуратны - не выйдите за пределы картинки)
+    // если среди них только 255 - то наш пиксель внутри объекта, то есть наш пиксель - не граница
+    // если среди них только 0 - то наш пиксель снаружи объекта (фон), то есть наш пиксель - не граница
+    // а вот если среди соседей есть и те и те - то мы на границе!
+    // и в таком случае надо сохранить в нашем пикселе в contour(j, i) число 255
+    for (int y = 0; y < h; ++y) {
+        // rows above/below are nullptr outside of the image - such neighbors are background
+        const unsigned char* above = (y > 0) ? objectMask.ptr(y - 1) : nullptr;
+        const unsigned char* cur = objectMask.ptr(y);
+        const unsigned char* below = (y + 1 < h) ? objectMask.ptr(y + 1) : nullptr;
+        unsigned char* out = contour.ptr(y);
+
+        for (int x = 0; x < w; ++x) {
+            if (cur[x] != kFg) continue;
+
+            bool isBoundary = !above || !below || x == 0 || x + 1 == w;
+            for (int dx = -1; dx <= 1 && !isBoundary; ++dx) {
+                isBoundary = above[x + dx] != kFg || cur[x + dx] != kFg || below[x + dx] != kFg;
+            }
+            if (isBoundary) out[x] = kFg;
+        }
+    }
+
+    return contour;
+}
+
+BitMask buildContourMask(const BitMask &objectMask) {
+    using word_type = BitMask::word_type;
+    constexpr int kBits = BitMask::kWordBits;
+
+    const int h = objectMask.height();
+    const int n = static_cast<int>(objectMask.words_per_row());
+
+    BitMask contour(objectMask.width(), h);
+    for (int y = 0; y < h; ++y) {
+        const word_type *cur = objectMask.row(y);
+        word_type *out = contour.row(y);
+        // pixels outside of the image are background, so border rows have no interior
+        if (y == 0 || y + 1 == h) {
+            std::copy(cur, cur + n, out);
+            continue;
+        }
+        const word_type *above = objectMask.row(y - 1);
+        const word_type *below = objectMask.row(y + 1);
+
+        // vertical 3x1 AND of the current and the next word, then horizontal 1x3 AND via neighbor bits
+        word_type prev = 0;
+        word_type column = above[0] & cur[0] & below[0];
+        for (int i = 0; i < n; ++i) {
+            const word_type next = (i + 1 < n) ? (above[i + 1] & cur[i + 1] & below[i + 1]) : 0;
+            const word_type left = (column << 1) | (prev >> (kBits - 1));
+            const word_type right = (column >> 1) | (next << (kBits - 1));
+            const word_type interior = column & left & right;
+            out[i] = cur[i] & ~interior;
+            prev = column;
+            column = next;
+        }
+    }
+    return contour;
+}
+
+std::vector<point2i> extractContour(ImageView<const std::uint8_t> objectContourMask) {
+    rassert(objectContourMask.channels() == 1, 918273646);
+
+    const int w = objectContourMask.width();
+    const int h = objectContourMask.height();
+
+    // Find start: top-most, then left-most contour pixel.
+    point2i start{-1, -1};
+    for (int y = 0; y < h && start.x < 0; ++y) {
+        const unsigned char* row = objectContourMask.ptr(y);
+        for (int x = 0; x < w; ++x) {
+            if (row[x] == kFg) {
+                start = {x, y};
+                break;
+            }
+        }
+    }
+    if (start.x < 0) return {};
+
+    std::vector<point2i> contour = traceContour(start, [&](int x, int y) { return isFg(objectContourMask, x, y); },
+                                                static_cast<std::size_t>(w) * static_cast<std::size_t>(h));
     for (point2i p: contour) {
         rassert(p.x >= 0 && p.x < w && p.y >= 0 && p.y < h, 2347823412);
     }
-
     return contour;
 }
+
+std::vector<std::vector<point2i>> extractContours(const ConnectedComponents &components, bool with_openmp) {
+    const std::size_t count = components.components.size();
+
+    // the first run of every label in raster order starts at its top-most, then left-most pixel
+    std::vector<point2i> starts(count, point2i{-1, -1});
+    for (const PixelRun &run : components.runs) {
+        if (starts[run.label].x < 0) starts[run.label] = {run.x_begin, run.y};
+    }
+
+    const int h = static_cast<int>(components.row_runs.size()) - 1;
+    // label of pixel (x, y) by binary search in the runs of row y (rows have few runs), -1 for background
+    auto labelAt = [&](int x, int y) -> long long {
+        if (y < 0 || y >= h) return -1;
+        const auto begin = components.runs.begin() + components.row_runs[y];
+        const auto end = components.runs.begin() + components.row_runs[y + 1];
+        const auto it = std::upper_bound(begin, end, x, [](int x, const PixelRun &run) { return x < run.x_end; });
+        return (it != end && it->x_begin <= x) ? static_cast<long long>(it->label) : -1;
+    };
+
+    std::vector<std::vector<point2i>> contours(count);
+    #pragma omp parallel for schedule(dynamic, 1) if(with_openmp)
+    for (std::ptrdiff_t k = 0; k < static_cast<std::ptrdiff_t>(count); ++k) {
+        const long long label = k;
+        const bbox2i &bbox = components.components[k].bbox;
+        contours[k] = traceContour(starts[k], [&](int x, int y) { return labelAt(x, y) == label; },
+                                   static_cast<std::size_t>(bbox.width()) * static_cast<std::size_t>(bbox.height()));
+    }
+    return contours;
+}
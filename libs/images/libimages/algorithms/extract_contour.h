@@ -1,14 +1,25 @@
 #pragma once
 
+#include <libimages/algorithms/connected_components.h>
+#include <libimages/bit_mask.h>
 #include <libimages/image.h>
+#include <libimages/image_view.h>
 #include <libbase/point2.h>
 
 #include <vector>
 
 // Input: object mask (0 = background, 255 = object).
 // Output: contour mask (0 = not contour, 255 = contour pixel).
-image8u buildContourMask(const image8u &objectMask);
+image8u buildContourMask(ImageView<const std::uint8_t> objectMask);
+// Same on bit-packed masks: contour = object & ~(object eroded by 3x3 with zero padding).
+BitMask buildContourMask(const BitMask &objectMask);
 
 // Input: contour mask (0 = background, 255 = contour pixel).
 // Output: single closed loop of contour pixels in clockwise order (image coords: x right, y down).
-std::vector<point2i> extractContour(const image8u &objectContourMask);
+std::vector<point2i> extractContour(ImageView<const std::uint8_t> objectContourMask);
+
+// Outer contours of all components at once, without contour masks: start pixels are found in one raster pass over
+// the runs, then every component is traced (in parallel) with neighbor probes answered by the runs of its rows.
+// contours[k] is the contour of components.components[k] in image coordinates (subtract bbox.min for part coordinates),
+// the same loop as extractContour(mask of that component) gives (clockwise, from top-most then left-most pixel).
+std::vector<std::vector<point2i>> extractContours(const ConnectedComponents &components, bool with_openmp = true);
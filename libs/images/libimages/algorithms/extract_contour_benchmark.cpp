@@ -0,0 +1,31 @@
+#include "extract_contour.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/algorithms/split_into_parts.h>
+#include <libimages/benchmark_utils.h>
+
+TEST(extract_contour_benchmark, buildContourMaskAndExtractContour) {
+    // one big piece, as after splitObjects on a full-resolution photo
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight, 1);
+    image8u contourMask;
+    benchmark("buildContourMask", [&]() { contourMask = buildContourMask(mask); });
+    benchmark("extractContour", [&]() { extractContour(contourMask); });
+
+    const BitMask bits = BitMask::fromImage(mask);
+    benchmark("buildContourMask bitmask", [&]() { buildContourMask(bits); });
+}
+
+TEST(extract_contour_benchmark, allObjects) {
+    const image8u board = makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight);
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight);
+    const ConnectedComponents components = findConnectedComponents(mask);
+    const auto [offsets, images, masks] = splitObjects(board, components);
+
+    benchmark("48 objects: buildContourMask + extractContour", [&]() {
+        for (const image8u &objectMask : masks)
+            extractContour(buildContourMask(objectMask));
+    });
+    benchmark("48 objects: extractContours", [&]() { extractContours(components); });
+    benchmark("48 objects: extractContours single thread", [&]() { extractContours(components, false); });
+}
@@ -5,6 +5,7 @@
 #include <libbase/configure_working_directory.h>
 #include <libimages/debug_io.h>
 #include <libimages/tests_utils.h>
+#include <libimages/algorithms/morphology.h>
 
 #include <algorithm>
 #include <cstdint>
@@ -163,3 +164,46 @@ TEST(extract_contour, singlePixel) {
     ASSERT_EQ(contour.size(), 1u);
     EXPECT_EQ(contour[0], (point2i{4, 3}));
 }
+
+TEST(extract_contour, buildContourMask_bitMaskMatchesImage) {
+    std::uint32_t seed = 239;
+    for (auto [w, h] : std::vector<std::pair<int, int>>{{1, 1}, {2, 2}, {64, 3}, {65, 40}, {150, 90}}) {
+        const image8u obj = morphology::dilate(makeRandomMask(w, h, 3, seed++), 1);
+        const BitMask contour = buildContourMask(BitMask::fromImage(obj));
+        EXPECT_EQ(contour.toImage().toVector(), buildContourMask(obj).toVector()) << w << "x" << h;
+        EXPECT_EQ(contour.count(), static_cast<std::size_t>(count255(buildContourMask(obj))));
+    }
+}
+
+TEST(extract_contour, extractContoursMatchesPerObjectPath) {
+    std::uint32_t seed = 7;
+    for (auto [w, h] : std::vector<std::pair<int, int>>{{1, 1}, {3, 70}, {65, 40}, {150, 140}}) {
+        image8u objects = makeRandomMask(w, h, 8, seed++);
+        // single pixels, diagonal-only links and one-pixel-wide lines
+        std::uint32_t state = seed;
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x) {
+                state = state * 1664525u + 1013904223u;
+                if ((state >> 27) == 0) objects(y, x) = kFg;
+            }
+
+        const ConnectedComponents components = findConnectedComponents(objects);
+        const std::vector<std::vector<point2i>> contours = extractContours(components);
+        ASSERT_EQ(contours.size(), components.components.size());
+
+        for (std::size_t k = 0; k < contours.size(); ++k) {
+            // the old path: mask of the object in its bbox -> contour mask -> tracing
+            const bbox2i &bbox = components.components[k].bbox;
+            image8u mask(bbox.width(), bbox.height(), 1);
+            for (const PixelRun &run : components.runs)
+                if (run.label == k)
+                    for (int x = run.x_begin; x < run.x_end; ++x)
+                        mask(run.y - bbox.min.y, x - bbox.min.x) = kFg;
+            const std::vector<point2i> expected = extractContour(buildContourMask(mask));
+
+            ASSERT_EQ(contours[k].size(), expected.size()) << w << "x" << h << " object " << k;
+            for (std::size_t i = 0; i < expected.size(); ++i)
+                ASSERT_EQ(contours[k][i], expected[i] + bbox.min);
+        }
+    }
+}
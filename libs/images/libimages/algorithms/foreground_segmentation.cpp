@@ -0,0 +1,97 @@
+#include "foreground_segmentation.h"
+
+#include <libbase/runtime_assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+template <int C>
+inline std::uint8_t luma_at(const std::uint8_t *p) {
+    if constexpr (C == 1) {
+        return p[0];
+    } else {
+        return luma8u(p[0], p[1], p[2]);
+    }
+}
+
+template <int C>
+void add_border_pixels(const image8u &image, stats::Histogram &histogram) {
+    const int w = image.width();
+    const int h = image.height();
+    for (int j : {0, h - 1}) {
+        const std::uint8_t *src = image.ptr(j);
+        for (int i = 0; i < w; ++i)
+            histogram.add(luma_at<C>(src + i * C));
+        if (h == 1)
+            break;
+    }
+    for (int j = 1; j < h - 1; ++j) {
+        const std::uint8_t *src = image.ptr(j);
+        histogram.add(luma_at<C>(src));
+        if (w > 1)
+            histogram.add(luma_at<C>(src + (w - 1) * C));
+    }
+}
+
+// luma >= threshold <=> luma >= ceil(threshold), so the whole pass is in integers
+template <int C>
+void threshold_luma(const image8u &image, int threshold, BitMask &mask, image8u *luma, bool with_openmp) {
+    const int w = image.width();
+    const int h = image.height();
+    #pragma omp parallel for schedule(static) if(with_openmp)
+    for (int j = 0; j < h; ++j) {
+        const std::uint8_t *src = image.ptr(j);
+        std::uint8_t *dst_luma = luma ? luma->ptr(j) : nullptr;
+        BitMask::word_type *dst = mask.row(j);
+        for (int x0 = 0; x0 < w; x0 += BitMask::kWordBits) {
+            const int n = std::min(BitMask::kWordBits, w - x0);
+            BitMask::word_type word = 0;
+            for (int b = 0; b < n; ++b) {
+                const std::uint8_t v = luma_at<C>(src + (x0 + b) * C);
+                if (dst_luma)
+                    dst_luma[x0 + b] = v;
+                word |= BitMask::word_type(v >= threshold) << b;
+            }
+            dst[x0 / BitMask::kWordBits] = word;
+        }
+    }
+}
+
+template <int C>
+void segment(const image8u &image, const ForegroundParams &params, bool with_openmp, ForegroundSegmentation &result) {
+    add_border_pixels<C>(image, result.border_histogram);
+    result.background_level = result.border_histogram.percentile(params.border_percentile);
+    result.threshold = params.threshold_scale * result.background_level;
+
+    // thresholds above 255 mark nothing, negative ones mark everything
+    const int threshold = static_cast<int>(std::clamp(std::ceil(result.threshold), 0.0, 256.0));
+    image8u *luma = nullptr;
+    if (params.keep_luma) {
+        result.luma = image8u(image.width(), image.height(), 1, ImageInit::Uninitialized);
+        luma = &result.luma;
+    }
+    threshold_luma<C>(image, threshold, result.mask, luma, with_openmp);
+}
+
+} // namespace
+
+ForegroundSegmentation segmentForeground(const image8u &image, const ForegroundParams &params, bool with_openmp) {
+    const int c = image.channels();
+    rassert(c == 1 || c == 3 || c == 4, 7645120931, c);
+    rassert(image.width() > 0 && image.height() > 0, 7645120932, image.width(), image.height());
+
+    ForegroundSegmentation result;
+    result.mask = BitMask(image.width(), image.height());
+    if (c == 1) {
+        segment<1>(image, params, with_openmp, result);
+    } else if (c == 3) {
+        segment<3>(image, params, with_openmp, result);
+    } else {
+        segment<4>(image, params, with_openmp, result);
+    }
+    return result;
+}
+
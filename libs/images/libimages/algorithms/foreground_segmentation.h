@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#include <libbase/histogram.h>
+#include <libimages/bit_mask.h>
+#include <libimages/image.h>
+
+// Fixed-point luma: 0.299 R + 0.587 G + 0.114 B with 16-bit weights, rounded to the nearest integer
+inline std::uint8_t luma8u(std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+    return static_cast<std::uint8_t>((19595u * r + 38470u * g + 7471u * b + 32768u) >> 16);
+}
+
+struct ForegroundParams {
+    // background level is this percentile of luma on the image border (the border is expected to be background)
+    double border_percentile = 90.0;
+    // pixels with luma >= threshold_scale * background level are foreground
+    double threshold_scale = 1.5;
+    // keep the luma image in ForegroundSegmentation::luma (for debug dumps only)
+    bool keep_luma = false;
+};
+
+struct ForegroundSegmentation {
+    BitMask mask;                    // true = foreground
+    stats::Histogram border_histogram; // luma histogram of border pixels (2w + 2h - 4 of them)
+    double background_level = 0.0;   // border_percentile of border luma
+    double threshold = 0.0;          // threshold_scale * background_level
+    image8u luma;                    // empty unless ForegroundParams::keep_luma
+};
+
+// Fused RGB -> luma -> border statistics -> threshold -> bit mask. Reads the border pixels once and then every pixel
+// once (luma is computed on the fly and thresholded in the same pass), doesn't allocate any full-size float image.
+// Mask is equal to threshold_bitmask(luma, threshold). image must have 1, 3 or 4 channels (4th is ignored).
+// Luma is rounded to 8 bits, so the background level and the mask differ slightly from the ones of a float grayscale image
+// (on data/00_photo_six_parts_downscaled_x4.jpg the threshold is 96 instead of 95.82).
+ForegroundSegmentation segmentForeground(const image8u &image, const ForegroundParams &params = {},
+                                         bool with_openmp = true);
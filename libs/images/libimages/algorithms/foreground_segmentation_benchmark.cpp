@@ -0,0 +1,28 @@
+#include "foreground_segmentation.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/stats.h>
+#include <libimages/algorithms/grayscale.h>
+#include <libimages/algorithms/threshold_masking.h>
+#include <libimages/benchmark_utils.h>
+
+#include <vector>
+
+TEST(foreground_segmentation_benchmark, fusedVsThreePasses) {
+    const image8u board = makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight);
+    const int w = board.width();
+    const int h = board.height();
+
+    benchmark("grayscale + border percentile + threshold", [&]() {
+        image32f gray = to_grayscale_float(board);
+        std::vector<float> border;
+        for (int j = 0; j < h; ++j)
+            for (int i = 0; i < w; ++i)
+                if (i == 0 || i == w - 1 || j == 0 || j == h - 1)
+                    border.push_back(gray(j, i));
+        threshold_bitmask(gray, static_cast<float>(1.5 * stats::percentile(border, 90)));
+    });
+    benchmark("segmentForeground", [&]() { segmentForeground(board); });
+    benchmark("segmentForeground single thread", [&]() { segmentForeground(board, {}, false); });
+}
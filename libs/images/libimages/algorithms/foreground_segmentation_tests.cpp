@@ -0,0 +1,87 @@
+#include "foreground_segmentation.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/stats.h>
+#include <libimages/algorithms/threshold_masking.h>
+#include <libimages/tests_utils.h>
+
+#include <libbase/fast_random.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+image8u makeNoisyPieces(int w, int h, int c, std::uint32_t seed) {
+    FastRandom r(seed);
+    image8u img(w, h, c);
+    const image8u mask = makeRandomMask(w, h, 4, seed);
+    for (int j = 0; j < h; ++j)
+        for (int i = 0; i < w; ++i)
+            for (int k = 0; k < c; ++k)
+                img(j, i, k) = static_cast<std::uint8_t>(mask(j, i) ? r.nextInt(120, 255) : r.nextInt(0, 50));
+    return img;
+}
+
+// the unfused pipeline: luma image, border values, stats::percentile, threshold_bitmask
+BitMask referenceMask(const image8u &img, double &threshold) {
+    const int w = img.width();
+    const int h = img.height();
+    image32f luma(w, h, 1);
+    for (int j = 0; j < h; ++j)
+        for (int i = 0; i < w; ++i)
+            luma(j, i) = img.channels() == 1 ? img(j, i) : luma8u(img(j, i, 0), img(j, i, 1), img(j, i, 2));
+
+    std::vector<float> border;
+    for (int j = 0; j < h; ++j)
+        for (int i = 0; i < w; ++i)
+            if (i == 0 || i == w - 1 || j == 0 || j == h - 1)
+                border.push_back(luma(j, i));
+    threshold = 1.5 * stats::percentile(border, 90);
+    return threshold_bitmask(luma, static_cast<float>(threshold));
+}
+
+} // namespace
+
+TEST(foreground_segmentation, matchesUnfusedPipeline) {
+    for (int c : {1, 3, 4}) {
+        for (int w : {1, 2, 63, 130}) {
+            const int h = 1 + (w * 7) % 41;
+            const image8u img = makeNoisyPieces(w, h, c, 239 + w + c);
+
+            double threshold = 0.0;
+            const BitMask expected = referenceMask(img, threshold);
+            const ForegroundSegmentation seg = segmentForeground(img);
+            EXPECT_DOUBLE_EQ(seg.threshold, threshold);
+            EXPECT_TRUE(seg.mask == expected) << "c=" << c << " w=" << w;
+            EXPECT_TRUE(seg.luma.data() == nullptr);
+
+            EXPECT_EQ(seg.border_histogram.count(), static_cast<std::uint64_t>(w == 1 || h == 1 ? w * h : 2 * w + 2 * h - 4));
+        }
+    }
+}
+
+TEST(foreground_segmentation, keepsLumaOnRequest) {
+    const image8u img = makeNoisyPieces(70, 20, 3, 7);
+    ForegroundParams params;
+    params.keep_luma = true;
+    const ForegroundSegmentation seg = segmentForeground(img, params, false);
+    ASSERT_EQ(seg.luma.width(), 70);
+    ASSERT_EQ(seg.luma.height(), 20);
+    for (int j = 0; j < 20; ++j)
+        for (int i = 0; i < 70; ++i) {
+            EXPECT_EQ(seg.luma(j, i), luma8u(img(j, i, 0), img(j, i, 1), img(j, i, 2)));
+            EXPECT_EQ(seg.mask.get(j, i), seg.luma(j, i) >= seg.threshold);
+        }
+}
+
+TEST(foreground_segmentation, lumaIsRoundedFloatLuma) {
+    for (int r = 0; r < 256; r += 5)
+        for (int g = 0; g < 256; g += 3)
+            for (int b = 0; b < 256; b += 7) {
+                const double expected = 0.299 * r + 0.587 * g + 0.114 * b;
+                EXPECT_LE(std::abs(luma8u(r, g, b) - expected), 0.51);
+            }
+}
@@ -5,21 +5,27 @@
 image32f to_grayscale_float(const image8u& img) {
     rassert(img.channels() == 1 || img.channels() == 3 || img.channels() == 4, "Unsupported channel count", img.channels());
 
-    image32f gray(img.width(), img.height(), 1);
+    image32f gray(img.width(), img.height(), 1, ImageInit::Uninitialized);
 
     if (img.channels() == 1) {
-        for (int j = 0; j < img.height(); ++j)
+        for (int j = 0; j < img.height(); ++j) {
+            const std::uint8_t *src = img.ptr(j);
+            float *dst = gray.ptr(j);
             for (int i = 0; i < img.width(); ++i)
-                gray(j, i) = (float) img(j, i);
+                dst[i] = (float) src[i];
+        }
         return gray;
     }
 
+    const int c = img.channels();
     for (int j = 0; j < img.height(); ++j) {
+        const std::uint8_t *src = img.ptr(j);
+        float *dst = gray.ptr(j);
         for (int i = 0; i < img.width(); ++i) {
-            const float r = (float) img(j, i, 0);
-            const float g = (float) img(j, i, 1);
-            const float b = (float) img(j, i, 2);
-            gray(j, i) = 0.299f * r + 0.587f * g + 0.114f * b;
+            const float r = (float) src[i * c + 0];
+            const float g = (float) src[i * c + 1];
+            const float b = (float) src[i * c + 2];
+            dst[i] = 0.299f * r + 0.587f * g + 0.114f * b;
         }
     }
     return gray;
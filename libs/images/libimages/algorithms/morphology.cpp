@@ -1,6 +1,9 @@
 #include "morphology.h"
 
 #include <algorithm>
+#include <span>
+#include <type_traits>
+#include <vector>
 
 #include <libbase/runtime_assert.h>
 
@@ -9,68 +12,196 @@ namespace morphology {
 static void check_binary_01_255(const image8u& src) {
     rassert(src.channels() == 1, "morphology expects 1-channel image", src.channels());
     for (int j = 0; j < src.height(); ++j) {
+        const std::uint8_t* row = src.ptr(j);
         for (int i = 0; i < src.width(); ++i) {
-            const std::uint8_t v = src(j, i);
+            const std::uint8_t v = row[i];
             rassert(v == 0 || v == 255, "morphology expects binary pixels {0,255}", int(v), j, i);
         }
     }
 }
 
-image8u erode(const image8u& src, int strength, bool with_openmp) {
+// van Herk/Gil-Werman running min (erode) / max (dilate) over windows of k = 2r+1 elements.
+// Line is zero-padded by r on both sides (that is exactly the border semantics of naive erode/dilate:
+// zero padding makes erosion 0 near the border and doesn't affect dilation), padded line is cut into blocks of k,
+// window starting at padded x covers suffix of its block and prefix of the next block:
+//   out[x] = op(suffix[x], prefix[x + k - 1])
+struct MinOp {
+    static std::uint8_t apply(std::uint8_t a, std::uint8_t b) { return std::min(a, b); }
+};
+struct MaxOp {
+    static std::uint8_t apply(std::uint8_t a, std::uint8_t b) { return std::max(a, b); }
+};
+
+template <typename Op>
+static void van_herk_rows(const image8u& src, image8u& dst, int r, bool with_openmp) {
+    const int w = src.width();
+    const int h = src.height();
+    const int k = 2 * r + 1;
+    const int blocks = (w + k - 1) / k;
+    // one more block so that prefix of the block after the last one is readable
+    const size_t padded_len = static_cast<size_t>(blocks + 1) * k;
+
+    #pragma omp parallel if(with_openmp)
+    {
+        std::vector<std::uint8_t> padded(padded_len, 0);
+        std::vector<std::uint8_t> suffix(k);
+
+        #pragma omp for
+        for (int j = 0; j < h; ++j) {
+            const std::uint8_t* in = src.ptr(j);
+            std::uint8_t* out = dst.ptr(j);
+            std::copy(in, in + w, padded.begin() + r);
+
+            for (int b = 0; b < blocks; ++b) {
+                const std::uint8_t* block = padded.data() + static_cast<size_t>(b) * k;
+                suffix[k - 1] = block[k - 1];
+                for (int t = k - 2; t >= 0; --t)
+                    suffix[t] = Op::apply(block[t], suffix[t + 1]);
+
+                // window starting at t covers suffix[t] and next[0..t-1]
+                const std::uint8_t* next = block + k;
+                const int n = std::min(k, w - b * k);
+                out[b * k] = suffix[0];
+                std::uint8_t prefix = 0;
+                for (int t = 1; t < n; ++t) {
+                    prefix = (t == 1) ? next[0] : Op::apply(prefix, next[t - 1]);
+                    out[b * k + t] = Op::apply(suffix[t], prefix);
+                }
+            }
+        }
+    }
+}
+
+template <typename Op>
+static void van_herk_columns(const image8u& src, image8u& dst, int r, bool with_openmp) {
+    // same as van_herk_rows but along columns, whole rows are combined at once (vectorizes well)
+    const int w = src.width();
+    const int h = src.height();
+    const int k = 2 * r + 1;
+    const int blocks = (h + k - 1) / k;
+    const std::vector<std::uint8_t> zeros(w, 0);
+
+    auto padded_row = [&](int p) -> const std::uint8_t* {
+        const int y = p - r;
+        return (y >= 0 && y < h) ? src.ptr(y) : zeros.data();
+    };
+
+    #pragma omp parallel if(with_openmp)
+    {
+        std::vector<std::uint8_t> suffix(static_cast<size_t>(k) * w);
+        std::vector<std::uint8_t> prefix(w);
+
+        #pragma omp for
+        for (int b = 0; b < blocks; ++b) {
+            const int p0 = b * k;
+            std::copy(padded_row(p0 + k - 1), padded_row(p0 + k - 1) + w, suffix.begin() + static_cast<size_t>(k - 1) * w);
+            for (int t = k - 2; t >= 0; --t) {
+                const std::uint8_t* row = padded_row(p0 + t);
+                const std::uint8_t* below = suffix.data() + static_cast<size_t>(t + 1) * w;
+                std::uint8_t* cur = suffix.data() + static_cast<size_t>(t) * w;
+                for (int i = 0; i < w; ++i)
+                    cur[i] = Op::apply(row[i], below[i]);
+            }
+
+            // window [p0 + t, p0 + t + k - 1] = suffix of this block from t + first t rows of the next block
+            const int n = std::min(k, h - p0);
+            std::copy(suffix.begin(), suffix.begin() + w, dst.ptr(p0));
+            for (int t = 1; t < n; ++t) {
+                const std::uint8_t* row = padded_row(p0 + k + t - 1);
+                if (t == 1) {
+                    std::copy(row, row + w, prefix.begin());
+                } else {
+                    for (int i = 0; i < w; ++i)
+                        prefix[i] = Op::apply(prefix[i], row[i]);
+                }
+                const std::uint8_t* cur = suffix.data() + static_cast<size_t>(t) * w;
+                std::uint8_t* out = dst.ptr(p0 + t);
+                for (int i = 0; i < w; ++i)
+                    out[i] = Op::apply(cur[i], prefix[i]);
+            }
+        }
+    }
+}
+
+// tmp and dst are preallocated images of the same size as src (so that sequence() can reuse them)
+template <typename Op>
+static void van_herk(const image8u& src, image8u& tmp, image8u& dst, int r, bool with_openmp) {
+    van_herk_rows<Op>(src, tmp, r, with_openmp);
+    van_herk_columns<Op>(tmp, dst, r, with_openmp);
+}
+
+template <typename Op>
+static image8u van_herk(const image8u& src, int r, bool with_openmp) {
+    image8u tmp(src.width(), src.height(), 1, ImageInit::Uninitialized);
+    image8u dst(src.width(), src.height(), 1, ImageInit::Uninitialized);
+    van_herk<Op>(src, tmp, dst, r, with_openmp);
+    return dst;
+}
+
+image8u erode(const image8u& src, int strength, bool with_openmp, Method method) {
     rassert(strength >= 0, "erode: strength must be >= 0", strength);
     check_binary_01_255(src);
 
     const int w = src.width();
     const int h = src.height();
 
-    image8u dst(w, h, 1);
-
     if (strength == 0) {
-        dst = src;
-        return dst;
+        return src;
+    }
+
+    if (method == Method::VanHerk) {
+        return van_herk<MinOp>(src, strength, with_openmp);
     }
 
+    image8u dst(w, h, 1, ImageInit::Uninitialized);
+
     #pragma omp parallel for if(with_openmp)
     for (int j = 0; j < h; ++j) {
+        std::uint8_t* out = dst.ptr(j);
         for (int i = 0; i < w; ++i) {
             // Zero padding: if the neighborhood goes outside, erosion must be 0.
             if (j - strength < 0 || j + strength >= h || i - strength < 0 || i + strength >= w) {
-                dst(j, i) = 0;
+                out[i] = 0;
                 continue;
             }
 
             bool all_on = true;
             for (int y = j - strength; y <= j + strength && all_on; ++y) {
+                const std::uint8_t* row = src.ptr(y);
                 for (int x = i - strength; x <= i + strength; ++x) {
-                    if (src(y, x) == 0) {
+                    if (row[x] == 0) {
                         all_on = false;
                         break;
                     }
                 }
             }
-            dst(j, i) = all_on ? 255 : 0;
+            out[i] = all_on ? 255 : 0;
         }
     }
 
     return dst;
 }
 
-image8u dilate(const image8u& src, int strength, bool with_openmp) {
+image8u dilate(const image8u& src, int strength, bool with_openmp, Method method) {
     rassert(strength >= 0, "dilate: strength must be >= 0", strength);
     check_binary_01_255(src);
 
     const int w = src.width();
     const int h = src.height();
 
-    image8u dst(w, h, 1);
-
     if (strength == 0) {
-        dst = src;
-        return dst;
+        return src;
+    }
+
+    if (method == Method::VanHerk) {
+        return van_herk<MaxOp>(src, strength, with_openmp);
     }
 
+    image8u dst(w, h, 1, ImageInit::Uninitialized);
+
     #pragma omp parallel for if(with_openmp)
     for (int j = 0; j < h; ++j) {
+        std::uint8_t* out = dst.ptr(j);
         for (int i = 0; i < w; ++i) {
             const int y0 = std::max(0, j - strength);
             const int y1 = std::min(h - 1, j + strength);
@@ -79,18 +210,209 @@ image8u dilate(const image8u& src, int strength, bool with_openmp) {
 
             bool any_on = false;
             for (int y = y0; y <= y1 && !any_on; ++y) {
+                const std::uint8_t* row = src.ptr(y);
                 for (int x = x0; x <= x1; ++x) {
-                    if (src(y, x) == 255) {
+                    if (row[x] == 255) {
                         any_on = true;
                         break;
                     }
                 }
             }
-            dst(j, i) = any_on ? 255 : 0;
+            out[i] = any_on ? 255 : 0;
+        }
+    }
+
+    return dst;
+}
+
+// Bit-packed rows: pixel x is bit x % 64 of word x / 64, bits outside of the row are zero.
+using word_type = BitMask::word_type;
+constexpr int kWordBits = BitMask::kWordBits;
+
+// dst pixel x = src pixel (x + s), zeros are shifted in from the right
+static void shift_row_to_left(const word_type* src, word_type* dst, int n, int s) {
+    const int q = s / kWordBits;
+    const int r = s % kWordBits;
+    for (int i = 0; i < n; ++i) {
+        const word_type lo = (i + q < n) ? src[i + q] : 0;
+        const word_type hi = (i + q + 1 < n) ? src[i + q + 1] : 0;
+        dst[i] = (r == 0) ? lo : ((lo >> r) | (hi << (kWordBits - r)));
+    }
+}
+
+// dst pixel x = src pixel (x - s), zeros are shifted in from the left
+static void shift_row_to_right(const word_type* src, word_type* dst, int n, int s) {
+    const int q = s / kWordBits;
+    const int r = s % kWordBits;
+    for (int i = 0; i < n; ++i) {
+        const word_type lo = (i - q >= 0) ? src[i - q] : 0;
+        const word_type below = (i - q - 1 >= 0) ? src[i - q - 1] : 0;
+        dst[i] = (r == 0) ? lo : ((lo << r) | (below >> (kWordBits - r)));
+    }
+}
+
+struct AndOp {
+    static word_type apply(word_type a, word_type b) { return a & b; }
+};
+struct OrOp {
+    static word_type apply(word_type a, word_type b) { return a | b; }
+};
+
+// AND (erode) or OR (dilate) over square window with zero padding:
+// horizontally [x - r, x] and [x, x + r] windows are built from O(log r) shifted copies of the row (doubling window
+// length), vertically whole rows of words are combined.
+template <typename Op>
+static void bit_morphology(const BitMask& src, BitMask& tmp, BitMask& dst, int r, bool with_openmp) {
+    const int h = src.height();
+    const int n = static_cast<int>(src.words_per_row());
+    const word_type tail = src.last_word_mask();
+
+    #pragma omp parallel if(with_openmp)
+    {
+        std::vector<word_type> right(n);
+        std::vector<word_type> left(n);
+        std::vector<word_type> shifted(n);
+
+        #pragma omp for
+        for (int j = 0; j < h; ++j) {
+            // right[x] = op of pixels [x, x + len), left[x] = op of pixels (x - len, x]
+            std::copy(src.row(j), src.row(j) + n, right.begin());
+            std::copy(src.row(j), src.row(j) + n, left.begin());
+            int len = 1;
+            while (len < r + 1) {
+                const int step = std::min(len, r + 1 - len);
+                shift_row_to_left(right.data(), shifted.data(), n, step);
+                for (int i = 0; i < n; ++i)
+                    right[i] = Op::apply(right[i], shifted[i]);
+                shift_row_to_right(left.data(), shifted.data(), n, step);
+                for (int i = 0; i < n; ++i)
+                    left[i] = Op::apply(left[i], shifted[i]);
+                len += step;
+            }
+            word_type* out = tmp.row(j);
+            for (int i = 0; i < n; ++i)
+                out[i] = Op::apply(left[i], right[i]);
+            out[n - 1] &= tail;
         }
     }
 
+    const bool is_erode = std::is_same_v<Op, AndOp>;
+    #pragma omp parallel for if(with_openmp)
+    for (int j = 0; j < h; ++j) {
+        word_type* out = dst.row(j);
+        if (is_erode && (j - r < 0 || j + r >= h)) {
+            // window touches zero padding
+            std::fill(out, out + n, 0);
+            continue;
+        }
+        const int y0 = std::max(0, j - r);
+        const int y1 = std::min(h - 1, j + r);
+        std::copy(tmp.row(y0), tmp.row(y0) + n, out);
+        for (int y = y0 + 1; y <= y1; ++y) {
+            const word_type* row = tmp.row(y);
+            for (int i = 0; i < n; ++i)
+                out[i] = Op::apply(out[i], row[i]);
+        }
+    }
+}
+
+template <typename Op>
+static BitMask bit_morphology(const BitMask& src, int r, bool with_openmp) {
+    BitMask tmp(src.width(), src.height());
+    BitMask dst(src.width(), src.height());
+    bit_morphology<Op>(src, tmp, dst, r, with_openmp);
     return dst;
 }
 
+BitMask erode(const BitMask& src, int strength, bool with_openmp) {
+    rassert(strength >= 0, "erode: strength must be >= 0", strength);
+    if (strength == 0) {
+        return src;
+    }
+    return bit_morphology<AndOp>(src, strength, with_openmp);
+}
+
+BitMask dilate(const BitMask& src, int strength, bool with_openmp) {
+    rassert(strength >= 0, "dilate: strength must be >= 0", strength);
+    if (strength == 0) {
+        return src;
+    }
+    return bit_morphology<OrOp>(src, strength, with_openmp);
+}
+
+// Steps are applied alternately from one buffer to the other (first step reads src itself),
+// so a chain of any length allocates only three masks.
+template <typename Mask, typename MakeMask, typename ApplyStep>
+static Mask run_sequence(const Mask& src, std::span<const Step> steps, MakeMask make_mask, ApplyStep apply_step) {
+    for (const Step& step : steps) {
+        rassert(step.strength >= 0, "morphology: strength must be >= 0", step.strength);
+    }
+
+    Mask buffers[2];
+    Mask tmp;
+    const Mask* from = &src;
+    int next = 0;
+    for (const Step& step : steps) {
+        if (step.strength == 0) {
+            continue;
+        }
+        if (buffers[next].width() == 0) {
+            buffers[next] = make_mask();
+        }
+        if (tmp.width() == 0) {
+            tmp = make_mask();
+        }
+        apply_step(step, *from, tmp, buffers[next]);
+        from = &buffers[next];
+        next = 1 - next;
+    }
+    if (from == &src) {
+        return src;
+    }
+    return std::move(buffers[1 - next]);
+}
+
+image8u sequence(const image8u& src, std::span<const Step> steps, bool with_openmp) {
+    check_binary_01_255(src);
+    auto make_mask = [&]() { return image8u(src.width(), src.height(), 1, ImageInit::Uninitialized); };
+    return run_sequence(src, steps, make_mask, [&](const Step& step, const image8u& from, image8u& tmp, image8u& to) {
+        if (step.operation == Operation::Erode) {
+            van_herk<MinOp>(from, tmp, to, step.strength, with_openmp);
+        } else {
+            van_herk<MaxOp>(from, tmp, to, step.strength, with_openmp);
+        }
+    });
+}
+
+BitMask sequence(const BitMask& src, std::span<const Step> steps, bool with_openmp) {
+    auto make_mask = [&]() { return BitMask(src.width(), src.height()); };
+    return run_sequence(src, steps, make_mask, [&](const Step& step, const BitMask& from, BitMask& tmp, BitMask& to) {
+        if (step.operation == Operation::Erode) {
+            bit_morphology<AndOp>(from, tmp, to, step.strength, with_openmp);
+        } else {
+            bit_morphology<OrOp>(from, tmp, to, step.strength, with_openmp);
+        }
+    });
+}
+
+image8u close(const image8u& src, int strength, bool with_openmp) {
+    const Step steps[] = {{Operation::Dilate, strength}, {Operation::Erode, strength}};
+    return sequence(src, steps, with_openmp);
+}
+
+image8u open(const image8u& src, int strength, bool with_openmp) {
+    const Step steps[] = {{Operation::Erode, strength}, {Operation::Dilate, strength}};
+    return sequence(src, steps, with_openmp);
+}
+
+BitMask close(const BitMask& src, int strength, bool with_openmp) {
+    const Step steps[] = {{Operation::Dilate, strength}, {Operation::Erode, strength}};
+    return sequence(src, steps, with_openmp);
+}
+
+BitMask open(const BitMask& src, int strength, bool with_openmp) {
+    const Step steps[] = {{Operation::Erode, strength}, {Operation::Dilate, strength}};
+    return sequence(src, steps, with_openmp);
+}
+
 } // namespace morphology
\ No newline at end of file
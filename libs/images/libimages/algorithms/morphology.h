@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 
+#include <libimages/bit_mask.h>
 #include <libimages/image.h>
 
 namespace morphology {
@@ -11,8 +13,39 @@ namespace morphology {
     // Border handling: zero-padding outside the image.
     //
     // strength == 0 -> returns a copy.
+    //
+    // Both methods give bit-identical results:
+    // Naive   - scans full (2r+1)^2 window per pixel, O(r^2) per pixel
+    // VanHerk - separable row+column running min/max (van Herk/Gil-Werman), O(1) per pixel for any strength
+
+    enum class Method { Naive, VanHerk };
+
+    image8u erode(const image8u& src, int strength, bool with_openmp=true, Method method=Method::VanHerk);
+    image8u dilate(const image8u& src, int strength, bool with_openmp=true, Method method=Method::VanHerk);
+
+    // Same operations on bit-packed masks (same results as on image8u), 64 pixels are processed per word operation.
+    BitMask erode(const BitMask& src, int strength, bool with_openmp=true);
+    BitMask dilate(const BitMask& src, int strength, bool with_openmp=true);
+
+    // Chains of operations: binarity of the input is validated once, all steps run in two ping-pong buffers
+    // (plus one scratch buffer) instead of allocating a new image per step. Same results as calling steps one by one.
+    //   const morphology::Step steps[] = {{Operation::Dilate, 3}, {Operation::Erode, 6}, {Operation::Dilate, 3}};
+    //   image8u cleaned = morphology::sequence(mask, steps);
+
+    enum class Operation { Erode, Dilate };
+
+    struct Step {
+        Operation operation;
+        int strength;
+    };
+
+    image8u sequence(const image8u& src, std::span<const Step> steps, bool with_openmp=true);
+    BitMask sequence(const BitMask& src, std::span<const Step> steps, bool with_openmp=true);
 
-    image8u erode(const image8u& src, int strength, bool with_openmp=true);
-    image8u dilate(const image8u& src, int strength, bool with_openmp=true);
+    // close = dilate then erode (fills small holes), open = erode then dilate (removes small specks)
+    image8u close(const image8u& src, int strength, bool with_openmp=true);
+    image8u open(const image8u& src, int strength, bool with_openmp=true);
+    BitMask close(const BitMask& src, int strength, bool with_openmp=true);
+    BitMask open(const BitMask& src, int strength, bool with_openmp=true);
 
 } // namespace morphology
\ No newline at end of file
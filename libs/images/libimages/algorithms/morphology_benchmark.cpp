@@ -0,0 +1,53 @@
+#include "morphology.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/benchmark_utils.h>
+
+TEST(morphology_benchmark, erodeDilate) {
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight);
+    using morphology::Method;
+    for (int strength : {1, 3, 10, 20}) {
+        for (Method method : {Method::Naive, Method::VanHerk}) {
+            const std::string suffix =
+                " strength=" + std::to_string(strength) + (method == Method::Naive ? " naive" : " van Herk");
+            benchmark("erode" + suffix, [&]() { morphology::erode(mask, strength, true, method); });
+            benchmark("dilate" + suffix, [&]() { morphology::dilate(mask, strength, true, method); });
+        }
+    }
+}
+
+TEST(morphology_benchmark, erodeDilateBitMask) {
+    const BitMask mask = BitMask::fromImage(makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight));
+    for (int strength : {1, 3, 10, 20}) {
+        benchmark("erode bitmask strength=" + std::to_string(strength), [&]() { morphology::erode(mask, strength); });
+        benchmark("dilate bitmask strength=" + std::to_string(strength), [&]() { morphology::dilate(mask, strength); });
+    }
+}
+
+TEST(morphology_benchmark, closeThenOpen) {
+    // the chain from main.cpp: dilate -> erode -> erode -> dilate
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight);
+    const BitMask bits = BitMask::fromImage(mask);
+    const int strength = 3;
+    using morphology::Operation;
+    const morphology::Step steps[] = {{Operation::Dilate, strength},
+                                      {Operation::Erode, strength},
+                                      {Operation::Erode, strength},
+                                      {Operation::Dilate, strength}};
+
+    benchmark("four calls", [&]() {
+        image8u a = morphology::dilate(mask, strength);
+        image8u b = morphology::erode(a, strength);
+        image8u c = morphology::erode(b, strength);
+        morphology::dilate(c, strength);
+    });
+    benchmark("sequence", [&]() { morphology::sequence(mask, steps); });
+    benchmark("four calls bitmask", [&]() {
+        BitMask a = morphology::dilate(bits, strength);
+        BitMask b = morphology::erode(a, strength);
+        BitMask c = morphology::erode(b, strength);
+        morphology::dilate(c, strength);
+    });
+    benchmark("sequence bitmask", [&]() { morphology::sequence(bits, steps); });
+}
@@ -100,6 +100,94 @@ TEST(morphology, StrengthZero_IsCopy) {
     EXPECT_EQ(di0(7, 7), in(7, 7));
 }
 
+TEST(morphology, VanHerkMatchesNaive) {
+    const std::vector<std::pair<int, int>> sizes = {{1, 1}, {1, 17}, {23, 1}, {7, 5}, {64, 48}, {101, 37}};
+    uint32_t seed = 239;
+    for (auto [w, h] : sizes) {
+        const image8u in = makeRandomMask(w, h, 4, seed++);
+        // strength larger than the image checks that whole window is outside
+        for (int strength : {1, 2, 3, 5, 10, 40}) {
+            for (bool with_openmp : {false, true}) {
+                const image8u er_naive = morphology::erode(in, strength, with_openmp, morphology::Method::Naive);
+                const image8u er_fast = morphology::erode(in, strength, with_openmp, morphology::Method::VanHerk);
+                EXPECT_EQ(er_fast.toVector(), er_naive.toVector()) << w << "x" << h << " erode r=" << strength;
+
+                const image8u di_naive = morphology::dilate(in, strength, with_openmp, morphology::Method::Naive);
+                const image8u di_fast = morphology::dilate(in, strength, with_openmp, morphology::Method::VanHerk);
+                EXPECT_EQ(di_fast.toVector(), di_naive.toVector()) << w << "x" << h << " dilate r=" << strength;
+            }
+        }
+    }
+}
+
+TEST(morphology, VanHerkZeroPaddingOnBorder) {
+    // fully white image: erosion keeps only pixels with the whole window inside, dilation keeps everything
+    image8u in(20, 12, 1);
+    in.fill(255);
+    const int strength = 3;
+
+    const image8u er = morphology::erode(in, strength, true, morphology::Method::VanHerk);
+    const image8u di = morphology::dilate(in, strength, true, morphology::Method::VanHerk);
+    for (int j = 0; j < in.height(); ++j) {
+        for (int i = 0; i < in.width(); ++i) {
+            const bool inside = j >= strength && j < in.height() - strength && i >= strength && i < in.width() - strength;
+            EXPECT_EQ(er(j, i), inside ? 255 : 0) << j << " " << i;
+            EXPECT_EQ(di(j, i), 255);
+        }
+    }
+}
+
+TEST(morphology, BitMaskMatchesImage) {
+    const std::vector<std::pair<int, int>> sizes = {{1, 1}, {63, 5}, {64, 9}, {65, 3}, {130, 70}, {200, 31}};
+    uint32_t seed = 566;
+    for (auto [w, h] : sizes) {
+        const image8u in = makeRandomMask(w, h, 5, seed++);
+        const BitMask bits = BitMask::fromImage(in);
+        for (int strength : {0, 1, 2, 5, 31, 32, 64, 100}) {
+            EXPECT_EQ(morphology::erode(bits, strength).toImage().toVector(), morphology::erode(in, strength).toVector())
+                << w << "x" << h << " erode r=" << strength;
+            EXPECT_EQ(morphology::dilate(bits, strength).toImage().toVector(), morphology::dilate(in, strength).toVector())
+                << w << "x" << h << " dilate r=" << strength;
+        }
+    }
+}
+
+TEST(morphology, SequenceMatchesSeparateCalls) {
+    using morphology::Operation;
+    const morphology::Step steps[] = {
+        {Operation::Dilate, 3}, {Operation::Erode, 3}, {Operation::Erode, 0}, {Operation::Erode, 5}, {Operation::Dilate, 2}};
+
+    uint32_t seed = 1024;
+    for (auto [w, h] : std::vector<std::pair<int, int>>{{1, 1}, {70, 9}, {129, 64}}) {
+        const image8u in = makeRandomMask(w, h, 5, seed++);
+
+        image8u expected = in;
+        for (const morphology::Step& step : steps) {
+            expected = step.operation == Operation::Erode ? morphology::erode(expected, step.strength)
+                                                          : morphology::dilate(expected, step.strength);
+        }
+        EXPECT_EQ(morphology::sequence(in, steps).toVector(), expected.toVector()) << w << "x" << h;
+        EXPECT_EQ(morphology::sequence(BitMask::fromImage(in), steps).toImage().toVector(), expected.toVector())
+            << w << "x" << h;
+
+        // no steps (or only zero-strength ones) - copy
+        EXPECT_EQ(morphology::sequence(in, {}).toVector(), in.toVector());
+
+        const image8u closed = morphology::erode(morphology::dilate(in, 2), 2);
+        const image8u opened = morphology::dilate(morphology::erode(in, 2), 2);
+        EXPECT_EQ(morphology::close(in, 2).toVector(), closed.toVector());
+        EXPECT_EQ(morphology::open(in, 2).toVector(), opened.toVector());
+        EXPECT_EQ(morphology::close(BitMask::fromImage(in), 2), BitMask::fromImage(closed));
+        EXPECT_EQ(morphology::open(BitMask::fromImage(in), 2), BitMask::fromImage(opened));
+    }
+}
+
+TEST(morphology, SequenceRejectsNonBinaryInput) {
+    image8u in = make_black(8, 8);
+    in(3, 3) = 17;
+    EXPECT_THROW(morphology::close(in, 1), assertion_error);
+}
+
 TEST(morphology, thresholdByConstant100AndUseMorphology) {
     configureWorkingDirectory();
 
@@ -12,6 +12,11 @@
 
 namespace {
 
+// SimplifyMethod::Prefiltered: Douglas-Peucker tolerance (in pixels) and how many contour neighbours
+// on each side of a Douglas-Peucker vertex are candidates as well
+constexpr double kPrefilterTolerance = 1.0;
+constexpr size_t kPrefilterRadius = 2;
+
 double dist2_point_to_line(point2i p, point2i a, point2i b) {
     const long long vx = static_cast<long long>(b.x) - a.x;
     const long long vy = static_cast<long long>(b.y) - a.y;
@@ -39,12 +44,10 @@ struct HeapItem {
     }
 };
 
-} // namespace
-
-std::vector<point2i> simplifyContour(const std::vector<point2i> &contour, size_t targetVertexSize) {
-    const int n = contour.size();
-    std::vector<point2i> result;
-
+// Removes the least "corner-like" vertex (closest to the line through its neighbours) until targetVertexSize remain.
+// vertices are increasing indices into the contour (all of it or candidates), returns indices of the remaining ones.
+std::vector<size_t> eliminateVertices(const std::vector<point2i> &contour, const std::vector<size_t> &vertices, size_t targetVertexSize) {
+    const int n = vertices.size();
     // DONE нам дан контур - это зацикленный обход границы объекта по пикселям
     // нам надо его упростить до targetVertexSize вершин (у нас это число будет всегда равно 4)
     // давайте сделаем так: пока у нас много вершин - пытаемся удалить какую-то одну
@@ -56,9 +59,6 @@ std::vector<point2i> simplifyContour(const std::vector<point2i> &contour, size_t
     // а значит эта вершина и соседние с ней - лежат на одной прямой
     // тогда в конечном итоге останутся вершины на углах
 
-    if (targetVertexSize == 0 || contour.empty()) return {};
-    if (static_cast<size_t>(n) <= targetVertexSize) return contour;
-
     std::vector<int> prev(n), next(n);
     std::vector<bool> alive(n, true);
     std::vector<std::size_t> version(n, 0);
@@ -73,7 +73,7 @@ std::vector<point2i> simplifyContour(const std::vector<point2i> &contour, size_t
         const int a = prev[i];
         const int b = next[i];
         if (!alive[a] || !alive[b]) return std::numeric_limits<double>::infinity();
-        return dist2_point_to_line(contour[i], contour[a], contour[b]);
+        return dist2_point_to_line(contour[vertices[i]], contour[vertices[a]], contour[vertices[b]]);
     };
 
     std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> pq;
@@ -121,17 +121,128 @@ std::vector<point2i> simplifyContour(const std::vector<point2i> &contour, size_t
     }
     rassert(start >= 0, 71238124);
 
+    std::vector<size_t> result;
     result.reserve(targetVertexSize);
 
     int cur = start;
     do {
-        result.push_back(contour[cur]);
+        result.push_back(vertices[cur]);
         cur = next[cur];
     } while (cur != start && static_cast<int>(result.size()) <= aliveCount + 1);
 
     return result;
 }
 
+// Douglas-Peucker on the closed contour (split into two halves by point 0 and the point farthest from it):
+// a part is split at its vertex farthest from the chord while that distance exceeds tolerance.
+std::vector<size_t> prefilterCandidates(const std::vector<point2i> &contour, double tolerance) {
+    const size_t n = contour.size();
+    const double tolerance2 = tolerance * tolerance;
+
+    size_t farthest = 0;
+    long long farthestDist2 = -1;
+    for (size_t i = 1; i < n; ++i) {
+        const long long dx = contour[i].x - contour[0].x;
+        const long long dy = contour[i].y - contour[0].y;
+        if (dx * dx + dy * dy > farthestDist2) {
+            farthestDist2 = dx * dx + dy * dy;
+            farthest = i;
+        }
+    }
+
+    std::vector<bool> keep(n, false);
+    keep[0] = true;
+    keep[farthest] = true;
+
+    // parts [a, b] of the contour, b == n is point 0 again
+    std::vector<std::pair<size_t, size_t>> stack = {{0, farthest}, {farthest, n}};
+    while (!stack.empty()) {
+        const auto [a, b] = stack.back();
+        stack.pop_back();
+        if (b - a < 2) continue;
+
+        const point2i pa = contour[a];
+        const point2i pb = contour[b % n];
+        size_t best = a;
+        double bestDist2 = -1.0;
+        for (size_t i = a + 1; i < b; ++i) {
+            const double d2 = dist2_point_to_line(contour[i], pa, pb);
+            if (d2 > bestDist2) {
+                bestDist2 = d2;
+                best = i;
+            }
+        }
+        if (bestDist2 <= tolerance2) continue;
+
+        keep[best] = true;
+        stack.push_back({a, best});
+        stack.push_back({best, b});
+    }
+
+    // DP vertices are snapped to the farthest pixel of a rounded corner, elimination picks among its neighbours too
+    const size_t radius = std::min(kPrefilterRadius, n / 2);
+    std::vector<bool> candidate(n, false);
+    for (size_t i = 0; i < n; ++i) {
+        if (!keep[i]) continue;
+        for (size_t d = 0; d <= 2 * radius; ++d) {
+            candidate[(i + n + d - radius) % n] = true;
+        }
+    }
+
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < n; ++i) {
+        if (candidate[i]) indices.push_back(i);
+    }
+    return indices;
+}
+
+} // namespace
+
+std::vector<point2i> simplifyContour(const std::vector<point2i> &contour, size_t targetVertexSize, SimplifyMethod method) {
+    std::vector<point2i> result;
+    for (size_t i : simplifyContourIndices(contour, targetVertexSize, method)) {
+        result.push_back(contour[i]);
+    }
+    return result;
+}
+
+std::vector<size_t> simplifyContourIndices(const std::vector<point2i> &contour, size_t targetVertexSize, SimplifyMethod method) {
+    const size_t n = contour.size();
+    if (targetVertexSize == 0 || contour.empty()) return {};
+
+    if (method == SimplifyMethod::Prefiltered && n > targetVertexSize) {
+        std::vector<size_t> candidates = prefilterCandidates(contour, kPrefilterTolerance);
+        if (candidates.size() > targetVertexSize) {
+            return eliminateVertices(contour, candidates, targetVertexSize);
+        }
+        // too few candidates (tiny or degenerate contour) - use all points as exact elimination does
+    }
+
+    std::vector<size_t> all(n);
+    for (size_t i = 0; i < n; ++i) all[i] = i;
+    if (n <= targetVertexSize) return all;
+    return eliminateVertices(contour, all, targetVertexSize);
+}
+
+std::vector<ContourRange> splitContourByCornerIndices(size_t contourSize, const std::vector<size_t> &cornerIndices)
+{
+    const size_t m = cornerIndices.size();
+    rassert(m >= 2, 918273651, m);
+    for (size_t k = 0; k < m; ++k) {
+        rassert(cornerIndices[k] < contourSize, 918273652, cornerIndices[k], contourSize);
+        rassert(k == 0 || cornerIndices[k - 1] < cornerIndices[k], 918273653, "corner indices must be increasing", k);
+    }
+
+    std::vector<ContourRange> sides(m);
+    for (size_t k = 0; k < m; ++k) {
+        const size_t i = cornerIndices[k];
+        const size_t j = cornerIndices[(k + 1) % m];
+        // j < i only for the last side, which continues from the beginning of the contour
+        sides[k] = {i, (j < i ? j + contourSize : j) - i + 1};
+    }
+    return sides;
+}
+
 std::vector<std::vector<point2i>> splitContourByCorners(
     const std::vector<point2i> &contour,
     const std::vector<point2i> &corners)
@@ -141,43 +252,31 @@ std::vector<std::vector<point2i>> splitContourByCorners(
 
     const int n = static_cast<int>(contour.size());
 
-    std::vector<int> cornerIdx;
-    cornerIdx.reserve(corners.size());
-
-    for (const auto& c : corners) {
-        int idx = -1;
-        for (int i = 0; i < n; ++i) {
-            if (contour[i] == c) { idx = i; break; }
+    // first occurrence of every corner, in a single pass over the contour
+    std::vector<int> cornerIdx(corners.size(), -1);
+    size_t found = 0;
+    for (int i = 0; i < n && found < corners.size(); ++i) {
+        for (size_t k = 0; k < corners.size(); ++k) {
+            if (cornerIdx[k] == -1 && contour[i] == corners[k]) {
+                cornerIdx[k] = i;
+                ++found;
+            }
         }
-        rassert(idx >= 0, 918273650);
-        cornerIdx.push_back(idx);
     }
+    rassert(found == corners.size(), 918273650);
 
     std::sort(cornerIdx.begin(), cornerIdx.end());
     cornerIdx.erase(std::unique(cornerIdx.begin(), cornerIdx.end()), cornerIdx.end());
 
-    rassert(cornerIdx.size() >= 2, 918273651);
+    const std::vector<ContourRange> sides = splitContourByCornerIndices(contour.size(), std::vector<size_t>(cornerIdx.begin(), cornerIdx.end()));
 
-    const int m = static_cast<int>(cornerIdx.size());
     std::vector<std::vector<point2i>> parts;
-    parts.reserve(static_cast<size_t>(m));
-
-    for (int k = 0; k < m; ++k) {
-        const int i = cornerIdx[k];
-        const int j = cornerIdx[(k + 1) % m];
-
-        std::vector<point2i> part;
-        part.reserve(static_cast<size_t>(n / m + 4));
-
-        part.push_back(contour[i]);
-
-        if (i < j) {
-            for (int t = i + 1; t <= j; ++t) part.push_back(contour[t]);
-        } else {
-            for (int t = i + 1; t < n; ++t) part.push_back(contour[t]);
-            for (int t = 0; t <= j; ++t) part.push_back(contour[t]);
+    parts.reserve(sides.size());
+    for (const ContourRange &side : sides) {
+        std::vector<point2i> part(side.length);
+        for (size_t t = 0; t < side.length; ++t) {
+            part[t] = contour[(side.begin + t) % contour.size()];
         }
-
         parts.push_back(std::move(part));
     }
 
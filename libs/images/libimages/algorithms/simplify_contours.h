@@ -4,6 +4,29 @@
 
 #include <vector>
 
-std::vector<point2i> simplifyContour(const std::vector<point2i> &contour, size_t targetVertexSize);
+enum class SimplifyMethod {
+    Exact,       // elimination over all contour points, O(n log n) heap operations
+    Prefiltered, // Douglas-Peucker (1 pixel tolerance) keeps a few hundred candidates (+-2 neighbours of its vertices),
+                 // then the same elimination among them only
+};
+
+std::vector<point2i> simplifyContour(const std::vector<point2i> &contour, size_t targetVertexSize,
+                                     SimplifyMethod method = SimplifyMethod::Exact);
+// Same vertices as simplifyContour, but as indices into the contour (increasing)
+std::vector<size_t> simplifyContourIndices(const std::vector<point2i> &contour, size_t targetVertexSize,
+                                           SimplifyMethod method = SimplifyMethod::Exact);
+
+// Points begin, begin + 1, ..., begin + length - 1 of a closed contour (indices modulo contour size),
+// e.g. ChainCode::slice(range.begin, range.length) gives them without copying
+struct ContourRange {
+    size_t begin = 0;
+    size_t length = 0;
+
+    bool operator==(const ContourRange &other) const = default;
+};
+
+// Sides between consecutive corners (both corners included), the last side wraps around to the first corner.
+// cornerIndices must be strictly increasing indices into a contour of contourSize points (as simplifyContourIndices gives).
+std::vector<ContourRange> splitContourByCornerIndices(size_t contourSize, const std::vector<size_t> &cornerIndices);
 
 std::vector<std::vector<point2i>> splitContourByCorners(const std::vector<point2i> &contour, const std::vector<point2i> &corners);
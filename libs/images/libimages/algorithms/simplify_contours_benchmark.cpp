@@ -0,0 +1,20 @@
+#include "simplify_contours.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/algorithms/extract_contour.h>
+#include <libimages/benchmark_utils.h>
+
+TEST(simplify_contours_benchmark, allObjectCorners) {
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight);
+    const std::vector<std::vector<point2i>> contours = extractContours(findConnectedComponents(mask));
+
+    benchmark("48 objects: simplifyContourIndices exact", [&]() {
+        for (const std::vector<point2i> &contour : contours)
+            simplifyContourIndices(contour, 4, SimplifyMethod::Exact);
+    });
+    benchmark("48 objects: simplifyContourIndices prefiltered", [&]() {
+        for (const std::vector<point2i> &contour : contours)
+            simplifyContourIndices(contour, 4, SimplifyMethod::Prefiltered);
+    });
+}
@@ -3,6 +3,11 @@
 #include <gtest/gtest.h>
 
 #include <libimages/tests_utils.h>
+#include <libimages/chain_code.h>
+#include <libimages/image_io.h>
+#include <libimages/algorithms/extract_contour.h>
+#include <libimages/algorithms/foreground_segmentation.h>
+#include <libimages/algorithms/morphology.h>
 #include <libbase/configure_working_directory.h>
 #include <libimages/debug_io.h>
 #include <libimages/image.h>
@@ -147,3 +152,61 @@ TEST(simplify_contours, splitContourByCorners_rectangle_sides) {
         debug_io::dump_image(getUnitCaseDebugDir() + "01_parts.jpg", img);
     }
 }
+
+TEST(simplify_contours, simplifyContourIndices_match_points) {
+    // rotated so that the top-left corner is not the first contour point
+    auto contour = makeRectContour(point2i{2, 3}, point2i{9, 7});
+    std::rotate(contour.begin(), contour.begin() + 3, contour.end());
+
+    const std::vector<size_t> indices = simplifyContourIndices(contour, 4);
+    const std::vector<point2i> corners = simplifyContour(contour, 4);
+    ASSERT_EQ(indices.size(), 4u);
+    EXPECT_TRUE(std::is_sorted(indices.begin(), indices.end()));
+    for (size_t k = 0; k < indices.size(); ++k) {
+        EXPECT_EQ(contour[indices[k]], corners[k]);
+    }
+
+    EXPECT_EQ(simplifyContourIndices(contour, contour.size()).size(), contour.size());
+    EXPECT_TRUE(simplifyContourIndices({}, 4).empty());
+}
+
+TEST(simplify_contours, splitContourByCornerIndices_wraps_around) {
+    const std::vector<ContourRange> sides = splitContourByCornerIndices(20, {3, 8, 12, 17});
+    const std::vector<ContourRange> expected = {{3, 6}, {8, 5}, {12, 6}, {17, 7}};
+    EXPECT_EQ(sides, expected);
+
+    EXPECT_THROW(splitContourByCornerIndices(20, {3}), assertion_error);
+    EXPECT_THROW(splitContourByCornerIndices(20, {8, 3}), assertion_error);
+    EXPECT_THROW(splitContourByCornerIndices(20, {3, 20}), assertion_error);
+}
+
+TEST(simplify_contours, splitContourByCornerIndices_matches_point_sides) {
+    auto contour = makeRectContour(point2i{2, 3}, point2i{9, 7});
+    std::rotate(contour.begin(), contour.begin() + 3, contour.end());
+
+    const std::vector<point2i> corners = simplifyContour(contour, 4);
+    const std::vector<std::vector<point2i>> parts = splitContourByCorners(contour, corners);
+
+    const ChainCode code = ChainCode::fromContour(contour);
+    const std::vector<ContourRange> sides = splitContourByCornerIndices(contour.size(), simplifyContourIndices(contour, 4));
+    ASSERT_EQ(sides.size(), parts.size());
+    for (size_t k = 0; k < sides.size(); ++k) {
+        EXPECT_EQ(code.slice(sides[k].begin, sides[k].length).toPoints(), parts[k]);
+    }
+}
+
+TEST(simplify_contours, prefiltered_matches_exact_on_sample_image) {
+    configureWorkingDirectory();
+
+    const image8u img = load_image("data/00_photo_six_parts_downscaled_x4.jpg");
+    const ForegroundSegmentation segmentation = segmentForeground(img);
+    const BitMask mask = morphology::open(morphology::close(segmentation.mask, 3), 3);
+    const std::vector<std::vector<point2i>> contours = extractContours(findConnectedComponents(mask));
+    ASSERT_EQ(contours.size(), 6u);
+
+    for (const std::vector<point2i> &contour : contours) {
+        const std::vector<size_t> exact = simplifyContourIndices(contour, 4, SimplifyMethod::Exact);
+        const std::vector<size_t> prefiltered = simplifyContourIndices(contour, 4, SimplifyMethod::Prefiltered);
+        EXPECT_EQ(prefiltered, exact);
+    }
+}
@@ -1,8 +1,34 @@
 #pragma once
 
+#include <libimages/algorithms/connected_components.h>
+#include <libimages/bit_mask.h>
 #include <libimages/image.h>
+#include <libimages/image_view.h>
 #include <libbase/point2.h>
 
+#include <tuple>
+#include <vector>
 
-std::tuple<std::vector<point2i>, std::vector<image8u>, std::vector<image8u>> splitObjects(
+// Splits objectsMask (0 = background, 255 = object) into 8-connected objects ordered by bbox top-left (y, then x).
+// Returns per object:
+//  - offset: top-left corner of its bbox in image,
+//  - image part: view of the bbox region of image (not a copy - image must outlive it),
+//  - mask: bbox-sized mask (255 = pixel of this object, 0 = background or pixel of another object).
+std::tuple<std::vector<point2i>, std::vector<ImageView<const std::uint8_t>>, std::vector<image8u>> splitObjects(
     const image8u &image, const image8u &objectsMask);
+
+// The same for a bit mask (true = object)
+std::tuple<std::vector<point2i>, std::vector<ImageView<const std::uint8_t>>, std::vector<image8u>> splitObjects(
+    const image8u &image, const BitMask &objectsMask);
+
+// The same for already labelled components (objects are components in their order)
+std::tuple<std::vector<point2i>, std::vector<ImageView<const std::uint8_t>>, std::vector<image8u>> splitObjects(
+    const image8u &image, const ConnectedComponents &components);
+
+// Parts would be views into a destroyed temporary.
+std::tuple<std::vector<point2i>, std::vector<ImageView<const std::uint8_t>>, std::vector<image8u>> splitObjects(
+    image8u &&image, const image8u &objectsMask) = delete;
+std::tuple<std::vector<point2i>, std::vector<ImageView<const std::uint8_t>>, std::vector<image8u>> splitObjects(
+    image8u &&image, const BitMask &objectsMask) = delete;
+std::tuple<std::vector<point2i>, std::vector<ImageView<const std::uint8_t>>, std::vector<image8u>> splitObjects(
+    image8u &&image, const ConnectedComponents &components) = delete;
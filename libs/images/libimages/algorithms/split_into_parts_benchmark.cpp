@@ -0,0 +1,23 @@
+#include "split_into_parts.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/algorithms/connected_components.h>
+#include <libimages/benchmark_utils.h>
+
+TEST(split_into_parts_benchmark, splitObjects) {
+    const image8u board = makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight);
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight);
+    const BitMask bits = BitMask::fromImage(mask);
+    benchmark("splitObjects", [&]() {
+        auto [offsets, images, masks] = splitObjects(board, mask);
+        EXPECT_EQ(offsets.size(), 48);
+    });
+    benchmark("splitObjects bitmask", [&]() {
+        auto [offsets, images, masks] = splitObjects(board, bits);
+        EXPECT_EQ(offsets.size(), 48);
+    });
+    benchmark("findConnectedComponents", [&]() { findConnectedComponents(mask); });
+    benchmark("findConnectedComponents single thread", [&]() { findConnectedComponents(mask, false); });
+    benchmark("findConnectedComponents bitmask", [&]() { findConnectedComponents(bits); });
+}
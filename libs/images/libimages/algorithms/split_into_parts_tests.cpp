@@ -70,8 +70,8 @@ TEST(split_into_parts, oneComponent) {
     ASSERT_EQ(objectsMasks[0].width(), aSize.x);
     ASSERT_EQ(objectsMasks[0].height(), aSize.y);
 
-    ASSERT_EQ(stats::minValue(objectsImages[0].toVector()), 0);
-    ASSERT_EQ(stats::maxValue(objectsImages[0].toVector()), aColor);
+    ASSERT_EQ(stats::minValue(objectsImages[0].toImage().toVector()), 0);
+    ASSERT_EQ(stats::maxValue(objectsImages[0].toImage().toVector()), aColor);
 
     ASSERT_EQ(stats::minValue(objectsMasks[0].toVector()), 0);
     ASSERT_EQ(stats::maxValue(objectsMasks[0].toVector()), 255);
@@ -154,10 +154,10 @@ TEST(split_into_parts, twoComponents) {
     ASSERT_EQ(objectsMasks[bIndex].width(), bSize.x);
     ASSERT_EQ(objectsMasks[bIndex].height(), bSize.y);
 
-    ASSERT_EQ(stats::minValue(objectsImages[aIndex].toVector()), 0);
-    ASSERT_EQ(stats::maxValue(objectsImages[aIndex].toVector()), aColor);
-    ASSERT_EQ(stats::minValue(objectsImages[bIndex].toVector()), 0);
-    ASSERT_EQ(stats::maxValue(objectsImages[bIndex].toVector()), bColor);
+    ASSERT_EQ(stats::minValue(objectsImages[aIndex].toImage().toVector()), 0);
+    ASSERT_EQ(stats::maxValue(objectsImages[aIndex].toImage().toVector()), aColor);
+    ASSERT_EQ(stats::minValue(objectsImages[bIndex].toImage().toVector()), 0);
+    ASSERT_EQ(stats::maxValue(objectsImages[bIndex].toImage().toVector()), bColor);
 
     ASSERT_EQ(stats::minValue(objectsMasks[aIndex].toVector()), 0);
     ASSERT_EQ(stats::maxValue(objectsMasks[aIndex].toVector()), 255);
@@ -184,3 +184,56 @@ TEST(split_into_parts, twoComponents) {
     debug_io::dump_image(getUnitCaseDebugDir() + "02_result_components.jpg", debug_io::colorize_labels(labels, 0));
 }
 
+
+TEST(split_into_parts, partsImagesAreViewsIntoImage) {
+    int w = 40;
+    int h = 30;
+    image8u image(w, h, 3);
+    image8u objectsMask(w, h, 1);
+    for (int j = 5; j < 12; ++j) {
+        for (int i = 20; i < 31; ++i) {
+            objectsMask(j, i) = 255;
+            image(j, i, 1) = 200;
+        }
+    }
+
+    auto [objectsOffsets, objectsImages, objectsMasks] = splitObjects(image, objectsMask);
+    ASSERT_EQ(objectsImages.size(), 1);
+
+    // no pixels are copied: part image points into the source image with the source row stride
+    const ImageView<const std::uint8_t> &part = objectsImages[0];
+    EXPECT_EQ(part.data(), image.ptr(5) + 20 * 3);
+    EXPECT_EQ(part.stride_elements(), image.stride_elements());
+    EXPECT_EQ(part.width(), 11);
+    EXPECT_EQ(part.height(), 7);
+    EXPECT_EQ(part(0, 0, 1), 200);
+    EXPECT_EQ(part(6, 10, 1), 200);
+}
+
+TEST(split_into_parts, bitMaskMatchesImageMask) {
+    const int w = 130;
+    const int h = 150;
+    image8u image(w, h, 3);
+    const image8u objectsMask = makeRandomMask(w, h, 10, 239);
+
+    auto [offsets, images, masks] = splitObjects(image, objectsMask);
+    auto [bitsOffsets, bitsImages, bitsMasks] = splitObjects(image, BitMask::fromImage(objectsMask));
+    ASSERT_EQ(offsets.size(), bitsOffsets.size());
+    ASSERT_GT(offsets.size(), 1u);
+    for (std::size_t k = 0; k < offsets.size(); ++k) {
+        EXPECT_EQ(offsets[k], bitsOffsets[k]);
+        EXPECT_EQ(images[k].data(), bitsImages[k].data());
+        EXPECT_EQ(masks[k].toVector(), bitsMasks[k].toVector());
+    }
+
+    // every object pixel is in exactly one part mask
+    image8u covered(w, h, 1);
+    for (std::size_t k = 0; k < offsets.size(); ++k)
+        for (int j = 0; j < masks[k].height(); ++j)
+            for (int i = 0; i < masks[k].width(); ++i)
+                if (masks[k](j, i) == 255) {
+                    EXPECT_EQ(covered(offsets[k].y + j, offsets[k].x + i), 0);
+                    covered(offsets[k].y + j, offsets[k].x + i) = 255;
+                }
+    EXPECT_EQ(covered.toVector(), objectsMask.toVector());
+}
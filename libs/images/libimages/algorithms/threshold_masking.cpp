@@ -2,13 +2,36 @@
 
 #include <libbase/runtime_assert.h>
 
+#include <algorithm>
+
 
 image8u threshold_masking(const image32f &image, float threshold) {
     rassert(image.channels() == 1, 2321431421, image.channels());
-    image8u mask(image.size());
+    image8u mask(image.size(), ImageInit::Uninitialized);
     for (int j = 0; j < image.height(); ++j) {
+        const float *src = image.ptr(j);
+        std::uint8_t *dst = mask.ptr(j);
         for (int i = 0; i < image.width(); ++i) {
-            mask(j, i) = (image(j, i) < threshold) ? 0 : 255;
+            dst[i] = (src[i] < threshold) ? 0 : 255;
+        }
+    }
+    return mask;
+}
+
+BitMask threshold_bitmask(const image32f &image, float threshold) {
+    rassert(image.channels() == 1, 2321431422, image.channels());
+    const int w = image.width();
+    BitMask mask(w, image.height());
+    for (int j = 0; j < image.height(); ++j) {
+        const float *src = image.ptr(j);
+        BitMask::word_type *dst = mask.row(j);
+        for (int x0 = 0; x0 < w; x0 += BitMask::kWordBits) {
+            const int n = std::min(BitMask::kWordBits, w - x0);
+            BitMask::word_type word = 0;
+            for (int b = 0; b < n; ++b) {
+                word |= BitMask::word_type(!(src[x0 + b] < threshold)) << b; // NaN is foreground, as in threshold_masking
+            }
+            dst[x0 / BitMask::kWordBits] = word;
         }
     }
     return mask;
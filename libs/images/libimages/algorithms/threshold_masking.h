@@ -1,7 +1,11 @@
 #pragma once
 
+#include <libimages/bit_mask.h>
 #include <libimages/image.h>
 
 
 // returns mask that has 0 if < threshold, 255 otherwise
 image8u threshold_masking(const image32f &image, float threshold);
+
+// same as threshold_masking, but packed into bits (false if < threshold, true otherwise)
+BitMask threshold_bitmask(const image32f &image, float threshold);
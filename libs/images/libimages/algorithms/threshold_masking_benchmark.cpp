@@ -0,0 +1,14 @@
+#include "threshold_masking.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/algorithms/grayscale.h>
+#include <libimages/benchmark_utils.h>
+
+TEST(threshold_masking_benchmark, grayscaleAndThreshold) {
+    const image8u board = makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight);
+    image32f gray;
+    benchmark("to_grayscale_float", [&]() { gray = to_grayscale_float(board); });
+    benchmark("threshold_masking", [&]() { threshold_masking(gray, 100.0f); });
+    benchmark("threshold_bitmask", [&]() { threshold_bitmask(gray, 100.0f); });
+}
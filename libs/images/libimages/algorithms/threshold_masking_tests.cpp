@@ -9,6 +9,8 @@
 #include <libimages/image_io.h>
 #include <libimages/tests_utils.h>
 
+#include <limits>
+
 TEST(threshold_masking, thresholdByConstant100) {
     configureWorkingDirectory();
 
@@ -17,3 +19,19 @@ TEST(threshold_masking, thresholdByConstant100) {
     image8u is_foreground_mask = threshold_masking(grayscale, 100);
     debug_io::dump_image(getUnitCaseDebugDir() + "is_foreground_by_100.jpg", is_foreground_mask);
 }
+
+TEST(threshold_masking, bitmaskMatchesImage) {
+    image32f img(131, 17, 1);
+    for (int j = 0; j < img.height(); ++j)
+        for (int i = 0; i < img.width(); ++i)
+            img(j, i) = static_cast<float>((i * 7 + j * 13) % 200);
+    img(3, 5) = std::numeric_limits<float>::quiet_NaN();
+    img(16, 130) = std::numeric_limits<float>::quiet_NaN();
+
+    for (float threshold : {0.0f, 99.5f, 100.0f, 250.0f}) {
+        const image8u mask = threshold_masking(img, threshold);
+        const BitMask bits = threshold_bitmask(img, threshold);
+        EXPECT_EQ(bits, BitMask::fromImage(mask)) << threshold;
+        EXPECT_EQ(bits.toImage().toVector(), mask.toVector()) << threshold;
+    }
+}
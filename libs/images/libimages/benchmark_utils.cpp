@@ -0,0 +1,83 @@
+#include "benchmark_utils.h"
+
+#include <libbase/fast_random.h>
+#include <libbase/runtime_assert.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+template <typename F>
+void forEachPiece(int width, int height, int piecesCount, std::uint32_t seed, F f) {
+    // pieces are placed on a regular grid with random size jitter so that they never touch each other
+    const int cols = std::max(1, static_cast<int>(std::lround(std::sqrt(piecesCount * 1.5))));
+    const int rows = std::max(1, (piecesCount + cols - 1) / cols);
+    const int cellW = width / cols;
+    const int cellH = height / rows;
+    rassert(cellW >= 8 && cellH >= 8, 4398127312, width, height, piecesCount);
+
+    FastRandom r(seed);
+    for (int k = 0; k < piecesCount; ++k) {
+        const int cx = (k % cols) * cellW;
+        const int cy = (k / cols) * cellH;
+        const int x0 = cx + r.nextInt(1, cellW / 8);
+        const int y0 = cy + r.nextInt(1, cellH / 8);
+        const int x1 = cx + cellW - r.nextInt(1, cellW / 8);
+        const int y1 = cy + cellH - r.nextInt(1, cellH / 8);
+        f(x0, y0, x1, y1);
+    }
+}
+
+} // namespace
+
+image8u makeBenchmarkBoard(int width, int height, int piecesCount, std::uint32_t seed) {
+    image8u board(width, height, 3);
+    FastRandom noise(seed + 1);
+    for (int j = 0; j < height; ++j) {
+        std::uint8_t *row = board.ptr(j);
+        for (int e = 0; e < width * 3; ++e) {
+            row[e] = static_cast<std::uint8_t>(noise.nextInt(10, 40));
+        }
+    }
+
+    FastRandom colors(seed + 2);
+    forEachPiece(width, height, piecesCount, seed, [&](int x0, int y0, int x1, int y1) {
+        for (int j = y0; j < y1; ++j) {
+            std::uint8_t *row = board.ptr(j);
+            for (int i = x0; i < x1; ++i) {
+                // smooth gradient inside of the piece with a bit of noise
+                row[3 * i + 0] = static_cast<std::uint8_t>(128 + (i - x0) * 127 / (x1 - x0));
+                row[3 * i + 1] = static_cast<std::uint8_t>(128 + (j - y0) * 127 / (y1 - y0));
+                row[3 * i + 2] = static_cast<std::uint8_t>(colors.nextInt(150, 200));
+            }
+        }
+    });
+    return board;
+}
+
+image8u makeTintedBenchmarkBoard(int width, int height, int piecesCount, std::uint32_t seed) {
+    image8u board = makeBenchmarkBoard(width, height, piecesCount, seed);
+    for (int j = 0; j < height; ++j) {
+        std::uint8_t *row = board.ptr(j);
+        for (int i = 0; i < width; ++i) {
+            const double x = 6.0 * i / width;
+            const double y = 6.0 * j / height;
+            const double tint[3] = {0.6 + 0.4 * std::sin(x), 0.6 + 0.4 * std::sin(y + 1.0), 0.6 + 0.4 * std::cos(x + y)};
+            for (int c = 0; c < 3; ++c)
+                row[3 * i + c] = static_cast<std::uint8_t>(row[3 * i + c] * tint[c]);
+        }
+    }
+    return board;
+}
+
+image8u makeBenchmarkBoardMask(int width, int height, int piecesCount, std::uint32_t seed) {
+    image8u mask(width, height, 1);
+    forEachPiece(width, height, piecesCount, seed, [&](int x0, int y0, int x1, int y1) {
+        for (int j = y0; j < y1; ++j) {
+            std::uint8_t *row = mask.ptr(j);
+            std::fill(row + x0, row + x1, static_cast<std::uint8_t>(255));
+        }
+    });
+    return mask;
+}
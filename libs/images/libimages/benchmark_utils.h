@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+#include <libbase/benchmark.h>
+#include <libimages/image.h>
+
+// Size of synthetic benchmark images (6 MP, a quarter of a full-resolution 24 MP board photo)
+constexpr int kBenchmarkWidth = 3000;
+constexpr int kBenchmarkHeight = 2000;
+
+// Synthetic board photo: noisy dark background with piecesCount bright rectangular "pieces" (3 channels).
+image8u makeBenchmarkBoard(int width, int height, int piecesCount = 48, std::uint32_t seed = 239);
+
+// makeBenchmarkBoard with a smooth color tint changing across the board (as colors of a real picture change from piece to piece).
+image8u makeTintedBenchmarkBoard(int width, int height, int piecesCount = 48, std::uint32_t seed = 239);
+
+// Binary foreground mask (0/255) of makeBenchmarkBoard with the same arguments.
+image8u makeBenchmarkBoardMask(int width, int height, int piecesCount = 48, std::uint32_t seed = 239);
@@ -0,0 +1,67 @@
+#include "bit_mask.h"
+
+#include <algorithm>
+#include <bit>
+
+BitMask::BitMask(int width, int height) {
+    rassert(width > 0 && height > 0, 83412678124, width, height);
+    w_ = width;
+    h_ = height;
+    words_per_row_ = (static_cast<std::size_t>(width) + kWordBits - 1) / kWordBits;
+    words_.assign(words_per_row_ * static_cast<std::size_t>(height), 0);
+}
+
+BitMask BitMask::fromImage(ImageView<const std::uint8_t> mask) {
+    rassert(mask.channels() == 1, 83412678125, mask.channels());
+    BitMask bits(mask.width(), mask.height());
+    const int w = mask.width();
+    for (int j = 0; j < mask.height(); ++j) {
+        const std::uint8_t *src = mask.ptr(j);
+        word_type *dst = bits.row(j);
+        // OR of all pixels that are neither 0 nor 255 (v + 1 maps both to 0 or 1 in the low bits)
+        std::uint8_t not_binary = 0;
+        for (int x0 = 0; x0 < w; x0 += kWordBits) {
+            const int n = std::min(kWordBits, w - x0);
+            word_type word = 0;
+            for (int b = 0; b < n; ++b) {
+                const std::uint8_t v = src[x0 + b];
+                not_binary |= static_cast<std::uint8_t>(v + 1) & 0xFE;
+                word |= word_type(v & 1) << b;
+            }
+            dst[x0 / kWordBits] = word;
+        }
+        rassert(not_binary == 0, 83412678126, "BitMask expects binary pixels {0,255}", j);
+    }
+    return bits;
+}
+
+image8u BitMask::toImage() const {
+    image8u mask(w_, h_, 1, ImageInit::Uninitialized);
+    for (int j = 0; j < h_; ++j) {
+        const word_type *src = row(j);
+        std::uint8_t *dst = mask.ptr(j);
+        for (int i = 0; i < w_; ++i) {
+            dst[i] = ((src[i / kWordBits] >> (i % kWordBits)) & 1u) ? 255 : 0;
+        }
+    }
+    return mask;
+}
+
+void BitMask::fill(bool value) {
+    if (!value) {
+        std::fill(words_.begin(), words_.end(), 0);
+        return;
+    }
+    for (int j = 0; j < h_; ++j) {
+        word_type *dst = row(j);
+        std::fill(dst, dst + words_per_row_, ~word_type(0));
+        dst[words_per_row_ - 1] = last_word_mask();
+    }
+}
+
+std::size_t BitMask::count() const {
+    std::size_t n = 0;
+    for (word_type word : words_)
+        n += static_cast<std::size_t>(std::popcount(word));
+    return n;
+}
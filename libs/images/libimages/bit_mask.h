@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <libimages/image.h>
+#include <libimages/image_view.h>
+
+// Binary mask with 1 bit per pixel: every row is packed into words_per_row() 64-bit words,
+// pixel x of a row is bit (x % 64) of word (x / 64). Bits after width() in the last word of every row
+// are always zero, so algorithms can work with whole words (shifts, popcount) without masking.
+//
+// Conversions: BitMask::fromImage(mask) (0 -> false, 255 -> true) and mask.toImage() (false -> 0, true -> 255).
+class BitMask final {
+  public:
+    using word_type = std::uint64_t;
+    static constexpr int kWordBits = 64;
+
+    BitMask() = default;
+    BitMask(int width, int height);
+
+    static BitMask fromImage(ImageView<const std::uint8_t> mask);
+    image8u toImage() const;
+
+    int width() const noexcept { return w_; }
+    int height() const noexcept { return h_; }
+    std::size_t words_per_row() const noexcept { return words_per_row_; }
+
+    word_type *row(int j) {
+        rassert_image_access(j >= 0 && j < h_, 83412678120, j, h_);
+        return words_.data() + static_cast<std::size_t>(j) * words_per_row_;
+    }
+    const word_type *row(int j) const {
+        rassert_image_access(j >= 0 && j < h_, 83412678121, j, h_);
+        return words_.data() + static_cast<std::size_t>(j) * words_per_row_;
+    }
+
+    bool get(int j, int i) const {
+        rassert_image_access(i >= 0 && i < w_, 83412678122, i, w_);
+        return (row(j)[i / kWordBits] >> (i % kWordBits)) & 1u;
+    }
+    void set(int j, int i, bool value) {
+        rassert_image_access(i >= 0 && i < w_, 83412678123, i, w_);
+        const word_type bit = word_type(1) << (i % kWordBits);
+        word_type &word = row(j)[i / kWordBits];
+        word = value ? (word | bit) : (word & ~bit);
+    }
+
+    void fill(bool value);
+
+    // Number of set pixels (object area)
+    std::size_t count() const;
+
+    // Bits of the last word of a row that belong to the image (all other bits must stay zero)
+    word_type last_word_mask() const noexcept {
+        const int tail = w_ % kWordBits;
+        return tail == 0 ? ~word_type(0) : (word_type(1) << tail) - 1;
+    }
+
+    bool operator==(const BitMask &other) const = default;
+
+  private:
+    int w_ = 0;
+    int h_ = 0;
+    std::size_t words_per_row_ = 0;
+    std::vector<word_type> words_;
+};
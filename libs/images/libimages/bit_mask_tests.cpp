@@ -0,0 +1,51 @@
+#include "bit_mask.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/tests_utils.h>
+
+TEST(bit_mask, roundTripWithImage) {
+    for (int w : {1, 63, 64, 65, 200}) {
+        const image8u mask = makeRandomMask(w, 7, 3, 239 + w);
+        const BitMask bits = BitMask::fromImage(mask);
+        EXPECT_EQ(bits.width(), w);
+        EXPECT_EQ(bits.height(), 7);
+        EXPECT_EQ(bits.words_per_row(), static_cast<std::size_t>((w + 63) / 64));
+        EXPECT_EQ(bits.toImage().toVector(), mask.toVector());
+
+        std::size_t area = 0;
+        for (int j = 0; j < mask.height(); ++j)
+            for (int i = 0; i < mask.width(); ++i) {
+                EXPECT_EQ(bits.get(j, i), mask(j, i) == 255);
+                area += mask(j, i) == 255;
+            }
+        EXPECT_EQ(bits.count(), area);
+    }
+}
+
+TEST(bit_mask, setFillAndTailBits) {
+    BitMask bits(70, 2);
+    EXPECT_EQ(bits.count(), 0u);
+
+    bits.set(1, 69, true);
+    bits.set(0, 0, true);
+    EXPECT_TRUE(bits.get(1, 69));
+    EXPECT_EQ(bits.count(), 2u);
+    bits.set(0, 0, false);
+    EXPECT_EQ(bits.count(), 1u);
+
+    // bits after width stay zero, so popcount is exact
+    bits.fill(true);
+    EXPECT_EQ(bits.count(), 140u);
+    EXPECT_EQ(bits.row(0)[1], bits.last_word_mask());
+    EXPECT_EQ(bits.last_word_mask(), (BitMask::word_type(1) << 6) - 1);
+
+    bits.fill(false);
+    EXPECT_EQ(bits.count(), 0u);
+}
+
+TEST(bit_mask, rejectsNonBinaryImage) {
+    image8u mask(10, 3, 1);
+    mask(1, 5) = 128;
+    EXPECT_THROW(BitMask::fromImage(mask), assertion_error);
+}
@@ -0,0 +1,79 @@
+#include "chain_code.h"
+
+#include <cstdlib>
+
+namespace {
+
+// Direction code by (dy + 1) * 3 + (dx + 1), -1 for a zero step
+constexpr int kDirectionByDelta[9] = {5, 6, 7, 4, -1, 0, 3, 2, 1};
+
+} // namespace
+
+ChainCode ChainCode::fromContour(const std::vector<point2i> &contour) {
+    ChainCode code;
+    code.n_ = contour.size();
+    if (contour.empty())
+        return code;
+
+    const std::size_t steps = code.n_ - 1;
+    code.steps_.assign((steps + kStepsPerWord - 1) / kStepsPerWord, 0);
+    code.checkpoints_.reserve((code.n_ + kCheckpointStep - 1) / kCheckpointStep);
+    code.checkpoints_.push_back(contour[0]);
+
+    for (std::size_t i = 0; i < steps; ++i) {
+        const int dx = contour[i + 1].x - contour[i].x;
+        const int dy = contour[i + 1].y - contour[i].y;
+        rassert(std::abs(dx) <= 1 && std::abs(dy) <= 1 && (dx != 0 || dy != 0), 73461892305,
+                "consecutive contour points must be 8-neighbours", i, contour[i], contour[i + 1]);
+        const word_type dir = static_cast<word_type>(kDirectionByDelta[(dy + 1) * 3 + (dx + 1)]);
+        code.steps_[i / kStepsPerWord] |= dir << (kBitsPerStep * (i % kStepsPerWord));
+
+        if ((i + 1) % kCheckpointStep == 0)
+            code.checkpoints_.push_back(contour[i + 1]);
+    }
+    return code;
+}
+
+std::vector<point2i> ChainCode::toPoints() const {
+    std::vector<point2i> points;
+    points.reserve(n_);
+    forEach(0, n_, [&](point2i p) { points.push_back(p); });
+    return points;
+}
+
+point2i ChainCode::operator[](std::size_t i) const {
+    rassert(i < n_, 73461892306, i, n_);
+    const std::size_t checkpoint = i / kCheckpointStep;
+    point2i p = checkpoints_[checkpoint];
+
+    // steps [checkpoint * kCheckpointStep, i) lie in kCheckpointStep / kStepsPerWord whole words starting from word0
+    const std::size_t word0 = checkpoint * (kCheckpointStep / kStepsPerWord);
+    std::size_t left = i - checkpoint * kCheckpointStep;
+    for (std::size_t w = word0; left > 0; ++w) {
+        word_type bits = steps_[w];
+        const std::size_t n = left < kStepsPerWord ? left : kStepsPerWord;
+        for (std::size_t k = 0; k < n; ++k, bits >>= kBitsPerStep) {
+            p.x += kDx[bits & 7u];
+            p.y += kDy[bits & 7u];
+        }
+        left -= n;
+    }
+    return p;
+}
+
+void ChainCode::translate(point2i offset) {
+    for (point2i &p : checkpoints_)
+        p += offset;
+}
+
+ChainCodeSlice::ChainCodeSlice(const ChainCode &code, std::size_t begin, std::size_t length)
+    : code_(&code), begin_(begin), length_(length) {
+    rassert(length <= code.size() && (length == 0 || begin < code.size()), 73461892307, begin, length, code.size());
+}
+
+std::vector<point2i> ChainCodeSlice::toPoints() const {
+    std::vector<point2i> points;
+    points.reserve(length_);
+    forEach([&](point2i p) { points.push_back(p); });
+    return points;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <libbase/point2.h>
+#include <libbase/runtime_assert.h>
+#include <libimages/image.h>
+
+class ChainCodeSlice;
+
+// Compressed 8-connected contour: start point + one 3-bit Freeman direction per step between consecutive points
+// (21 directions per 64-bit word, ~0.6 byte per point with checkpoints instead of 8 bytes of point2i).
+// Every kCheckpointStep-th point is also stored explicitly, so random access decodes at most kCheckpointStep steps.
+//
+// Directions (image coords: x right, y down): 0 = right, 1 = down-right, 2 = down, ..., 7 = up-right (clockwise).
+// The closing step from the last point back to the first one is not stored, so the contour does not have to be closed,
+// but indices of slices wrap around (point size() is point 0 again).
+class ChainCode final {
+  public:
+    using word_type = std::uint64_t;
+    static constexpr int kBitsPerStep = 3;
+    static constexpr std::size_t kStepsPerWord = 21;
+    static constexpr std::size_t kCheckpointStep = 2 * kStepsPerWord;
+
+    static constexpr int kDx[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+    static constexpr int kDy[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+    ChainCode() = default;
+
+    // Consecutive points of the contour must be 8-neighbours
+    static ChainCode fromContour(const std::vector<point2i> &contour);
+    std::vector<point2i> toPoints() const;
+
+    std::size_t size() const noexcept { return n_; }
+    bool empty() const noexcept { return n_ == 0; }
+
+    // Direction of the step from point i to point i + 1 (i + 1 < size())
+    int direction(std::size_t i) const {
+        rassert_image_access(i + 1 < n_, 73461892301, i, n_);
+        return static_cast<int>((steps_[i / kStepsPerWord] >> (kBitsPerStep * (i % kStepsPerWord))) & 7u);
+    }
+
+    // Point i, decodes up to kCheckpointStep - 1 steps from the nearest checkpoint
+    point2i operator[](std::size_t i) const;
+    point2i front() const { return (*this)[0]; }
+    point2i back() const { return (*this)[n_ - 1]; }
+
+    // Calls f(point) for points begin, begin + 1, ..., begin + length - 1 (indices modulo size())
+    template <typename F> void forEach(std::size_t begin, std::size_t length, F &&f) const;
+
+    // Points [begin, begin + length) (indices modulo size()) without copying them
+    ChainCodeSlice slice(std::size_t begin, std::size_t length) const;
+
+    // Moves all points by offset (only checkpoints are touched)
+    void translate(point2i offset);
+
+    // Heap memory used by packed directions and checkpoints
+    std::size_t memoryBytes() const noexcept {
+        return steps_.size() * sizeof(word_type) + checkpoints_.size() * sizeof(point2i);
+    }
+
+    bool operator==(const ChainCode &other) const = default;
+
+  private:
+    std::size_t n_ = 0;
+    std::vector<word_type> steps_;
+    std::vector<point2i> checkpoints_; // checkpoints_[k] = point k * kCheckpointStep
+};
+
+// Range of points [begin, begin + length) of a ChainCode, indices wrap around the end of the contour
+// (so a side of a closed contour may start near its end and continue from its beginning).
+// Holds a pointer to the parent chain code, which must outlive the slice.
+class ChainCodeSlice final {
+  public:
+    ChainCodeSlice() = default;
+    ChainCodeSlice(const ChainCode &code, std::size_t begin, std::size_t length);
+
+    std::size_t size() const noexcept { return length_; }
+    bool empty() const noexcept { return length_ == 0; }
+    std::size_t begin() const noexcept { return begin_; }
+    const ChainCode &code() const {
+        rassert(code_ != nullptr, 73461892302);
+        return *code_;
+    }
+
+    // Index of point i of the slice in the parent contour
+    std::size_t parentIndex(std::size_t i) const {
+        rassert_image_access(i < length_, 73461892303, i, length_);
+        const std::size_t j = begin_ + i;
+        return j < code_->size() ? j : j - code_->size();
+    }
+
+    point2i operator[](std::size_t i) const { return (*code_)[parentIndex(i)]; }
+    point2i front() const { return (*this)[0]; }
+    point2i back() const { return (*this)[length_ - 1]; }
+
+    template <typename F> void forEach(F &&f) const {
+        if (length_ > 0)
+            code_->forEach(begin_, length_, f);
+    }
+
+    std::vector<point2i> toPoints() const;
+
+  private:
+    const ChainCode *code_ = nullptr;
+    std::size_t begin_ = 0;
+    std::size_t length_ = 0;
+};
+
+template <typename F> void ChainCode::forEach(std::size_t begin, std::size_t length, F &&f) const {
+    if (length == 0)
+        return;
+    rassert(begin < n_ && length <= n_, 73461892304, begin, length, n_);
+
+    point2i p = (*this)[begin];
+    std::size_t i = begin;
+    for (std::size_t k = 0; k < length; ++k) {
+        f(p);
+        if (++i == n_) {
+            i = 0;
+            p = checkpoints_.front();
+        } else {
+            const int dir = direction(i - 1);
+            p.x += kDx[dir];
+            p.y += kDy[dir];
+        }
+    }
+}
+
+inline ChainCodeSlice ChainCode::slice(std::size_t begin, std::size_t length) const {
+    return ChainCodeSlice(*this, begin, length);
+}
@@ -0,0 +1,45 @@
+#include "chain_code.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/algorithms/extract_contour.h>
+#include <libimages/benchmark_utils.h>
+
+#include <iostream>
+
+TEST(chain_code_benchmark, allObjectContours) {
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight);
+    const std::vector<std::vector<point2i>> contours = extractContours(findConnectedComponents(mask));
+
+    std::vector<ChainCode> codes(contours.size());
+    benchmark("48 objects: ChainCode::fromContour", [&]() {
+        for (std::size_t k = 0; k < contours.size(); ++k)
+            codes[k] = ChainCode::fromContour(contours[k]);
+    });
+    benchmark("48 objects: ChainCode::toPoints", [&]() {
+        for (const ChainCode &code : codes)
+            code.toPoints();
+    });
+
+    // every point through random access vs sequential decoding of four side slices
+    long long sum = 0;
+    benchmark("48 objects: operator[] on every point", [&]() {
+        for (const ChainCode &code : codes)
+            for (std::size_t i = 0; i < code.size(); ++i)
+                sum += code[i].x;
+    });
+    benchmark("48 objects: forEach over 4 slices", [&]() {
+        for (const ChainCode &code : codes)
+            for (std::size_t side = 0; side < 4; ++side)
+                code.slice(side * code.size() / 4, code.size() / 4 + 1).forEach([&](point2i p) { sum += p.x; });
+    });
+
+    std::size_t points_bytes = 0;
+    std::size_t codes_bytes = 0;
+    for (std::size_t k = 0; k < contours.size(); ++k) {
+        points_bytes += contours[k].size() * sizeof(point2i);
+        codes_bytes += codes[k].memoryBytes();
+    }
+    std::cout << "contours memory: " << points_bytes << " bytes as points, " << codes_bytes << " bytes as chain codes"
+              << " (checksum " << sum % 10 << ")" << std::endl;
+}
@@ -0,0 +1,96 @@
+#include "chain_code.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/fast_random.h>
+#include <libimages/algorithms/extract_contour.h>
+#include <libimages/tests_utils.h>
+
+namespace {
+
+// Random 8-connected walk (not closed)
+std::vector<point2i> makeRandomWalk(std::size_t n, std::uint32_t seed) {
+    FastRandom r(seed);
+    std::vector<point2i> points;
+    point2i p(1000, -7);
+    for (std::size_t i = 0; i < n; ++i) {
+        points.push_back(p);
+        const int dir = r.nextInt(0, 7);
+        p.x += ChainCode::kDx[dir];
+        p.y += ChainCode::kDy[dir];
+    }
+    return points;
+}
+
+} // namespace
+
+TEST(chain_code, roundTripAndRandomAccess) {
+    for (std::size_t n : {1, 2, 21, 22, 41, 42, 43, 84, 85, 1000}) {
+        const std::vector<point2i> points = makeRandomWalk(n, 239 + n);
+        const ChainCode code = ChainCode::fromContour(points);
+        ASSERT_EQ(code.size(), n);
+        EXPECT_EQ(code.toPoints(), points);
+        EXPECT_EQ(code.front(), points.front());
+        EXPECT_EQ(code.back(), points.back());
+        for (std::size_t i = 0; i < n; ++i)
+            EXPECT_EQ(code[i], points[i]) << n << " " << i;
+        for (std::size_t i = 0; i + 1 < n; ++i)
+            EXPECT_EQ(points[i + 1], points[i] + point2i(ChainCode::kDx[code.direction(i)], ChainCode::kDy[code.direction(i)]));
+    }
+
+    const ChainCode empty = ChainCode::fromContour({});
+    EXPECT_TRUE(empty.empty());
+    EXPECT_TRUE(empty.toPoints().empty());
+}
+
+TEST(chain_code, compressesContourOfMask) {
+    image8u mask(300, 200, 1);
+    for (int j = 20; j < 180; ++j)
+        for (int i = 30 + j / 4; i < 270 - j / 8; ++i)
+            mask(j, i) = 255;
+    const std::vector<point2i> contour = extractContour(buildContourMask(mask));
+    const ChainCode code = ChainCode::fromContour(contour);
+    EXPECT_EQ(code.toPoints(), contour);
+    EXPECT_LT(code.memoryBytes() * 10, contour.size() * sizeof(point2i));
+}
+
+TEST(chain_code, slicesWrapAround) {
+    const std::vector<point2i> points = makeRandomWalk(100, 7);
+    const ChainCode code = ChainCode::fromContour(points);
+
+    const ChainCodeSlice middle = code.slice(10, 50);
+    EXPECT_EQ(middle.size(), 50u);
+    EXPECT_EQ(middle.toPoints(), std::vector<point2i>(points.begin() + 10, points.begin() + 60));
+
+    // from point 90 through the end and then from point 0 up to point 19
+    const ChainCodeSlice wrapped = code.slice(90, 30);
+    std::vector<point2i> expected(points.begin() + 90, points.end());
+    expected.insert(expected.end(), points.begin(), points.begin() + 20);
+    EXPECT_EQ(wrapped.toPoints(), expected);
+    for (std::size_t i = 0; i < wrapped.size(); ++i) {
+        EXPECT_EQ(wrapped[i], expected[i]);
+        EXPECT_EQ(wrapped.parentIndex(i), (90 + i) % 100);
+    }
+    EXPECT_EQ(wrapped.front(), points[90]);
+    EXPECT_EQ(wrapped.back(), points[19]);
+
+    EXPECT_EQ(code.slice(0, 100).toPoints(), points);
+    EXPECT_TRUE(code.slice(0, 0).toPoints().empty());
+    EXPECT_THROW(code.slice(100, 1), assertion_error);
+    EXPECT_THROW(code.slice(0, 101), assertion_error);
+}
+
+TEST(chain_code, translate) {
+    std::vector<point2i> points = makeRandomWalk(200, 11);
+    ChainCode code = ChainCode::fromContour(points);
+    code.translate(point2i(-1000, 7));
+    for (point2i &p : points)
+        p += point2i(-1000, 7);
+    EXPECT_EQ(code.toPoints(), points);
+    EXPECT_EQ(code, ChainCode::fromContour(points));
+}
+
+TEST(chain_code, rejectsNonAdjacentPoints) {
+    EXPECT_THROW(ChainCode::fromContour({{0, 0}, {1, 1}, {3, 1}}), assertion_error);
+    EXPECT_THROW(ChainCode::fromContour({{0, 0}, {0, 0}}), assertion_error);
+}
@@ -9,6 +9,7 @@
 #include <libimages/image_io.h>
 #include <limits>
 #include <map>
+#include <mutex>
 
 namespace debug_io {
 
@@ -102,9 +103,15 @@ image8u colorize_labels(const image32i &labels, int void_value, std::uint32_t se
     return out;
 }
 
-void dump_image(const std::string &path, const image8u &img) {
-    std::cerr << "[debug_io] saving " << path << " (" << img.width() << "x" << img.height() << "x" << img.channels() << ")" << std::endl;
-    ensure_dir_exists_for_file(path);
+void dump_image(const std::string &path, ImageView<const std::uint8_t> img) {
+    {
+        // dumps can be made from parallel threads: log lines must not interleave and directories are created one by one,
+        // encoding and writing of the image itself is done without the lock
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+        std::cerr << "[debug_io] saving " << path << " (" << img.width() << "x" << img.height() << "x" << img.channels() << ")" << std::endl;
+        ensure_dir_exists_for_file(path);
+    }
     save_image(img, path);
 }
 
@@ -4,6 +4,7 @@
 #include <limits>
 
 #include <libimages/image.h>
+#include <libimages/image_view.h>
 
 namespace debug_io {
 
@@ -16,8 +17,8 @@ image8u normalize(const image32f &img, float void_value=std::numeric_limits<floa
 // Maps each value to random color (except pixels with void_value - they will be colored black)
 image8u colorize_labels(const image32i &labels, int void_value=std::numeric_limits<int>::max(), std::uint32_t seed = 0);
 
-// Save helpers that creates parent directory (if it still doesn't exist)
-void dump_image(const std::string &path, const image8u &img);
+// Save helpers that creates parent directory (if it still doesn't exist), can be called from parallel threads
+void dump_image(const std::string &path, ImageView<const std::uint8_t> img);
 void dump_image(const std::string &path, const image32f &img, float void_value=std::numeric_limits<float>::max());
 
 } // namespace debug_io
\ No newline at end of file
@@ -30,7 +30,7 @@ OutT convertComponent(float v) {
 }
 
 template <typename T, typename C>
-void drawPointImpl(Image<T>& image, point2i pixel, const C& cc, int size) {
+void drawPointImpl(ImageView<T> image, point2i pixel, const C& cc, int size) {
     rassert(pixel.x >= 0 && pixel.x < image.width() && pixel.y >= 0 && pixel.y < image.height(),
             98237123, "Pixel out of bounds");
 
@@ -65,6 +65,21 @@ void drawPointImpl(Image<T>& image, point2i pixel, const C& cc, int size) {
 
 template <typename T>
 void drawSegment(Image<T>& image, point2i from, point2i to, Color<T> c, int size) {
+    drawSegment(ImageView<T>(image), from, to, c, size);
+}
+
+template <typename T>
+void drawPoint(Image<T>& image, point2i pixel, Color<T> c, int size) {
+    drawPoint(ImageView<T>(image), pixel, c, size);
+}
+
+template <typename T>
+void drawPoints(Image<T>& image, const std::vector<point2i>& pixels, Color<T> c, int size) {
+    drawPoints(ImageView<T>(image), pixels, c, size);
+}
+
+template <typename T>
+void drawSegment(ImageView<T> image, point2i from, point2i to, Color<T> c, int size) {
     // Allow drawing partially outside, but at least handle empty image
     rassert(image.width() > 0 && image.height() > 0, 91283712);
 
@@ -96,12 +111,12 @@ void drawSegment(Image<T>& image, point2i from, point2i to, Color<T> c, int size
 }
 
 template <typename T>
-void drawPoint(Image<T>& image, point2i pixel, Color<T> c, int size) {
+void drawPoint(ImageView<T> image, point2i pixel, Color<T> c, int size) {
     drawPointImpl(image, pixel, c, size);
 }
 
 template <typename T>
-void drawPoints(Image<T>& image, const std::vector<point2i>& pixels, Color<T> c, int size) {
+void drawPoints(ImageView<T> image, const std::vector<point2i>& pixels, Color<T> c, int size) {
     for (const auto& p : pixels) {
         drawPoint(image, p, c, size);
     }
@@ -116,3 +131,12 @@ template void drawPoint<float>(Image<float>& image, point2i pixel, Color<float>
 
 template void drawPoints<std::uint8_t>(Image<std::uint8_t>& image, const std::vector<point2i>& pixels, Color<uint8_t> c, int size);
 template void drawPoints<float>(Image<float>& image, const std::vector<point2i>& pixels, Color<float> c, int size);
+
+template void drawSegment<std::uint8_t>(ImageView<std::uint8_t> image, point2i from, point2i to, Color<uint8_t> c, int size);
+template void drawSegment<float>(ImageView<float> image, point2i from, point2i to, Color<float> c, int size);
+
+template void drawPoint<std::uint8_t>(ImageView<std::uint8_t> image, point2i pixel, Color<uint8_t> c, int size);
+template void drawPoint<float>(ImageView<float> image, point2i pixel, Color<float> c, int size);
+
+template void drawPoints<std::uint8_t>(ImageView<std::uint8_t> image, const std::vector<point2i>& pixels, Color<uint8_t> c, int size);
+template void drawPoints<float>(ImageView<float> image, const std::vector<point2i>& pixels, Color<float> c, int size);
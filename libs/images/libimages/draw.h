@@ -4,6 +4,7 @@
 
 #include <libbase/point2.h>
 #include <libimages/image.h>
+#include <libimages/image_view.h>
 
 #include "color.h"
 
@@ -16,6 +17,16 @@ void drawPoint(Image<T>& image, point2i pixel, Color<T> c, int size=1);
 template <typename T>
 void drawPoints(Image<T>& image, const std::vector<point2i>& pixels, Color<T> c, int size=1);
 
+// Same as above, but drawing into a view (f.e. into a region of interest of a bigger image)
+template <typename T>
+void drawSegment(ImageView<T> image, point2i from, point2i to, Color<T> c, int size=1);
+
+template <typename T>
+void drawPoint(ImageView<T> image, point2i pixel, Color<T> c, int size=1);
+
+template <typename T>
+void drawPoints(ImageView<T> image, const std::vector<point2i>& pixels, Color<T> c, int size=1);
+
 extern template void drawPoint<std::uint8_t>(Image<std::uint8_t>& image, point2i pixel, Color<uint8_t> c, int size);
 extern template void drawPoint<float>(Image<float>& image, point2i pixel, Color<float> c, int size);
 
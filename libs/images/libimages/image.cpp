@@ -8,25 +8,88 @@
 template <typename T> Image<T>::Image() = default;
 
 template <typename T>
-void Image<T>::init(int width, int height, int channels) {
+void Image<T>::init(int width, int height, int channels, ImageInit init) {
+    static_assert(kImageAlignment % sizeof(T) == 0);
+    rassert(width > 0 && height > 0 && channels > 0, "Invalid image size", width, height, channels);
     w_ = width;
     h_ = height;
     c_ = channels;
-    data_ = std::vector<T>((size_t) width * height * channels);
-    rassert(width > 0 && height > 0 && channels > 0, "Invalid image size", width, height, channels);
+
+    const std::size_t row_bytes = row_elements() * sizeof(T);
+    const std::size_t padded_row_bytes = (row_bytes + kImageAlignment - 1) / kImageAlignment * kImageAlignment;
+    stride_ = padded_row_bytes / sizeof(T);
+
+    allocator_ = &currentImageAllocator();
+    data_ = static_cast<T *>(allocateImageBuffer(*allocator_, buffer_bytes()));
+    if (init == ImageInit::Zeros) {
+        std::fill(data_, data_ + stride_ * static_cast<std::size_t>(h_), T(0));
+    }
+}
+
+template <typename T> void Image<T>::release() noexcept {
+    if (data_) {
+        allocator_->deallocate(data_, buffer_bytes());
+    }
+    w_ = h_ = c_ = 0;
+    stride_ = 0;
+    data_ = nullptr;
+    allocator_ = nullptr;
 }
 
 template <typename T>
-Image<T>::Image(int width, int height, int channels) {
-    init(width, height, channels);
+Image<T>::Image(int width, int height, int channels, ImageInit init) {
+    this->init(width, height, channels, init);
 }
 
 template <typename T>
-Image<T>::Image(std::tuple<int, int, int> size) {
+Image<T>::Image(std::tuple<int, int, int> size, ImageInit init) {
     auto [width, height, channels] = size;
-    init(width, height, channels);
+    this->init(width, height, channels, init);
+}
+
+template <typename T> Image<T>::Image(const Image &other) {
+    if (other.data_) {
+        init(other.w_, other.h_, other.c_, ImageInit::Uninitialized);
+        std::copy(other.data_, other.data_ + stride_ * static_cast<std::size_t>(h_), data_);
+    }
+}
+
+template <typename T> Image<T>::Image(Image &&other) noexcept
+    : w_(other.w_), h_(other.h_), c_(other.c_), stride_(other.stride_), data_(other.data_), allocator_(other.allocator_) {
+    other.data_ = nullptr;
+    other.release();
+}
+
+template <typename T> Image<T> &Image<T>::operator=(const Image &other) {
+    if (this == &other)
+        return *this;
+    if (size() != other.size() || !data_) {
+        release();
+        if (other.data_)
+            init(other.w_, other.h_, other.c_, ImageInit::Uninitialized);
+    }
+    if (data_)
+        std::copy(other.data_, other.data_ + stride_ * static_cast<std::size_t>(h_), data_);
+    return *this;
+}
+
+template <typename T> Image<T> &Image<T>::operator=(Image &&other) noexcept {
+    if (this == &other)
+        return *this;
+    release();
+    w_ = other.w_;
+    h_ = other.h_;
+    c_ = other.c_;
+    stride_ = other.stride_;
+    data_ = other.data_;
+    allocator_ = other.allocator_;
+    other.data_ = nullptr;
+    other.release();
+    return *this;
 }
 
+template <typename T> Image<T>::~Image() { release(); }
+
 template <typename T> int Image<T>::width() const noexcept { return w_; }
 
 template <typename T> int Image<T>::height() const noexcept { return h_; }
@@ -35,20 +98,25 @@ template <typename T> int Image<T>::channels() const noexcept { return c_; }
 
 template <typename T> std::tuple<int, int, int> Image<T>::size() const noexcept { return { w_, h_, c_ }; }
 
-template <typename T> std::size_t Image<T>::stride_elements() const noexcept {
-    return static_cast<std::size_t>(w_) * static_cast<std::size_t>(c_);
-}
-
-template <typename T> T *Image<T>::data() noexcept { return data_.data(); }
+template <typename T> T *Image<T>::data() noexcept { return data_; }
 
-template <typename T> const T *Image<T>::data() const noexcept { return data_.data(); }
+template <typename T> const T *Image<T>::data() const noexcept { return data_; }
 
 template <typename T> std::vector<T> Image<T>::toVector() const {
-    std::vector<T> copy = data_;
+    std::vector<T> copy;
+    copy.reserve(row_elements() * static_cast<std::size_t>(h_));
+    for (int j = 0; j < h_; ++j) {
+        const T *row = ptr(j);
+        copy.insert(copy.end(), row, row + row_elements());
+    }
     return copy;
 }
 
-template <typename T> void Image<T>::fill(const T &value) { std::fill(data_.begin(), data_.end(), value); }
+template <typename T> void Image<T>::fill(const T &value) {
+    for (int j = 0; j < h_; ++j) {
+        std::fill(ptr(j), ptr(j) + row_elements(), value);
+    }
+}
 
 template <typename T> void Image<T>::check_bounds_2d(int j, int i, std::source_location loc) const {
     rassert(i >= 0 && i < w_ && j >= 0 && j < h_, 78497218931,
@@ -65,8 +133,7 @@ template <typename T> void Image<T>::check_bounds_3d(int j, int i, int c, std::s
 }
 
 template <typename T> std::size_t Image<T>::index(int j, int i, int c) const {
-    return (static_cast<std::size_t>(j) * static_cast<std::size_t>(w_) + static_cast<std::size_t>(i)) *
-               static_cast<std::size_t>(c_) +
+    return static_cast<std::size_t>(j) * stride_ + static_cast<std::size_t>(i) * static_cast<std::size_t>(c_) +
            static_cast<std::size_t>(c);
 }
 
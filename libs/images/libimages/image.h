@@ -3,30 +3,71 @@
 #include <cstddef>
 #include <cstdint>
 #include <source_location>
+#include <span>
+#include <tuple>
 #include <vector>
 
+#include <libbase/runtime_assert.h>
+#include <libimages/image_allocator.h>
+
+// Fast-path pixel access (Image::row/ptr and ImageView) is unchecked in release builds.
+// In Debug builds (or with -DLIBIMAGES_CHECKED_ACCESS=ON) it is bounds-checked via rassert.
+#if defined(LIBIMAGES_CHECKED_ACCESS)
+#define rassert_image_access(condition, error_code, ...) rassert((condition), (error_code), ##__VA_ARGS__)
+#else
+#define rassert_image_access(condition, error_code, ...) ((void) 0)
+#endif
+
+// Initialization of pixels of a new image: ImageInit::Uninitialized skips zero-filling,
+// use it only when every pixel is overwritten right after construction.
+enum class ImageInit { Zeros, Uninitialized };
+
+// Pixels are stored row by row in a buffer from currentImageAllocator() (pooled per thread by default),
+// every row starts at kImageAlignment-aligned address, so rows are padded: use stride_elements() (or ptr/row)
+// to step between rows instead of width() * channels().
 template <typename T> class Image final {
   public:
     using value_type = T;
 
     Image();
-    Image(int width, int height, int channels);
-    Image(std::tuple<int, int, int> size);
+    Image(int width, int height, int channels, ImageInit init = ImageInit::Zeros);
+    Image(std::tuple<int, int, int> size, ImageInit init = ImageInit::Zeros);
+
+    Image(const Image &other);
+    Image(Image &&other) noexcept;
+    Image &operator=(const Image &other);
+    Image &operator=(Image &&other) noexcept;
+    ~Image();
 
     int width() const noexcept;
     int height() const noexcept;
     int channels() const noexcept;
     std::tuple<int, int, int> size() const noexcept;
 
-    // Number of elements in a single row (width * channels)
-    std::size_t stride_elements() const noexcept;
+    // Number of elements between the starts of consecutive rows (>= width * channels because of padding)
+    std::size_t stride_elements() const noexcept { return stride_; }
 
+    // First element of the first row (rows are not contiguous, see stride_elements())
     T *data() noexcept;
     const T *data() const noexcept;
+    // Tightly packed copy of all pixels (without row padding)
     std::vector<T> toVector() const;
 
     void fill(const T &value);
 
+    // Fast-path access for hot loops (unchecked, see LIBIMAGES_CHECKED_ACCESS above):
+    // element (j, i, c) is ptr(j)[i * channels() + c], row(j) spans width() * channels() elements.
+    T *ptr(int j) {
+        rassert_image_access(j >= 0 && j < h_, 78497218932, j, h_);
+        return data_ + static_cast<std::size_t>(j) * stride_;
+    }
+    const T *ptr(int j) const {
+        rassert_image_access(j >= 0 && j < h_, 78497218933, j, h_);
+        return data_ + static_cast<std::size_t>(j) * stride_;
+    }
+    std::span<T> row(int j) { return { ptr(j), row_elements() }; }
+    std::span<const T> row(int j) const { return { ptr(j), row_elements() }; }
+
     // Access for grayscale images (channels == 1)
     T &operator()(int j, int i, std::source_location loc = std::source_location::current());
     const T &operator()(int j, int i, std::source_location loc = std::source_location::current()) const;
@@ -39,9 +80,14 @@ template <typename T> class Image final {
     int w_ = 0;
     int h_ = 0;
     int c_ = 0;
-    std::vector<T> data_;
+    std::size_t stride_ = 0;
+    T *data_ = nullptr;
+    ImageAllocator *allocator_ = nullptr;
 
-    void init(int w, int h, int c);
+    std::size_t row_elements() const noexcept { return static_cast<std::size_t>(w_) * static_cast<std::size_t>(c_); }
+    std::size_t buffer_bytes() const noexcept { return stride_ * static_cast<std::size_t>(h_) * sizeof(T); }
+    void init(int w, int h, int c, ImageInit init);
+    void release() noexcept;
     void check_bounds_2d(int j, int i, std::source_location loc) const;
     void check_bounds_3d(int j, int i, int c, std::source_location loc) const;
     std::size_t index(int j, int i, int c) const;
@@ -0,0 +1,161 @@
+#include "image_allocator.h"
+
+#include <libbase/runtime_assert.h>
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace {
+
+std::atomic<std::size_t> requests_count{0};
+std::atomic<std::size_t> requests_bytes{0};
+std::atomic<std::size_t> allocations_count{0};
+std::atomic<std::size_t> allocations_bytes{0};
+
+class SystemImageAllocator final : public ImageAllocator {
+  public:
+    void *allocate(std::size_t bytes) override {
+        allocations_count.fetch_add(1, std::memory_order_relaxed);
+        allocations_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        return ::operator new(bytes, std::align_val_t{kImageAlignment});
+    }
+
+    void deallocate(void *p, std::size_t) noexcept override {
+        ::operator delete(p, std::align_val_t{kImageAlignment});
+    }
+};
+
+SystemImageAllocator system_allocator;
+
+// Per-thread cache of freed buffers. Buffers can be freed by another thread than the one that allocated them
+// (f.e. inside of OpenMP loops) - it is fine, they all come from the system allocator.
+class ThreadBufferPool final {
+  public:
+    // Bounds of cached memory per thread
+    static constexpr std::size_t kMaxBuffers = 16;
+    static constexpr std::size_t kMaxBytes = std::size_t(1) << 30;
+
+    ~ThreadBufferPool() {
+        for (const Buffer &b : buffers_)
+            system_allocator.deallocate(b.p, b.bytes);
+        buffers_.clear();
+        destroyed_ = true;
+    }
+
+    void *take(std::size_t bytes) {
+        for (std::size_t k = buffers_.size(); k-- > 0;) {
+            if (buffers_[k].bytes == bytes) {
+                void *p = buffers_[k].p;
+                cached_bytes_ -= bytes;
+                buffers_.erase(buffers_.begin() + static_cast<std::ptrdiff_t>(k));
+                return p;
+            }
+        }
+        return nullptr;
+    }
+
+    void put(void *p, std::size_t bytes) noexcept {
+        if (bytes > kMaxBytes) {
+            system_allocator.deallocate(p, bytes);
+            return;
+        }
+        try {
+            buffers_.push_back({p, bytes});
+        } catch (...) {
+            system_allocator.deallocate(p, bytes);
+            return;
+        }
+        cached_bytes_ += bytes;
+        // evict the oldest buffers
+        std::size_t evicted = 0;
+        while (buffers_.size() - evicted > kMaxBuffers || cached_bytes_ > kMaxBytes) {
+            system_allocator.deallocate(buffers_[evicted].p, buffers_[evicted].bytes);
+            cached_bytes_ -= buffers_[evicted].bytes;
+            ++evicted;
+        }
+        buffers_.erase(buffers_.begin(), buffers_.begin() + static_cast<std::ptrdiff_t>(evicted));
+    }
+
+    // images can outlive the pool of their thread (f.e. static images are destroyed after thread_local objects)
+    static bool destroyed() noexcept { return destroyed_; }
+
+  private:
+    struct Buffer {
+        void *p;
+        std::size_t bytes;
+    };
+
+    std::vector<Buffer> buffers_;
+    std::size_t cached_bytes_ = 0;
+    static thread_local bool destroyed_;
+};
+
+thread_local bool ThreadBufferPool::destroyed_ = false;
+
+ThreadBufferPool &threadBufferPool() {
+    thread_local ThreadBufferPool pool;
+    return pool;
+}
+
+class PooledImageAllocator final : public ImageAllocator {
+  public:
+    void *allocate(std::size_t bytes) override {
+        if (!ThreadBufferPool::destroyed()) {
+            if (void *p = threadBufferPool().take(bytes))
+                return p;
+        }
+        return system_allocator.allocate(bytes);
+    }
+
+    void deallocate(void *p, std::size_t bytes) noexcept override {
+        if (ThreadBufferPool::destroyed()) {
+            system_allocator.deallocate(p, bytes);
+            return;
+        }
+        threadBufferPool().put(p, bytes);
+    }
+};
+
+PooledImageAllocator pooled_allocator;
+
+thread_local ImageAllocator *current_allocator = nullptr;
+
+} // namespace
+
+ImageAllocator &systemImageAllocator() { return system_allocator; }
+
+ImageAllocator &pooledImageAllocator() { return pooled_allocator; }
+
+ImageAllocator &currentImageAllocator() { return current_allocator ? *current_allocator : pooled_allocator; }
+
+ImageAllocatorScope::ImageAllocatorScope(ImageAllocator &allocator) : previous_(current_allocator) {
+    current_allocator = &allocator;
+}
+
+ImageAllocatorScope::~ImageAllocatorScope() { current_allocator = previous_; }
+
+ImageAllocationStats imageAllocationStats() {
+    ImageAllocationStats stats;
+    stats.requests = requests_count.load(std::memory_order_relaxed);
+    stats.requested_bytes = requests_bytes.load(std::memory_order_relaxed);
+    stats.allocations = allocations_count.load(std::memory_order_relaxed);
+    stats.allocated_bytes = allocations_bytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void resetImageAllocationStats() {
+    requests_count = 0;
+    requests_bytes = 0;
+    allocations_count = 0;
+    allocations_bytes = 0;
+}
+
+void *allocateImageBuffer(ImageAllocator &allocator, std::size_t bytes) {
+    requests_count.fetch_add(1, std::memory_order_relaxed);
+    requests_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    void *p = allocator.allocate(bytes);
+    rassert(reinterpret_cast<std::uintptr_t>(p) % kImageAlignment == 0, 4398127314, "Misaligned image buffer");
+    return p;
+}
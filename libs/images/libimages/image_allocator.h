@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+
+// Image<T> rows start at addresses aligned to this (and are padded up to it) to keep SIMD loads aligned
+constexpr std::size_t kImageAlignment = 64;
+
+// Source of Image<T> pixel buffers. Buffers must be aligned to kImageAlignment.
+// Every image remembers the allocator it was created with and returns its buffer to it.
+class ImageAllocator {
+  public:
+    virtual ~ImageAllocator() = default;
+
+    virtual void *allocate(std::size_t bytes) = 0;
+    virtual void deallocate(void *p, std::size_t bytes) noexcept = 0;
+};
+
+// Aligned operator new/delete, no reuse.
+ImageAllocator &systemImageAllocator();
+
+// Default allocator: keeps a few recently freed buffers per thread and hands them out again for requests
+// of the same size (pipeline temporaries - grayscale, masks, morphology stages - have the same sizes),
+// falls back to systemImageAllocator().
+ImageAllocator &pooledImageAllocator();
+
+// Allocator used by images constructed on the current thread (pooledImageAllocator() by default).
+ImageAllocator &currentImageAllocator();
+
+// Makes allocator current for this thread until the scope ends:
+//   {
+//       ImageAllocatorScope scope(systemImageAllocator());
+//       image8u img(w, h, 3); // allocated without pooling
+//   }
+class ImageAllocatorScope final {
+  public:
+    explicit ImageAllocatorScope(ImageAllocator &allocator);
+    ~ImageAllocatorScope();
+
+    ImageAllocatorScope(const ImageAllocatorScope &) = delete;
+    ImageAllocatorScope &operator=(const ImageAllocatorScope &) = delete;
+
+  private:
+    ImageAllocator *previous_;
+};
+
+// Process-wide counters (all threads) of image buffers:
+// requests - buffers requested by images (any allocator),
+// allocations - buffers actually allocated from the system (so requests - allocations were reused from pools).
+struct ImageAllocationStats {
+    std::size_t requests = 0;
+    std::size_t requested_bytes = 0;
+    std::size_t allocations = 0;
+    std::size_t allocated_bytes = 0;
+};
+
+ImageAllocationStats imageAllocationStats();
+void resetImageAllocationStats();
+
+// Allocates buffer from allocator and counts the request in imageAllocationStats() (used by Image<T>).
+void *allocateImageBuffer(ImageAllocator &allocator, std::size_t bytes);
@@ -0,0 +1,131 @@
+#include "image_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <libimages/image.h>
+
+namespace {
+
+// Counts buffers and forwards to the system allocator
+class CountingAllocator final : public ImageAllocator {
+  public:
+    void *allocate(std::size_t bytes) override {
+        ++allocated;
+        return systemImageAllocator().allocate(bytes);
+    }
+    void deallocate(void *p, std::size_t bytes) noexcept override {
+        ++deallocated;
+        systemImageAllocator().deallocate(p, bytes);
+    }
+
+    int allocated = 0;
+    int deallocated = 0;
+};
+
+bool isAligned(const void *p) { return reinterpret_cast<std::uintptr_t>(p) % kImageAlignment == 0; }
+
+} // namespace
+
+TEST(image_allocator, rowsAreAlignedAndPadded) {
+    image8u img(33, 5, 3);
+    EXPECT_EQ(img.stride_elements(), 128u);
+    EXPECT_EQ(img.row(0).size(), 33u * 3u);
+    for (int j = 0; j < img.height(); ++j)
+        EXPECT_TRUE(isAligned(img.ptr(j)));
+
+    image32f gray(20, 4, 1);
+    EXPECT_EQ(gray.stride_elements(), 32u);
+    for (int j = 0; j < gray.height(); ++j)
+        EXPECT_TRUE(isAligned(gray.ptr(j)));
+
+    // padding is not visible in packed copies
+    img.fill(7);
+    std::vector<std::uint8_t> packed = img.toVector();
+    EXPECT_EQ(packed.size(), 33u * 5u * 3u);
+    for (std::uint8_t v : packed)
+        EXPECT_EQ(v, 7);
+}
+
+TEST(image_allocator, copiesAndMovesKeepPixels) {
+    image8u a(10, 3, 1);
+    a(2, 9) = 239;
+
+    image8u b = a;
+    EXPECT_NE(b.data(), a.data());
+    EXPECT_EQ(b(2, 9), 239);
+
+    image8u c(4, 4, 1);
+    c = b;
+    EXPECT_EQ(c.width(), 10);
+    EXPECT_EQ(c(2, 9), 239);
+
+    const std::uint8_t *pixels = c.data();
+    image8u d = std::move(c);
+    EXPECT_EQ(d.data(), pixels);
+    EXPECT_EQ(d(2, 9), 239);
+    EXPECT_EQ(c.data(), nullptr);
+    EXPECT_EQ(c.width(), 0);
+
+    a = std::move(d);
+    EXPECT_EQ(a.data(), pixels);
+}
+
+TEST(image_allocator, pooledBuffersAreReused) {
+    ImageAllocatorScope scope(pooledImageAllocator());
+
+    const std::uint8_t *first = nullptr;
+    {
+        image8u img(123, 45, 1);
+        first = img.data();
+    }
+
+    resetImageAllocationStats();
+    {
+        image8u img(123, 45, 1);
+        EXPECT_EQ(img.data(), first);
+        // reused buffers are zeroed like new ones
+        for (int j = 0; j < img.height(); ++j)
+            for (int i = 0; i < img.width(); ++i)
+                EXPECT_EQ(img(j, i), 0);
+    }
+    const ImageAllocationStats stats = imageAllocationStats();
+    EXPECT_EQ(stats.requests, 1u);
+    EXPECT_EQ(stats.allocations, 0u);
+}
+
+TEST(image_allocator, scopeSelectsAllocator) {
+    CountingAllocator counting;
+    {
+        ImageAllocatorScope scope(counting);
+        EXPECT_EQ(&currentImageAllocator(), &counting);
+
+        image8u a(8, 8, 1);
+        image8u b = a;
+        EXPECT_EQ(counting.allocated, 2);
+    }
+    EXPECT_EQ(counting.deallocated, 2);
+    EXPECT_EQ(&currentImageAllocator(), &pooledImageAllocator());
+
+    // image returns its buffer to its own allocator even outside of the scope
+    image8u *img = nullptr;
+    {
+        ImageAllocatorScope scope(counting);
+        img = new image8u(8, 8, 1);
+    }
+    delete img;
+    EXPECT_EQ(counting.allocated, 3);
+    EXPECT_EQ(counting.deallocated, 3);
+}
+
+TEST(image_allocator, systemAllocatorDoesNotPool) {
+    ImageAllocatorScope scope(systemImageAllocator());
+    { image8u img(64, 64, 3); }
+
+    resetImageAllocationStats();
+    { image8u img(64, 64, 3, ImageInit::Uninitialized); }
+    const ImageAllocationStats stats = imageAllocationStats();
+    EXPECT_EQ(stats.requests, 1u);
+    EXPECT_EQ(stats.allocations, 1u);
+    EXPECT_EQ(stats.allocated_bytes, 192u * 64u);
+}
@@ -60,15 +60,16 @@ image8u load_image(const std::string &path) {
         rassert(false, "stbi_load failed", path, stbi_failure_reason());
     }
 
-    image8u img(w, h, req_comp);
-    const std::size_t n =
-        static_cast<std::size_t>(w) * static_cast<std::size_t>(h) * static_cast<std::size_t>(req_comp);
-    std::memcpy(img.data(), ptr, n * sizeof(std::uint8_t));
+    image8u img(w, h, req_comp, ImageInit::Uninitialized);
+    const std::size_t row_bytes = static_cast<std::size_t>(w) * static_cast<std::size_t>(req_comp);
+    for (int j = 0; j < h; ++j) {
+        std::memcpy(img.ptr(j), ptr + static_cast<std::size_t>(j) * row_bytes, row_bytes * sizeof(std::uint8_t));
+    }
     stbi_image_free(ptr);
     return img;
 }
 
-void save_image(const image8u &img, const std::string &path, int jpg_quality) {
+void save_image(ImageView<const std::uint8_t> img, const std::string &path, int jpg_quality) {
     rassert(img.width() > 0 && img.height() > 0, "Empty image");
     rassert(img.channels() == 1 || img.channels() == 3 || img.channels() == 4, "Unsupported channel count",
             img.channels());
@@ -81,7 +82,7 @@ void save_image(const image8u &img, const std::string &path, int jpg_quality) {
     const int c = img.channels();
 
     if (ext == "png") {
-        const int stride_bytes = w * c;
+        const int stride_bytes = static_cast<int>(img.stride_elements());
         const int ok = stbi_write_png(path.c_str(), w, h, c, img.data(), stride_bytes);
         rassert(ok != 0, "stbi_write_png failed", path);
         return;
@@ -94,14 +95,13 @@ void save_image(const image8u &img, const std::string &path, int jpg_quality) {
             // Drop alpha for JPEG.
             std::vector<std::uint8_t> rgb(static_cast<std::size_t>(w) * static_cast<std::size_t>(h) * 3);
             for (int j = 0; j < h; ++j) {
+                const std::uint8_t *src = img.ptr(j);
                 for (int i = 0; i < w; ++i) {
-                    const std::size_t src =
-                        (static_cast<std::size_t>(j) * static_cast<std::size_t>(w) + static_cast<std::size_t>(i)) * 4;
                     const std::size_t dst =
                         (static_cast<std::size_t>(j) * static_cast<std::size_t>(w) + static_cast<std::size_t>(i)) * 3;
-                    rgb[dst + 0] = img.data()[src + 0];
-                    rgb[dst + 1] = img.data()[src + 1];
-                    rgb[dst + 2] = img.data()[src + 2];
+                    rgb[dst + 0] = src[4 * i + 0];
+                    rgb[dst + 1] = src[4 * i + 1];
+                    rgb[dst + 2] = src[4 * i + 2];
                 }
             }
             const int ok = stbi_write_jpg(path.c_str(), w, h, 3, rgb.data(), jpg_quality);
@@ -109,7 +109,18 @@ void save_image(const image8u &img, const std::string &path, int jpg_quality) {
             return;
         }
 
-        const int ok = stbi_write_jpg(path.c_str(), w, h, c, img.data(), jpg_quality);
+        // stb JPEG writer expects tightly packed rows, so padded or ROI rows are packed first.
+        std::vector<std::uint8_t> packed;
+        const std::uint8_t *pixels = img.data();
+        const std::size_t row_bytes = static_cast<std::size_t>(w) * static_cast<std::size_t>(c);
+        if (img.stride_elements() != row_bytes) {
+            packed.resize(row_bytes * static_cast<std::size_t>(h));
+            for (int j = 0; j < h; ++j) {
+                std::memcpy(packed.data() + static_cast<std::size_t>(j) * row_bytes, img.ptr(j), row_bytes);
+            }
+            pixels = packed.data();
+        }
+        const int ok = stbi_write_jpg(path.c_str(), w, h, c, pixels, jpg_quality);
         rassert(ok != 0, "stbi_write_jpg failed", path);
         return;
     }
@@ -167,11 +178,10 @@ static image8u load_png(const std::string &path) {
     rassert(rowbytes == static_cast<png_size_t>(w) * static_cast<png_size_t>(channels), "Unexpected PNG rowbytes", path,
             static_cast<unsigned long>(rowbytes));
 
-    image8u img(static_cast<int>(w), static_cast<int>(h), channels);
+    image8u img(static_cast<int>(w), static_cast<int>(h), channels, ImageInit::Uninitialized);
     std::vector<png_bytep> rows(static_cast<std::size_t>(h));
     for (png_uint_32 j = 0; j < h; ++j) {
-        rows[static_cast<std::size_t>(j)] =
-            reinterpret_cast<png_bytep>(img.data() + static_cast<std::size_t>(j) * static_cast<std::size_t>(rowbytes));
+        rows[static_cast<std::size_t>(j)] = reinterpret_cast<png_bytep>(img.ptr(static_cast<int>(j)));
     }
 
     png_read_image(png, rows.data());
@@ -203,7 +213,7 @@ static image8u load_jpeg(const std::string &path) {
     const int channels = static_cast<int>(cinfo.output_components);
     rassert(channels == 3, "Unexpected JPEG components", channels);
 
-    image8u img(w, h, 3);
+    image8u img(w, h, 3, ImageInit::Uninitialized);
 
     std::vector<JSAMPLE> row(static_cast<std::size_t>(w) * 3);
     while (cinfo.output_scanline < cinfo.output_height) {
@@ -212,7 +222,7 @@ static image8u load_jpeg(const std::string &path) {
         rassert(got == 1, "jpeg_read_scanlines failed", path);
 
         const int j = static_cast<int>(cinfo.output_scanline) - 1;
-        std::memcpy(img.data() + static_cast<std::size_t>(j) * static_cast<std::size_t>(w) * 3, row.data(), row.size());
+        std::memcpy(img.ptr(j), row.data(), row.size());
     }
 
     jpeg_finish_decompress(&cinfo);
@@ -238,7 +248,7 @@ image8u load_image(const std::string &path) {
     return {};
 }
 
-static void save_png(const image8u &img, const std::string &path) {
+static void save_png(ImageView<const std::uint8_t> img, const std::string &path) {
     FILE *fp = std::fopen(path.c_str(), "wb");
     rassert(fp != nullptr, "Failed to open file for writing", path);
 
@@ -274,11 +284,9 @@ static void save_png(const image8u &img, const std::string &path) {
 
     png_write_info(png, info);
 
-    const std::size_t rowbytes = static_cast<std::size_t>(w) * static_cast<std::size_t>(c);
     std::vector<png_bytep> rows(static_cast<std::size_t>(h));
     for (int j = 0; j < h; ++j) {
-        rows[static_cast<std::size_t>(j)] = const_cast<png_bytep>(
-            reinterpret_cast<png_const_bytep>(img.data() + static_cast<std::size_t>(j) * rowbytes));
+        rows[static_cast<std::size_t>(j)] = const_cast<png_bytep>(reinterpret_cast<png_const_bytep>(img.ptr(j)));
     }
 
     png_write_image(png, rows.data());
@@ -288,7 +296,7 @@ static void save_png(const image8u &img, const std::string &path) {
     std::fclose(fp);
 }
 
-static void save_jpeg(const image8u &img, const std::string &path, int quality) {
+static void save_jpeg(ImageView<const std::uint8_t> img, const std::string &path, int quality) {
     rassert(quality >= 1 && quality <= 100, "Invalid JPEG quality", quality);
 
     const int w = img.width();
@@ -299,22 +307,22 @@ static void save_jpeg(const image8u &img, const std::string &path, int quality)
     // JPEG has no alpha
     std::vector<std::uint8_t> tmp;
     const std::uint8_t *src = img.data();
+    std::size_t src_stride = img.stride_elements();
     int write_c = c;
 
     if (c == 4) {
         tmp.resize(static_cast<std::size_t>(w) * static_cast<std::size_t>(h) * 3);
         for (int j = 0; j < h; ++j) {
             for (int i = 0; i < w; ++i) {
-                const std::size_t s =
-                    (static_cast<std::size_t>(j) * static_cast<std::size_t>(w) + static_cast<std::size_t>(i)) * 4;
                 const std::size_t d =
                     (static_cast<std::size_t>(j) * static_cast<std::size_t>(w) + static_cast<std::size_t>(i)) * 3;
-                tmp[d + 0] = src[s + 0];
-                tmp[d + 1] = src[s + 1];
-                tmp[d + 2] = src[s + 2];
+                tmp[d + 0] = img(j, i, 0);
+                tmp[d + 1] = img(j, i, 1);
+                tmp[d + 2] = img(j, i, 2);
             }
         }
         src = tmp.data();
+        src_stride = static_cast<std::size_t>(w) * 3;
         write_c = 3;
     }
 
@@ -336,10 +344,9 @@ static void save_jpeg(const image8u &img, const std::string &path, int quality)
     jpeg_set_quality(&cinfo, quality, TRUE);
     jpeg_start_compress(&cinfo, TRUE);
 
-    const std::size_t rowbytes = static_cast<std::size_t>(w) * static_cast<std::size_t>(write_c);
     while (cinfo.next_scanline < cinfo.image_height) {
         JSAMPLE *row = const_cast<JSAMPLE *>(
-            reinterpret_cast<const JSAMPLE *>(src + static_cast<std::size_t>(cinfo.next_scanline) * rowbytes));
+            reinterpret_cast<const JSAMPLE *>(src + static_cast<std::size_t>(cinfo.next_scanline) * src_stride));
         JSAMPROW rowptr = row;
         const JDIMENSION written = jpeg_write_scanlines(&cinfo, &rowptr, 1);
         rassert(written == 1, "jpeg_write_scanlines failed", path);
@@ -350,7 +357,8 @@ static void save_jpeg(const image8u &img, const std::string &path, int quality)
     std::fclose(fp);
 }
 
-void save_image(const image8u &img, const std::string &path, int jpg_quality) {
+void save_image(ImageView<const std::uint8_t> view, const std::string &path, int jpg_quality) {
+    const ImageView<const std::uint8_t> img = view;
     rassert(img.width() > 0 && img.height() > 0, "Empty image");
     rassert(img.channels() == 1 || img.channels() == 3 || img.channels() == 4, "Unsupported channel count",
             img.channels());
@@ -3,8 +3,9 @@
 #include <string>
 
 #include <libimages/image.h>
+#include <libimages/image_view.h>
 
 image8u load_image(const std::string &path);
 
 // Saves 1/3/4-channel 8-bit image. For JPEG, alpha is dropped.
-void save_image(const image8u &img, const std::string &path, int jpg_quality = 95);
+void save_image(ImageView<const std::uint8_t> img, const std::string &path, int jpg_quality = 95);
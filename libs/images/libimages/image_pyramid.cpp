@@ -0,0 +1,126 @@
+#include "image_pyramid.h"
+
+#include <libbase/runtime_assert.h>
+#include <libimages/algorithms/downsample.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+template <typename T>
+inline T from_float(float v) {
+    if constexpr (std::is_same_v<T, std::uint8_t>) {
+        return static_cast<std::uint8_t>(std::clamp(v + 0.5f, 0.0f, 255.0f));
+    } else if constexpr (std::is_integral_v<T>) {
+        return static_cast<T>(std::lround(v));
+    } else {
+        return static_cast<T>(v);
+    }
+}
+
+constexpr int kTaps = 4;
+constexpr float kBinomial[kTaps] = {1.0f / 8, 3.0f / 8, 3.0f / 8, 1.0f / 8};
+
+inline int clampi(int v, int hi) { return std::max(0, std::min(hi, v)); }
+
+} // namespace
+
+template <typename T>
+Image<T> pyramidDown(const Image<T> &image) {
+    const int W = image.width();
+    const int H = image.height();
+    const int C = image.channels();
+    rassert(W > 1 || H > 1, 6128734501, W, H);
+    const int w = (W + 1) / 2;
+    const int h = (H + 1) / 2;
+
+    // output pixel x is centered between source pixels 2x and 2x + 1 (taps 2x - 1 .. 2x + 2), borders are clamped
+    image32f tmp(w, H, C, ImageInit::Uninitialized);
+    #pragma omp parallel for schedule(static)
+    for (int j = 0; j < H; ++j) {
+        const T *src = image.ptr(j);
+        float *dst = tmp.ptr(j);
+        for (int x = 0; x < w; ++x) {
+            int taps[kTaps];
+            for (int k = 0; k < kTaps; ++k)
+                taps[k] = clampi(2 * x + k - 1, W - 1) * C;
+            for (int c = 0; c < C; ++c) {
+                float sum = 0.0f;
+                for (int k = 0; k < kTaps; ++k)
+                    sum += kBinomial[k] * static_cast<float>(src[taps[k] + c]);
+                dst[x * C + c] = sum;
+            }
+        }
+    }
+
+    // the same for rows
+    Image<T> out(w, h, C, ImageInit::Uninitialized);
+    const int rowSize = w * C;
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < h; ++y) {
+        const float *rows[kTaps];
+        for (int k = 0; k < kTaps; ++k)
+            rows[k] = tmp.ptr(clampi(2 * y + k - 1, H - 1));
+        T *dst = out.ptr(y);
+        for (int i = 0; i < rowSize; ++i) {
+            float sum = 0.0f;
+            for (int k = 0; k < kTaps; ++k)
+                sum += kBinomial[k] * rows[k][i];
+            dst[i] = from_float<T>(sum);
+        }
+    }
+    return out;
+}
+
+template <typename T>
+ImagePyramid<T>::ImagePyramid(Image<T> image) {
+    rassert(image.width() > 0 && image.height() > 0, 6128734502);
+    width_ = image.width();
+    height_ = image.height();
+    int w = width_;
+    int h = height_;
+    levels_ = 1;
+    while (w > 1 && h > 1) {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+        ++levels_;
+    }
+    levels_built_.push_back(std::move(image));
+}
+
+template <typename T>
+const Image<T> &ImagePyramid<T>::level(int k) {
+    rassert(k >= 0 && k < levels_, 6128734503, k, levels_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // std::deque::push_back doesn't move already built levels
+    while (static_cast<int>(levels_built_.size()) <= k) {
+        levels_built_.push_back(pyramidDown(levels_built_.back()));
+    }
+    return levels_built_[k];
+}
+
+template <typename T>
+Image<T> ImagePyramid<T>::resize(int w, int h) {
+    rassert(w > 0 && h > 0, 6128734504, w, h);
+    // pixel x of level k covers [x * 2^k, (x + 1) * 2^k) of the image, odd sizes are rounded up,
+    // so level k covers the whole image with its top-left W / 2^k x H / 2^k part
+    double extentW = width_;
+    double extentH = height_;
+    int k = 0;
+    while (k + 1 < levels_ && extentW / 2 >= w && extentH / 2 >= h) {
+        extentW /= 2;
+        extentH /= 2;
+        ++k;
+    }
+    return downsampleArea(ImageView<const T>(level(k)), extentW, extentH, w, h);
+}
+
+template class ImagePyramid<std::uint8_t>;
+template class ImagePyramid<float>;
+
+template Image<std::uint8_t> pyramidDown(const Image<std::uint8_t> &image);
+template Image<float> pyramidDown(const Image<float> &image);
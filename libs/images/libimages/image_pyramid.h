@@ -0,0 +1,43 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include <libimages/image.h>
+
+// Gaussian image pyramid: level 0 is the image itself, level k + 1 is level k blurred with the binomial
+// kernel [1 3 3 1] / 8 (sigma ~ 0.9) and decimated by 2 in both axes (size (w + 1) / 2 x (h + 1) / 2).
+// The even kernel keeps pixel centers consistent with DownsampleMethod::Area: pixel x of level k + 1 is centered
+// between pixels 2x and 2x + 1 of level k, so levels and area-resampled previews line up.
+// Every level is built from the previous one, so all levels together cost O(pixels of the image).
+//
+// Levels are built lazily on the first request and cached; level() and resize() may be called from several threads,
+// references to built levels stay valid for the lifetime of the pyramid.
+template <typename T>
+class ImagePyramid final {
+  public:
+    explicit ImagePyramid(Image<T> image);
+
+    ImagePyramid(const ImagePyramid &) = delete;
+    ImagePyramid &operator=(const ImagePyramid &) = delete;
+
+    // Number of levels down to the first one with width or height equal to 1
+    int levels() const noexcept { return levels_; }
+
+    const Image<T> &level(int k);
+
+    // Image of exactly w x h pixels: the coarsest level that still has at least w x h pixels per image extent,
+    // area-averaged down to w x h (i.e. anti-aliased without blurring the full-resolution image)
+    Image<T> resize(int w, int h);
+
+  private:
+    int width_ = 0;
+    int height_ = 0;
+    int levels_ = 0;
+    std::mutex mutex_;
+    std::deque<Image<T>> levels_built_;
+};
+
+// One pyramid step: binomial blur + decimation by 2 (exposed for tests and for one-off use)
+template <typename T>
+Image<T> pyramidDown(const Image<T> &image);
@@ -0,0 +1,93 @@
+#include "image_pyramid.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/algorithms/downsample.h>
+#include <libimages/tests_utils.h>
+
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+image8u makeSmoothImage(int w, int h) {
+    image8u img(w, h, 3);
+    for (int j = 0; j < h; ++j)
+        for (int i = 0; i < w; ++i) {
+            img(j, i, 0) = static_cast<std::uint8_t>(127.5 + 127.5 * std::sin(i * 0.05) * std::cos(j * 0.03));
+            img(j, i, 1) = static_cast<std::uint8_t>((i + j) % 256);
+            img(j, i, 2) = 77;
+        }
+    return img;
+}
+
+} // namespace
+
+TEST(image_pyramid, levelSizes) {
+    ImagePyramid<std::uint8_t> pyramid(image8u(101, 40, 1));
+    // 101x40 -> 51x20 -> 26x10 -> 13x5 -> 7x3 -> 4x2 -> 2x1
+    EXPECT_EQ(pyramid.levels(), 7);
+    const int expectedW[] = {101, 51, 26, 13, 7, 4, 2};
+    const int expectedH[] = {40, 20, 10, 5, 3, 2, 1};
+    for (int k = 0; k < pyramid.levels(); ++k) {
+        EXPECT_EQ(pyramid.level(k).width(), expectedW[k]);
+        EXPECT_EQ(pyramid.level(k).height(), expectedH[k]);
+    }
+    EXPECT_THROW(pyramid.level(pyramid.levels()), assertion_error);
+}
+
+TEST(image_pyramid, levelsAreCached) {
+    ImagePyramid<std::uint8_t> pyramid(makeSmoothImage(64, 48));
+    const image8u *level3 = &pyramid.level(3);
+    EXPECT_EQ(&pyramid.level(3), level3);
+    pyramid.level(pyramid.levels() - 1);
+    // building deeper levels doesn't move the built ones
+    EXPECT_EQ(&pyramid.level(3), level3);
+}
+
+TEST(image_pyramid, constantImageStaysConstant) {
+    image32f img(37, 23, 1);
+    img.fill(0.25f);
+    ImagePyramid<float> pyramid(img);
+    for (int k = 0; k < pyramid.levels(); ++k) {
+        const image32f &level = pyramid.level(k);
+        for (int j = 0; j < level.height(); ++j)
+            for (int i = 0; i < level.width(); ++i)
+                EXPECT_NEAR(level(j, i), 0.25f, 1e-6f);
+    }
+}
+
+TEST(image_pyramid, linearRampKeepsPixelCenters) {
+    // f(x, y) = x + 2y: pixel x of the next level is centered at 2x + 0.5, so away from borders it is exactly the ramp there
+    image32f img(32, 16, 1);
+    for (int j = 0; j < img.height(); ++j)
+        for (int i = 0; i < img.width(); ++i)
+            img(j, i) = static_cast<float>(i + 2 * j);
+    const image32f down = pyramidDown(img);
+    ASSERT_EQ(down.width(), 16);
+    ASSERT_EQ(down.height(), 8);
+    for (int j = 1; j < down.height() - 1; ++j)
+        for (int i = 1; i < down.width() - 1; ++i)
+            EXPECT_NEAR(down(j, i), (2 * i + 0.5f) + 2 * (2 * j + 0.5f), 1e-4f);
+}
+
+TEST(image_pyramid, resizeMatchesAreaDownsample) {
+    const image8u img = makeSmoothImage(400, 300);
+    ImagePyramid<std::uint8_t> pyramid(img);
+
+    const image8u preview = pyramid.resize(50, 37);
+    EXPECT_EQ(preview.width(), 50);
+    EXPECT_EQ(preview.height(), 37);
+    EXPECT_EQ(preview.channels(), 3);
+
+    // starts from a coarser level but matches area averaging of the full-resolution image on smooth content
+    // (the border pixels differ a bit because pyramid levels are blurred with clamped borders)
+    const image8u reference = downsample(img, 50, 37, DownsampleMethod::Area);
+    for (int j = 1; j < 36; ++j)
+        for (int i = 1; i < 49; ++i)
+            EXPECT_NEAR(preview(j, i, 0), reference(j, i, 0), 4);
+
+    // the same size as one of the levels is exactly that level
+    const image8u level2 = pyramid.resize(100, 75);
+    EXPECT_EQ(level2.toVector(), pyramid.level(2).toVector());
+}
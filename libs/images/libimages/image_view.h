@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include <libbase/bbox2.h>
+#include <libimages/image.h>
+
+// Non-owning strided 2D view over pixels: width x height pixels, channels interleaved values per pixel,
+// consecutive rows are stride_elements() elements apart. The viewed memory must outlive the view.
+// All access is unchecked fast-path access (see LIBIMAGES_CHECKED_ACCESS in image.h).
+//
+// ImageView<T> writes pixels, ImageView<const T> only reads them, both are implicitly created from Image<T>:
+//   ImageView<const std::uint8_t> view = image;
+// and can describe a rectangular region of interest of the parent image without copying it:
+//   ImageView<const std::uint8_t> part = view.subview(bbox);
+template <typename T> class ImageView final {
+  public:
+    using value_type = std::remove_const_t<T>;
+
+    ImageView() = default;
+
+    ImageView(T *data, int width, int height, int channels, std::size_t stride_elements)
+        : data_(data), w_(width), h_(height), c_(channels), stride_(stride_elements) {
+        rassert(width >= 0 && height >= 0 && channels > 0, 78497218934, width, height, channels);
+        rassert(stride_elements >= static_cast<std::size_t>(width) * static_cast<std::size_t>(channels), 78497218935,
+                stride_elements, width, channels);
+    }
+
+    ImageView(Image<value_type> &image)
+        : ImageView(image.data(), image.width(), image.height(), image.channels(), image.stride_elements()) {}
+
+    ImageView(const Image<value_type> &image)
+        requires std::is_const_v<T>
+        : ImageView(image.data(), image.width(), image.height(), image.channels(), image.stride_elements()) {}
+
+    operator ImageView<const value_type>() const
+        requires(!std::is_const_v<T>)
+    {
+        return { data_, w_, h_, c_, stride_ };
+    }
+
+    int width() const noexcept { return w_; }
+    int height() const noexcept { return h_; }
+    int channels() const noexcept { return c_; }
+    std::size_t stride_elements() const noexcept { return stride_; }
+
+    T *data() const noexcept { return data_; }
+
+    // Element (j, i, c) is ptr(j)[i * channels() + c], row(j) spans width() * channels() elements.
+    T *ptr(int j) const {
+        rassert_image_access(j >= 0 && j < h_, 78497218936, j, h_);
+        return data_ + static_cast<std::size_t>(j) * stride_;
+    }
+    std::span<T> row(int j) const {
+        return { ptr(j), static_cast<std::size_t>(w_) * static_cast<std::size_t>(c_) };
+    }
+
+    // Region of interest [roi.min, roi.max) in view coordinates, shares pixels with this view.
+    ImageView subview(const bbox2i &roi) const {
+        rassert(!roi.is_empty(), 78497218940);
+        rassert(roi.min.x >= 0 && roi.min.y >= 0 && roi.max.x <= w_ && roi.max.y <= h_, 78497218941,
+                roi.min.x, roi.min.y, roi.max.x, roi.max.y, w_, h_);
+        return { ptr(roi.min.y) + static_cast<std::size_t>(roi.min.x) * static_cast<std::size_t>(c_), roi.width(),
+                 roi.height(), c_, stride_ };
+    }
+
+    // Deep copy of the viewed pixels into a new (owning) image.
+    Image<value_type> toImage() const {
+        Image<value_type> copy(w_, h_, c_, ImageInit::Uninitialized);
+        for (int j = 0; j < h_; ++j) {
+            const std::span<T> src = row(j);
+            std::copy(src.begin(), src.end(), copy.ptr(j));
+        }
+        return copy;
+    }
+
+    T &operator()(int j, int i) const {
+        rassert_image_access(c_ == 1, 78497218937, c_);
+        rassert_image_access(i >= 0 && i < w_, 78497218938, i, w_);
+        return ptr(j)[i];
+    }
+    T &operator()(int j, int i, int c) const {
+        rassert_image_access(i >= 0 && i < w_ && c >= 0 && c < c_, 78497218939, i, w_, c, c_);
+        return ptr(j)[static_cast<std::size_t>(i) * static_cast<std::size_t>(c_) + static_cast<std::size_t>(c)];
+    }
+
+  private:
+    T *data_ = nullptr;
+    int w_ = 0;
+    int h_ = 0;
+    int c_ = 0;
+    std::size_t stride_ = 0;
+};
+
+template <typename T> ImageView(Image<T> &) -> ImageView<T>;
+template <typename T> ImageView(const Image<T> &) -> ImageView<const T>;
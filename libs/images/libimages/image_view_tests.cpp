@@ -0,0 +1,103 @@
+#include "image_view.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+static image8u makeNumbered(int w, int h, int c) {
+    image8u img(w, h, c);
+    for (int j = 0; j < h; ++j)
+        for (int i = 0; i < w; ++i)
+            for (int k = 0; k < c; ++k)
+                img(j, i, k) = static_cast<std::uint8_t>((j * w + i) * c + k);
+    return img;
+}
+
+TEST(image, rowsMatchCheckedAccess) {
+    const image8u img = makeNumbered(7, 5, 3);
+
+    for (int j = 0; j < img.height(); ++j) {
+        std::span<const std::uint8_t> row = img.row(j);
+        ASSERT_EQ(row.size(), 7u * 3u);
+        ASSERT_EQ(row.data(), img.ptr(j));
+        for (int i = 0; i < img.width(); ++i)
+            for (int c = 0; c < img.channels(); ++c)
+                EXPECT_EQ(row[i * 3 + c], img(j, i, c));
+    }
+}
+
+TEST(image_view, viewsImagePixels) {
+    image8u img = makeNumbered(6, 4, 1);
+
+    ImageView view = img;
+    static_assert(std::is_same_v<decltype(view), ImageView<std::uint8_t>>);
+    EXPECT_EQ(view.width(), 6);
+    EXPECT_EQ(view.height(), 4);
+    EXPECT_EQ(view.channels(), 1);
+    EXPECT_EQ(view.stride_elements(), img.stride_elements());
+
+    for (int j = 0; j < img.height(); ++j)
+        for (int i = 0; i < img.width(); ++i)
+            EXPECT_EQ(view(j, i), img(j, i));
+
+    // writes through the view are visible in the image
+    view(2, 3) = 239;
+    EXPECT_EQ(img(2, 3), 239);
+
+    const image8u &cimg = img;
+    ImageView cview = cimg;
+    static_assert(std::is_same_v<decltype(cview), ImageView<const std::uint8_t>>);
+    EXPECT_EQ(cview(2, 3), 239);
+
+    ImageView<const std::uint8_t> converted = view;
+    EXPECT_EQ(converted.data(), img.data());
+}
+
+TEST(image_view, stridedRows) {
+    // 3x2 RGB pixels inside of rows of 16 elements
+    std::vector<std::uint8_t> buffer(16 * 2, 0);
+    ImageView<std::uint8_t> view(buffer.data(), 3, 2, 3, 16);
+
+    view(1, 2, 1) = 7;
+    EXPECT_EQ(buffer[16 + 2 * 3 + 1], 7);
+    EXPECT_EQ(view.row(1).size(), 9u);
+    EXPECT_EQ(view.ptr(1), buffer.data() + 16);
+}
+
+#if defined(LIBIMAGES_CHECKED_ACCESS)
+TEST(image_view, checkedAccessThrowsOutOfBounds) {
+    image8u img(4, 4, 1);
+    ImageView<const std::uint8_t> view = img;
+    EXPECT_THROW(view(4, 0), assertion_error);
+    EXPECT_THROW(view(0, -1), assertion_error);
+    EXPECT_THROW(img.ptr(4), assertion_error);
+}
+#endif
+
+TEST(image_view, subviewSharesPixels) {
+    image8u img = makeNumbered(10, 8, 3);
+    ImageView<const std::uint8_t> view = img;
+
+    bbox2i roi;
+    roi.include_pixel(2, 3);
+    roi.include_pixel(6, 4);
+    ImageView<const std::uint8_t> part = view.subview(roi);
+
+    EXPECT_EQ(part.width(), 5);
+    EXPECT_EQ(part.height(), 2);
+    EXPECT_EQ(part.stride_elements(), img.stride_elements());
+    for (int j = 0; j < part.height(); ++j)
+        for (int i = 0; i < part.width(); ++i)
+            for (int c = 0; c < 3; ++c)
+                EXPECT_EQ(part(j, i, c), img(3 + j, 2 + i, c));
+
+    image8u copy = part.toImage();
+    EXPECT_EQ(copy.width(), 5);
+    EXPECT_EQ(copy.height(), 2);
+    EXPECT_EQ(copy(1, 4, 2), img(4, 6, 2));
+
+    bbox2i outside;
+    outside.include_pixel(9, 7);
+    outside.include_pixel(10, 7);
+    EXPECT_THROW(view.subview(outside), assertion_error);
+}
@@ -1,9 +1,12 @@
 #include "tests_utils.h"
 
+#include <libbase/fast_random.h>
 #include <libbase/runtime_assert.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 
 std::string getUnitCaseDebugDir() {
     const ::testing::TestInfo* info = ::testing::UnitTest::GetInstance()->current_test_info();
@@ -13,4 +16,20 @@ std::string getUnitCaseDebugDir() {
     const char* suite = info->test_suite_name();
     const char* name  = info->name();
     return "debug/unit-tests/" + std::string(suite) + "/" + std::string(name) + "/";
-}
\ No newline at end of file
+}
+image8u makeRandomMask(int w, int h, int rects, std::uint32_t seed) {
+    FastRandom r(seed);
+    image8u img(w, h, 1);
+    for (int k = 0; k < rects; ++k) {
+        const int x0 = r.nextInt(0, w - 1);
+        const int y0 = r.nextInt(0, h - 1);
+        const int x1 = std::min(w - 1, x0 + r.nextInt(0, w / 3));
+        const int y1 = std::min(h - 1, y0 + r.nextInt(0, h / 3));
+        for (int j = y0; j <= y1; ++j)
+            for (int i = x0; i <= x1; ++i)
+                img(j, i) = 255;
+    }
+    for (int k = 0; k < w * h / 20; ++k)
+        img(r.nextInt(0, h - 1), r.nextInt(0, w - 1)) = r.nextInt(0, 1) ? 255 : 0;
+    return img;
+}
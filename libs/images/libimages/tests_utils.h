@@ -1,6 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
+#include <libimages/image.h>
+
 
 std::string getUnitCaseDebugDir();
+
+// Binary 0/255 mask of random rectangles with salt and pepper noise
+image8u makeRandomMask(int w, int h, int rects, std::uint32_t seed);
@@ -0,0 +1,665 @@
+#include "assembly.h"
+
+#include <libbase/runtime_assert.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <queue>
+
+namespace {
+
+constexpr int kSides = 4;
+constexpr int kDx[kSides] = {0, 1, 0, -1};
+constexpr int kDy[kSides] = {-1, 0, 1, 0};
+
+// Difference of two sides (rows of the table)
+using EdgeCost = std::function<float(std::size_t, std::size_t)>;
+
+// Place piece so that its side touches side from_side of the placed piece from_piece
+struct Move {
+    bool buddies;
+    float difference;
+    int from_piece;
+    int from_side;
+    int piece;
+    int side;
+};
+
+// Best buddies first, then by difference (and by pieces and sides, so the order never depends on the heap)
+bool worse(const Move &a, const Move &b) {
+    if (a.buddies != b.buddies)
+        return b.buddies;
+    if (a.difference != b.difference)
+        return a.difference > b.difference;
+    return std::tie(a.from_piece, a.from_side, a.piece, a.side) > std::tie(b.from_piece, b.from_side, b.piece, b.side);
+}
+
+struct Box {
+    int min_x, min_y, max_x, max_y;
+};
+
+// Whether the bounding box with the cell is within the size of the puzzle
+bool fits(const AssemblyParams &params, const Box &box, int x, int y) {
+    if (params.grid_width <= 0 || params.grid_height <= 0)
+        return true;
+    const int width = std::max(box.max_x, x) - std::min(box.min_x, x) + 1;
+    const int height = std::max(box.max_y, y) - std::min(box.min_y, y) + 1;
+    return (width <= params.grid_width && height <= params.grid_height) || (width <= params.grid_height && height <= params.grid_width);
+}
+
+Box extended(const Box &box, int x, int y) { return {std::min(box.min_x, x), std::min(box.min_y, y), std::max(box.max_x, x), std::max(box.max_y, y)}; }
+
+std::uint64_t mix(std::uint64_t x) {
+    // splitmix64 finalizer
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+std::uint64_t cellKey(int x, int y) { return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y); }
+
+// Free side of a placed piece and the empty cell that it faces
+struct FreeSide {
+    int y;
+    int x;
+    int piece;
+    int side;
+    int direction; // from the piece to the cell
+};
+
+bool operator<(const FreeSide &a, const FreeSide &b) { return std::tie(a.y, a.x, a.piece, a.side) < std::tie(b.y, b.x, b.piece, b.side); }
+
+// Placement of a piece into an empty cell, the difference is the mean difference of all its neighbours
+struct BeamMove {
+    bool buddies;
+    float difference;
+    int piece;
+    int rotation;
+    int y;
+    int x;
+    float total = 0.0f;    // sum of differences of all its neighbours
+    std::size_t count = 0; // number of them
+};
+
+// Best buddies first, then by difference (the order of the queue of the greedy placement), then by the cell and the piece
+bool ranked(const BeamMove &a, const BeamMove &b) {
+    if (a.buddies != b.buddies)
+        return a.buddies;
+    if (a.difference != b.difference)
+        return a.difference < b.difference;
+    return std::tie(a.y, a.x, a.piece, a.rotation) < std::tie(b.y, b.x, b.piece, b.rotation);
+}
+
+// Placed piece of a state of the beam search with the moves into the empty cells next to it (ranked). Placements are
+// persistent: a child state only adds one placement and shares all others with its parent
+struct BeamPlacement {
+    std::shared_ptr<const BeamPlacement> parent;
+    int piece;
+    PiecePlacement placement;
+    std::vector<BeamMove> moves;
+};
+
+struct BeamCell {
+    int y;
+    int x;
+    int piece;
+    int rotation;
+};
+
+// Flattened beginning of a state: its placed pieces and the moves that are still possible. It is shared by all
+// descendants of the state, they only add their placements on top of it until there are kBeamLayers of them
+struct BeamBase {
+    std::vector<std::uint64_t> placed; // bits of placed pieces
+    std::vector<BeamCell> cells;       // sorted by cells
+    std::vector<BeamMove> moves;       // ranked
+};
+
+// Placements of a state on top of its base before the state is flattened (when it is expanded): more of them make
+// queries of states longer, fewer make flattening (the only copying of the search) more frequent
+constexpr int kBeamLayers = 16;
+
+// State of the beam search: a partial component
+struct BeamState {
+    std::shared_ptr<const BeamPlacement> placements;
+    std::shared_ptr<const BeamBase> base;
+    int layers;         // number of the last placements that are not in base
+    int depth;          // number of placed pieces
+    float cost;         // sum of differences of adjacent sides
+    std::size_t edges;  // number of such pairs
+    std::uint64_t hash; // does not depend on the order of placements, so the same states reached in different orders are dropped
+    Box box;
+    float score; // cost minus a reward for every pair of adjacent sides, otherwise loose states would be better than compact ones
+};
+
+// Lower score first (then by hash, so the order does not depend on threads)
+bool better(const BeamState &a, const BeamState &b) {
+    if (a.score != b.score)
+        return a.score < b.score;
+    return a.hash < b.hash;
+}
+
+// Queries of a state: its base and its last placements (oldest first). A move of the base or of a placement is still
+// possible if no later placement took its piece or a cell next to its cell (moves into such cells were found again)
+class BeamView {
+  public:
+    explicit BeamView(const BeamState &state) : base_(state.base.get()), layers_(state.layers) {
+        const BeamPlacement *it = state.placements.get();
+        for (int i = state.layers - 1; i >= 0; --i, it = it->parent.get())
+            layers_[i] = it;
+    }
+
+    void push(const BeamPlacement *placement) { layers_.push_back(placement); }
+
+    // Piece at the cell and its rotation, piece is -1 if the cell is empty
+    std::pair<int, int> cell(int x, int y) const {
+        for (const BeamPlacement *layer : layers_) {
+            if (layer->placement.x == x && layer->placement.y == y)
+                return {layer->piece, layer->placement.rotation};
+        }
+        const auto it = std::lower_bound(base_->cells.begin(), base_->cells.end(), std::make_pair(y, x),
+                                         [](const BeamCell &c, const std::pair<int, int> &cell) { return std::tie(c.y, c.x) < std::tie(cell.first, cell.second); });
+        if (it == base_->cells.end() || it->y != y || it->x != x)
+            return {-1, 0};
+        return {it->piece, it->rotation};
+    }
+
+    bool isPlaced(int piece) const {
+        for (const BeamPlacement *layer : layers_) {
+            if (layer->piece == piece)
+                return true;
+        }
+        return (base_->placed[piece / 64] >> (piece % 64)) & 1;
+    }
+
+    // Calls visit for the possible moves within the size of the puzzle in the ranked order while it returns true
+    template <typename Visit>
+    void forEachMove(const AssemblyParams &params, const Box &box, Visit visit) const {
+        // source 0 is the base, source i is the placement layers_[i - 1]
+        const std::size_t sources = layers_.size() + 1;
+        std::vector<std::size_t> next(sources, 0);
+        const auto moves = [&](std::size_t source) -> const std::vector<BeamMove> & { return source == 0 ? base_->moves : layers_[source - 1]->moves; };
+        const auto skip = [&](std::size_t source) {
+            const std::vector<BeamMove> &list = moves(source);
+            while (next[source] < list.size() && !(possible(list[next[source]], source) && fits(params, box, list[next[source]].x, list[next[source]].y)))
+                ++next[source];
+        };
+        for (std::size_t source = 0; source < sources; ++source)
+            skip(source);
+        while (true) {
+            std::size_t best = sources;
+            for (std::size_t source = 0; source < sources; ++source) {
+                if (next[source] < moves(source).size() && (best == sources || ranked(moves(source)[next[source]], moves(best)[next[best]])))
+                    best = source;
+            }
+            if (best == sources || !visit(moves(best)[next[best]]))
+                return;
+            ++next[best];
+            skip(best);
+        }
+    }
+
+    // Base with all placements of the view
+    std::shared_ptr<const BeamBase> flatten(const AssemblyParams &params, const Box &box) const {
+        auto flat = std::make_shared<BeamBase>();
+        flat->placed = base_->placed;
+        flat->cells = base_->cells;
+        for (const BeamPlacement *layer : layers_) {
+            flat->placed[layer->piece / 64] |= std::uint64_t(1) << (layer->piece % 64);
+            flat->cells.push_back({layer->placement.y, layer->placement.x, layer->piece, layer->placement.rotation});
+        }
+        std::sort(flat->cells.begin(), flat->cells.end(), [](const BeamCell &a, const BeamCell &b) { return std::tie(a.y, a.x) < std::tie(b.y, b.x); });
+        forEachMove(params, box, [&](const BeamMove &move) {
+            flat->moves.push_back(move);
+            return true;
+        });
+        return flat;
+    }
+
+  private:
+    bool possible(const BeamMove &move, std::size_t source) const {
+        for (std::size_t i = source; i < layers_.size(); ++i) {
+            const BeamPlacement *layer = layers_[i];
+            if (layer->piece == move.piece || std::abs(move.x - layer->placement.x) + std::abs(move.y - layer->placement.y) <= 1)
+                return false;
+        }
+        return true;
+    }
+
+    const BeamBase *base_;
+    std::vector<const BeamPlacement *> layers_;
+};
+
+class Assembler {
+  public:
+    Assembler(const SideDescriptorTable &table, const std::vector<std::vector<SideCandidate>> &candidates, EdgeCost cost, bool with_openmp)
+        : table_(table), candidates_(candidates), cost_(std::move(cost)), with_openmp_(with_openmp) {}
+
+    Assembly run(const AssemblyParams &params) {
+        const int n = static_cast<int>(table_.piecesCount());
+        for (int p = 0; p < n; ++p)
+            rassert(table_.sidesCount(p) == kSides, 8830212401, p, table_.sidesCount(p));
+        rassert(params.beam_width == 0 || params.beam_branching > 0, 8830212404, params.beam_width, params.beam_branching);
+        if (params.beam_width > 0) {
+            // a pair of adjacent sides is worth the mean difference of the worst kept candidates of sides:
+            // a placement that is better than such an alternative makes the state better
+            double sum = 0.0;
+            std::size_t count = 0;
+            for (std::size_t a = 0; a < table_.size(); ++a) {
+                if (!candidates_[a].empty()) {
+                    sum += candidates_[a].back().difference;
+                    ++count;
+                }
+            }
+            edge_reward_ = count == 0 ? 0.0f : static_cast<float>(sum / count);
+        }
+        assembly_.placements.assign(n, PiecePlacement());
+
+        // pairs of best buddies by difference, they are the seeds of components
+        std::vector<std::pair<float, std::size_t>> seeds;
+        for (std::size_t a = 0; a < table_.size(); ++a) {
+            if (!candidates_[a].empty() && buddies(a, candidates_[a].front().side))
+                seeds.emplace_back(candidates_[a].front().difference, a);
+        }
+        std::sort(seeds.begin(), seeds.end());
+
+        int placed = 0;
+        std::size_t next_seed = 0;
+        while (placed < n) {
+            while (next_seed < seeds.size() && isPlaced(table_.piece(seeds[next_seed].second)))
+                ++next_seed;
+            int seed = 0;
+            if (next_seed < seeds.size()) {
+                seed = table_.piece(seeds[next_seed].second);
+            } else {
+                while (isPlaced(seed))
+                    ++seed;
+            }
+
+            const int component = assembly_.components++;
+            placed += params.beam_width > 0 ? growBeam(seed, component, params) : growGreedy(seed, component, params);
+        }
+
+        for (int pass = 0; pass < params.refinement_passes; ++pass) {
+            if (!refine())
+                break;
+        }
+
+        for (int p = 0; p < n; ++p) {
+            for (GridDirection direction : {GridDirection::Right, GridDirection::Down}) {
+                const auto [neighbour, side] = assembly_.neighbour(p, direction);
+                if (neighbour == -1)
+                    continue;
+                assembly_.cost += cost_(table_.index(p, assembly_.sideFacing(p, direction)), table_.index(neighbour, side));
+                ++assembly_.edges;
+            }
+        }
+        return std::move(assembly_);
+    }
+
+  private:
+    // Grows the component from the seed by the best placements from the priority queue, returns the number of placed pieces
+    int growGreedy(int seed, int component, const AssemblyParams &params) {
+        box_ = {0, 0, 0, 0};
+        place(seed, component, 0, 0, 0);
+        int placed = 1;
+        while (!queue_.empty()) {
+            Move move = queue_.top();
+            queue_.pop();
+            if (isPlaced(move.piece))
+                continue;
+            const PiecePlacement &from = assembly_.placements[move.from_piece];
+            const int direction = (move.from_side + from.rotation) % kSides;
+            const int x = from.x + kDx[direction];
+            const int y = from.y + kDy[direction];
+            if (assembly_.pieceAt(component, x, y) != -1 || !fits(params, box_, x, y))
+                continue;
+            const int rotation = (direction + 2 - move.side + kSides) % kSides;
+
+            // other neighbours of the cell could have been placed since the move was queued
+            std::size_t count = 0;
+            const float total = placementCost(move.piece, component, x, y, rotation, -1, count);
+            const float mean = total / count;
+            if (count > 1 && mean > move.difference) {
+                move.buddies = false;
+                move.difference = mean;
+                queue_.push(move);
+                continue;
+            }
+            place(move.piece, component, x, y, rotation);
+            ++placed;
+        }
+        return placed;
+    }
+
+    // Grows the component from the seed by the beam search: every state of the beam is expanded by its best placements
+    // (in parallel), the best beam_width children are kept. The largest final state with the lowest score wins.
+    int growBeam(int seed, int component, const AssemblyParams &params) {
+        auto base = std::make_shared<BeamBase>();
+        base->placed.assign((assembly_.placements.size() + 63) / 64, 0);
+        base->placed[seed / 64] |= std::uint64_t(1) << (seed % 64);
+        base->cells.push_back({0, 0, seed, 0});
+        BeamState root;
+        root.placements = std::make_shared<const BeamPlacement>(BeamPlacement{nullptr, seed, {component, 0, 0, 0}, {}});
+        root.base = base;
+        root.layers = 0;
+        root.depth = 1;
+        root.cost = 0.0f;
+        root.edges = 0;
+        root.hash = mix(seed);
+        root.box = {0, 0, 0, 0};
+        root.score = 0.0f;
+        for (int s = 0; s < kSides; ++s)
+            addMoves(BeamView(root), root.box, kDx[s], kDy[s], params, base->moves);
+        std::sort(base->moves.begin(), base->moves.end(), ranked);
+
+        std::vector<BeamState> beam;
+        beam.push_back(std::move(root));
+        std::shared_ptr<const BeamPlacement> best = beam.front().placements;
+        int best_depth = 1;
+        float best_score = 0.0f;
+        while (!beam.empty()) {
+            std::vector<std::vector<BeamState>> children(beam.size());
+            // states take different time to expand (some of them are flattened), so they are distributed dynamically
+            #pragma omp parallel for schedule(dynamic, 1) if(with_openmp_)
+            for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(beam.size()); ++i)
+                children[i] = expand(beam[i], params);
+            assembly_.search_nodes += beam.size();
+
+            std::vector<BeamState> next;
+            for (std::size_t i = 0; i < beam.size(); ++i) {
+                const BeamState &state = beam[i];
+                if (children[i].empty() && (state.depth > best_depth || (state.depth == best_depth && state.score < best_score))) {
+                    best = state.placements;
+                    best_depth = state.depth;
+                    best_score = state.score;
+                }
+                std::move(children[i].begin(), children[i].end(), std::back_inserter(next));
+            }
+            std::sort(next.begin(), next.end(), better);
+            next.erase(std::unique(next.begin(), next.end(), [](const BeamState &a, const BeamState &b) { return a.hash == b.hash; }), next.end());
+            if (next.size() > static_cast<std::size_t>(params.beam_width))
+                next.erase(next.begin() + params.beam_width, next.end());
+            beam = std::move(next);
+        }
+
+        for (const BeamPlacement *it = best.get(); it; it = it->parent.get()) {
+            assembly_.placements[it->piece] = it->placement;
+            assembly_.cells[{component, it->placement.x, it->placement.y}] = it->piece;
+        }
+        return best_depth;
+    }
+
+    // Appends placements of candidates of the free sides that face the empty cell
+    void addMoves(const BeamView &view, const Box &box, int x, int y, const AssemblyParams &params, std::vector<BeamMove> &moves) const {
+        if (!fits(params, box, x, y))
+            return;
+        FreeSide facing[kSides];
+        std::size_t facing_count = 0;
+        for (int d = 0; d < kSides; ++d) {
+            const auto [piece, rotation] = view.cell(x + kDx[d], y + kDy[d]);
+            if (piece == -1)
+                continue;
+            const int direction = (d + 2) % kSides;
+            facing[facing_count++] = {y, x, piece, (direction - rotation + kSides) % kSides, direction};
+        }
+        std::sort(facing, facing + facing_count);
+
+        const std::size_t first = moves.size();
+        for (std::size_t f = 0; f < facing_count; ++f) {
+            const std::size_t a = table_.index(facing[f].piece, facing[f].side);
+            for (const SideCandidate &candidate : candidates_[a]) {
+                const int q = table_.piece(candidate.side);
+                if (isPlaced(q) || view.isPlaced(q))
+                    continue;
+                const int rotation = (facing[f].direction + 2 - table_.side(candidate.side) + kSides) % kSides;
+                moves.push_back({buddies(a, candidate.side), candidate.difference, q, rotation, y, x});
+            }
+        }
+
+        // the same placement can come from several neighbours: it is evaluated once with all of them
+        const auto key = [](const BeamMove &m) { return std::tie(m.piece, m.rotation); };
+        std::sort(moves.begin() + first, moves.end(), [&](const BeamMove &a, const BeamMove &b) { return key(a) < key(b) || (key(a) == key(b) && a.buddies > b.buddies); });
+        moves.erase(std::unique(moves.begin() + first, moves.end(), [&](const BeamMove &a, const BeamMove &b) { return key(a) == key(b); }), moves.end());
+        for (auto move = moves.begin() + first; move != moves.end(); ++move) {
+            if (facing_count == 1) {
+                // the only neighbour is the one the piece is a candidate of
+                move->total = move->difference;
+                move->count = 1;
+                continue;
+            }
+            for (std::size_t f = 0; f < facing_count; ++f) {
+                const int side = (facing[f].direction + 2 - move->rotation + kSides) % kSides;
+                move->total += cost_(table_.index(move->piece, side), table_.index(facing[f].piece, facing[f].side));
+                ++move->count;
+            }
+            // as in the greedy placement: a pair is not a pair of best buddies any more if other neighbours do not fit
+            const float mean = move->total / move->count;
+            move->buddies = move->buddies && mean <= move->difference;
+            move->difference = mean;
+        }
+    }
+
+    // Children of the state by its beam_branching best moves. A child shares the base and the placements of its parent
+    // and only stores its own placement with the moves into the empty cells next to it. The state is flattened first
+    // if it has too many placements on top of its base (only states that are kept in the beam are ever flattened).
+    std::vector<BeamState> expand(BeamState &state, const AssemblyParams &params) const {
+        if (state.layers >= kBeamLayers) {
+            state.base = BeamView(state).flatten(params, state.box);
+            state.layers = 0;
+        }
+        const BeamView view(state);
+        std::vector<BeamMove> best;
+        view.forEachMove(params, state.box, [&](const BeamMove &move) {
+            best.push_back(move);
+            return best.size() < static_cast<std::size_t>(params.beam_branching);
+        });
+
+        std::vector<BeamState> children(best.size());
+        for (std::size_t i = 0; i < best.size(); ++i) {
+            const BeamMove &move = best[i];
+            const int x = move.x;
+            const int y = move.y;
+            BeamState &child = children[i];
+            child.base = state.base;
+            child.layers = state.layers + 1;
+            child.depth = state.depth + 1;
+            child.cost = state.cost + move.total;
+            child.edges = state.edges + move.count;
+            child.hash = state.hash ^ mix(mix(move.piece) ^ ((cellKey(x, y) << 2) | move.rotation));
+            child.box = extended(state.box, x, y);
+            child.score = child.cost - edge_reward_ * child.edges;
+
+            auto placement = std::make_shared<BeamPlacement>(BeamPlacement{state.placements, move.piece, {state.placements->placement.component, x, y, move.rotation}, {}});
+            BeamView child_view = view;
+            child_view.push(placement.get());
+            for (int s = 0; s < kSides; ++s) {
+                const int direction = (s + move.rotation) % kSides;
+                if (child_view.cell(x + kDx[direction], y + kDy[direction]).first == -1)
+                    addMoves(child_view, child.box, x + kDx[direction], y + kDy[direction], params, placement->moves);
+            }
+            std::sort(placement->moves.begin(), placement->moves.end(), ranked);
+            child.placements = std::move(placement);
+        }
+        return children;
+    }
+
+    bool isPlaced(int piece) const { return assembly_.placements[piece].component != -1; }
+
+    bool buddies(std::size_t a, std::size_t b) const {
+        return !candidates_[a].empty() && candidates_[a].front().side == b && !candidates_[b].empty() && candidates_[b].front().side == a;
+    }
+
+    void place(int piece, int component, int x, int y, int rotation) {
+        box_ = extended(box_, x, y);
+        assembly_.placements[piece] = {component, x, y, rotation};
+        assembly_.cells[{component, x, y}] = piece;
+        for (int s = 0; s < kSides; ++s) {
+            const int direction = (s + rotation) % kSides;
+            if (assembly_.pieceAt(component, x + kDx[direction], y + kDy[direction]) != -1)
+                continue;
+            const std::size_t a = table_.index(piece, s);
+            for (const SideCandidate &candidate : candidates_[a]) {
+                const int other = table_.piece(candidate.side);
+                if (!isPlaced(other))
+                    queue_.push({buddies(a, candidate.side), candidate.difference, piece, s, other, table_.side(candidate.side)});
+            }
+        }
+    }
+
+    // Sum of differences of the sides of the piece at the cell with the rotation and of its placed neighbours
+    // (except the piece skip), count is the number of such neighbours
+    float placementCost(int piece, int component, int x, int y, int rotation, int skip, std::size_t &count) const {
+        float total = 0.0f;
+        count = 0;
+        for (int direction = 0; direction < kSides; ++direction) {
+            const int neighbour = assembly_.pieceAt(component, x + kDx[direction], y + kDy[direction]);
+            if (neighbour == -1 || neighbour == piece || neighbour == skip)
+                continue;
+            const int side = (direction - rotation + kSides) % kSides;
+            const int neighbour_side = (direction + 2 - assembly_.placements[neighbour].rotation + kSides) % kSides;
+            total += cost_(table_.index(piece, side), table_.index(neighbour, neighbour_side));
+            ++count;
+        }
+        return total;
+    }
+
+    // Differences of all sides adjacent to the placed piece
+    float pieceCost(int piece) const {
+        const PiecePlacement &placement = assembly_.placements[piece];
+        std::size_t count = 0;
+        return placementCost(piece, placement.component, placement.x, placement.y, placement.rotation, -1, count);
+    }
+
+    // Differences of all sides adjacent to placed pieces a and b, the pair of them counted once
+    float localCost(int a, int b) const {
+        const PiecePlacement &pa = assembly_.placements[a];
+        const PiecePlacement &pb = assembly_.placements[b];
+        std::size_t count = 0;
+        return placementCost(a, pa.component, pa.x, pa.y, pa.rotation, -1, count)
+             + placementCost(b, pb.component, pb.x, pb.y, pb.rotation, a, count);
+    }
+
+    void move(int piece, int x, int y, int rotation) {
+        PiecePlacement &placement = assembly_.placements[piece];
+        placement.x = x;
+        placement.y = y;
+        placement.rotation = rotation;
+        assembly_.cells[{placement.component, x, y}] = piece;
+    }
+
+    // One pass of local refinement: for every candidate (q, side t) of side s of a piece p, q is moved to the cell that side s faces
+    // with side t towards p, and the piece r from that cell is moved to the old cell of q with its best rotation
+    // (or q is only rotated if it is already there). Returns true if anything was improved.
+    bool refine() {
+        bool improved = false;
+        for (std::size_t a = 0; a < table_.size(); ++a) {
+            const int p = table_.piece(a);
+            const int s = table_.side(a);
+            for (const SideCandidate &candidate : candidates_[a]) {
+                const int q = table_.piece(candidate.side);
+                const PiecePlacement from = assembly_.placements[p];
+                const PiecePlacement old_q = assembly_.placements[q];
+                if (old_q.component != from.component)
+                    continue;
+                const int direction = (s + from.rotation) % kSides;
+                const int x = from.x + kDx[direction];
+                const int y = from.y + kDy[direction];
+                const int rotation = (direction + 2 - table_.side(candidate.side) + kSides) % kSides;
+                const int r = assembly_.pieceAt(from.component, x, y);
+                if (r == -1 || r == p || (r == q && old_q.rotation == rotation))
+                    continue;
+
+                if (r == q) {
+                    const float before = pieceCost(q);
+                    move(q, x, y, rotation);
+                    if (pieceCost(q) < before) {
+                        improved = true;
+                    } else {
+                        move(q, x, y, old_q.rotation);
+                    }
+                    continue;
+                }
+
+                const PiecePlacement old_r = assembly_.placements[r];
+                const float before = localCost(q, r);
+                move(q, x, y, rotation);
+                move(r, old_q.x, old_q.y, 0);
+                int best_rotation = 0;
+                float best = localCost(q, r);
+                for (int r_rotation = 1; r_rotation < kSides; ++r_rotation) {
+                    move(r, old_q.x, old_q.y, r_rotation);
+                    const float cost = localCost(q, r);
+                    if (cost < best) {
+                        best = cost;
+                        best_rotation = r_rotation;
+                    }
+                }
+                if (best < before) {
+                    move(r, old_q.x, old_q.y, best_rotation);
+                    improved = true;
+                } else {
+                    move(r, old_r.x, old_r.y, old_r.rotation);
+                    move(q, old_q.x, old_q.y, old_q.rotation);
+                }
+            }
+        }
+        return improved;
+    }
+
+    const SideDescriptorTable &table_;
+    const std::vector<std::vector<SideCandidate>> &candidates_;
+    EdgeCost cost_;
+    bool with_openmp_;
+    float edge_reward_ = 0.0f; // of every pair of adjacent sides in scores of states of the beam search
+    Assembly assembly_;
+    Box box_ = {0, 0, 0, 0}; // bounding box of the current component
+    std::priority_queue<Move, std::vector<Move>, decltype(&worse)> queue_{worse};
+};
+
+} // namespace
+
+int Assembly::pieceAt(int component, int x, int y) const {
+    const auto it = cells.find({component, x, y});
+    return it == cells.end() ? -1 : it->second;
+}
+
+std::pair<int, int> Assembly::neighbour(int piece, GridDirection direction) const {
+    const PiecePlacement &placement = placements[piece];
+    const int d = static_cast<int>(direction);
+    const int other = pieceAt(placement.component, placement.x + kDx[d], placement.y + kDy[d]);
+    if (other == -1)
+        return {-1, -1};
+    return {other, sideFacing(other, static_cast<GridDirection>((d + 2) % kSides))};
+}
+
+Assembly assemblePuzzle(const SideDescriptorTable &table, const SideCandidateIndex &candidates, const AssemblyParams &params, bool with_openmp) {
+    rassert(candidates.size() == table.size(), 8830212402, candidates.size(), table.size());
+    std::vector<std::vector<SideCandidate>> lists(table.size());
+    for (std::size_t a = 0; a < table.size(); ++a)
+        lists[a].assign(candidates.candidates(a).begin(), candidates.candidates(a).end());
+    const EdgeCost cost = [&](std::size_t a, std::size_t b) { return compareSides(table[a], table[b], params.metric); };
+    return Assembler(table, lists, cost, with_openmp).run(params);
+}
+
+Assembly assemblePuzzle(const SideDescriptorTable &table, const SideDifferenceMatrix &differences, std::size_t k, const AssemblyParams &params,
+                        bool with_openmp) {
+    rassert(differences.size() == table.size(), 8830212403, differences.size(), table.size());
+    std::vector<std::vector<SideCandidate>> lists(table.size());
+    for (std::size_t a = 0; a < table.size(); ++a) {
+        for (std::size_t b = 0; b < table.size(); ++b) {
+            if (table.piece(b) != table.piece(a))
+                lists[a].push_back({b, differences(a, b)});
+        }
+        const std::size_t count = std::min(k, lists[a].size());
+        std::partial_sort(lists[a].begin(), lists[a].begin() + count, lists[a].end(), [](const SideCandidate &x, const SideCandidate &y) {
+            return x.difference < y.difference || (x.difference == y.difference && x.side < y.side);
+        });
+        lists[a].resize(count);
+    }
+    const EdgeCost cost = [&](std::size_t a, std::size_t b) { return differences(a, b); };
+    return Assembler(table, lists, cost, with_openmp).run(params);
+}
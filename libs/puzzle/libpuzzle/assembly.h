@@ -0,0 +1,64 @@
+#pragma once
+
+#include <libpuzzle/side_candidates.h>
+
+#include <cstddef>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Directions of the grid: side s of a piece with rotation r faces direction (s + r) % 4
+enum class GridDirection { Up = 0, Right = 1, Down = 2, Left = 3 };
+
+struct PiecePlacement {
+    int component = -1; // pieces of one component are placed on one grid, components are not connected with each other
+    int x = 0;          // cell of the grid (may be negative, the first piece of a component is at (0, 0))
+    int y = 0;
+    int rotation = 0;
+};
+
+struct Assembly {
+    std::vector<PiecePlacement> placements;        // placements[piece]
+    std::map<std::tuple<int, int, int>, int> cells; // (component, x, y) -> piece
+    int components = 0;
+    float cost = 0.0f;     // sum of differences of all pairs of adjacent sides
+    std::size_t edges = 0; // number of such pairs
+    std::size_t search_nodes = 0; // states expanded by the beam search
+
+    // Piece at the cell of the component, -1 if it is empty
+    int pieceAt(int component, int x, int y) const;
+    // Neighbour of the piece in the direction and the side of the neighbour that faces it, {-1, -1} if there is none
+    std::pair<int, int> neighbour(int piece, GridDirection direction) const;
+    // Side of the piece that faces the direction
+    int sideFacing(int piece, GridDirection direction) const { return (static_cast<int>(direction) - placements[piece].rotation + 4) % 4; }
+};
+
+struct AssemblyParams {
+    SideMetric metric = SideMetric::L1; // metric of differences of sides which are adjacent but were not candidates of each other
+    int refinement_passes = 4;          // passes of local refinement (0 - greedy placement only)
+    // size of the puzzle in pieces if it is known (0 - unknown): components never outgrow it (in any orientation)
+    int grid_width = 0;
+    int grid_height = 0;
+    int beam_width = 0;     // states kept by the beam search after every placement (0 - greedy placement)
+    int beam_branching = 4; // children of every state of the beam search
+};
+
+// Global assembly of pieces with 4 sides into grids.
+//
+// Greedy placement: pairs of best buddies (sides that are the best candidates of each other) are placed first,
+// then other candidates of the free sides of placed pieces, all from one priority queue ordered by difference
+// (a pair is re-queued with the mean difference of all sides it would touch if more neighbours were placed since it was queued).
+// When the queue is empty, the remaining pieces start a new component.
+// With beam_width > 0 components are grown by the beam search instead: every state is expanded by its beam_branching
+// best placements (the same order as of the queue), states are compared by the sum of differences of adjacent sides
+// minus the mean difference of the worst candidates of sides for every pair of them.
+// States share placements with their parents, the beam is expanded in parallel (nodes/sec are search_nodes per time).
+// Local refinement swaps pairs of pieces of a component (with the best rotations), if the sum of differences decreases,
+// only for pieces that are candidates of each other. So the work is about O(S k log S) for S sides and k candidates per side.
+Assembly assemblePuzzle(const SideDescriptorTable &table, const SideCandidateIndex &candidates, const AssemblyParams &params = {},
+                        bool with_openmp = true);
+
+// The same with candidates taken from a full difference matrix (k best sides of other pieces for every side)
+Assembly assemblePuzzle(const SideDescriptorTable &table, const SideDifferenceMatrix &differences, std::size_t k = 4,
+                        const AssemblyParams &params = {}, bool with_openmp = true);
@@ -0,0 +1,47 @@
+#include "assembly.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/benchmark_utils.h>
+
+#include <iostream>
+
+namespace {
+
+void benchmarkAssembly(const std::string &name, int pieces_count) {
+    const image8u board = makeTintedBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    const std::vector<Piece> pieces = processPieces(board, findConnectedComponents(mask));
+    const SideDescriptorTable table = SideDescriptorTable::build(pieces);
+    const SideCandidateIndex candidates = SideCandidateIndex::build(table);
+
+    AssemblyParams greedy;
+    greedy.refinement_passes = 0;
+    Assembly assembly;
+    benchmark(name + ": assemblePuzzle greedy", [&]() { assembly = assemblePuzzle(table, candidates, greedy); }, 1);
+    std::cout << name << ": " << assembly.components << " components, " << assembly.edges << " edges, cost " << assembly.cost << std::endl;
+    benchmark(name + ": assemblePuzzle with refinement", [&]() { assembly = assemblePuzzle(table, candidates); }, 1);
+    std::cout << name << ": " << assembly.components << " components, " << assembly.edges << " edges, cost " << assembly.cost << std::endl;
+
+    for (int width : {4, 16}) {
+        AssemblyParams beam = greedy;
+        beam.beam_width = width;
+        for (bool with_openmp : {true, false}) {
+            const std::string title = name + ": beam search width=" + std::to_string(width) + (with_openmp ? "" : " single thread");
+            const double time = benchmark(title, [&]() { assembly = assemblePuzzle(table, candidates, beam, with_openmp); }, 1);
+            std::cout << title << ": " << assembly.components << " components, " << assembly.edges << " edges, cost " << assembly.cost << ", "
+                      << (time > 0.0 ? assembly.search_nodes / time : 0.0) << " nodes/sec" << std::endl;
+        }
+    }
+}
+
+} // namespace
+
+TEST(assembly_benchmark, tintedBoards) {
+    // the greedy placement grows about as S log S: twice as many pieces take about twice as much time,
+    // the beam search expands about beam_width states per placed piece, and a state is about as fast to expand
+    // regardless of the size of its board (only moves near the placed piece are found again)
+    benchmarkAssembly("250 tinted pieces", 250);
+    benchmarkAssembly("1000 tinted pieces", 1000);
+    benchmarkAssembly("2000 tinted pieces", 2000);
+}
@@ -0,0 +1,186 @@
+#include "assembly.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/configure_working_directory.h>
+#include <libbase/fast_random.h>
+#include <libpuzzle/tests_utils.h>
+
+#include <algorithm>
+#include <set>
+
+namespace {
+
+// Uniform noise in [-amplitude, amplitude] in all channels
+void addNoise(image8u &image, int amplitude) {
+    FastRandom r(30);
+    for (int j = 0; j < image.height(); ++j)
+        for (int i = 0; i < image.width(); ++i)
+            for (int c = 0; c < 3; ++c)
+                image(j, i, c) = static_cast<std::uint8_t>(std::clamp(image(j, i, c) + r.nextInt(-amplitude, amplitude), 0, 255));
+}
+
+// Pairs (piece, side) of sides which touch each other on the board: their middle points are close
+std::set<std::pair<std::size_t, std::size_t>> touchingSides(const std::vector<Piece> &pieces, const SideDescriptorTable &table) {
+    auto middle = [&](std::size_t i) {
+        const Piece &piece = pieces[table.piece(i)];
+        const ChainCodeSlice side = piece.side(table.side(i));
+        return piece.offset + side[side.size() / 2];
+    };
+    std::set<std::pair<std::size_t, std::size_t>> touching;
+    for (std::size_t a = 0; a < table.size(); ++a) {
+        for (std::size_t b = 0; b < table.size(); ++b) {
+            if (table.piece(a) != table.piece(b) && (middle(a) - middle(b)).norm2() <= 4 * 4)
+                touching.insert({a, b});
+        }
+    }
+    return touching;
+}
+
+// Number of adjacent pairs of sides of the assembly and the number of them that touch on the board
+std::pair<std::size_t, std::size_t> checkEdges(const Assembly &assembly, const SideDescriptorTable &table,
+                                               const std::set<std::pair<std::size_t, std::size_t>> &touching) {
+    std::size_t edges = 0;
+    std::size_t correct = 0;
+    for (int p = 0; p < static_cast<int>(table.piecesCount()); ++p) {
+        for (GridDirection direction : {GridDirection::Right, GridDirection::Down}) {
+            const auto [neighbour, side] = assembly.neighbour(p, direction);
+            if (neighbour == -1)
+                continue;
+            ++edges;
+            correct += touching.count({table.index(p, assembly.sideFacing(p, direction)), table.index(neighbour, side)});
+        }
+    }
+    return {edges, correct};
+}
+
+} // namespace
+
+TEST(assembly, pictureBoard) {
+    const SyntheticBoard board = makePictureBoard(6, 5);
+    ASSERT_EQ(board.pieces.size(), 30u);
+    const SideDescriptorTable table = SideDescriptorTable::build(board.pieces);
+    const std::set<std::pair<std::size_t, std::size_t>> touching = touchingSides(board.pieces, table);
+    ASSERT_EQ(touching.size(), 2u * (5 * 5 + 6 * 4));
+
+    const SideCandidateIndex candidates = SideCandidateIndex::build(table);
+    for (int passes : {0, 4}) {
+        AssemblyParams params;
+        params.refinement_passes = passes;
+        const Assembly assembly = assemblePuzzle(table, candidates, params);
+        ASSERT_EQ(assembly.placements.size(), 30u);
+        EXPECT_EQ(assembly.components, 1);
+        EXPECT_EQ(assembly.cells.size(), 30u);
+
+        const auto [edges, correct] = checkEdges(assembly, table, touching);
+        EXPECT_EQ(edges, assembly.edges);
+        EXPECT_EQ(edges, 5u * 5 + 6 * 4);
+        EXPECT_EQ(correct, edges) << passes;
+    }
+
+    // the same from the full matrix
+    const SideDifferenceMatrix matrix = compareSides(table);
+    const Assembly assembly = assemblePuzzle(table, matrix);
+    const auto [edges, correct] = checkEdges(assembly, table, touching);
+    EXPECT_EQ(correct, edges);
+    EXPECT_EQ(edges, 5u * 5 + 6 * 4);
+}
+
+TEST(assembly, noisyPictureBoard) {
+    // noise hides a part of the picture, so greedy placement alone makes mistakes
+    SyntheticBoard board = makePictureBoard(8, 6);
+    addNoise(board.image, 20);
+    const SideDescriptorTable table = SideDescriptorTable::build(board.pieces);
+    const std::set<std::pair<std::size_t, std::size_t>> touching = touchingSides(board.pieces, table);
+    const SideCandidateIndex candidates = SideCandidateIndex::build(table);
+
+    AssemblyParams greedy;
+    greedy.refinement_passes = 0;
+    const Assembly before = assemblePuzzle(table, candidates, greedy);
+    const Assembly after = assemblePuzzle(table, candidates);
+    EXPECT_EQ(after.edges, before.edges);
+    EXPECT_LE(after.cost, before.cost + 1e-3f);
+
+    // every piece is placed exactly once
+    std::set<std::tuple<int, int, int>> cells;
+    for (const PiecePlacement &placement : after.placements) {
+        EXPECT_GE(placement.component, 0);
+        EXPECT_LT(placement.component, after.components);
+        EXPECT_TRUE(cells.insert({placement.component, placement.x, placement.y}).second);
+    }
+    EXPECT_EQ(after.cells.size(), cells.size());
+
+    // without the size of the puzzle components grow in wrong directions, with it the whole grid is found
+    AssemblyParams sized;
+    sized.grid_width = 6;
+    sized.grid_height = 8;
+    const Assembly grid = assemblePuzzle(table, candidates, sized);
+    EXPECT_EQ(grid.components, 1);
+    const auto [edges, correct] = checkEdges(grid, table, touching);
+    EXPECT_EQ(edges, 7u * 6 + 8 * 5);
+    EXPECT_EQ(correct, edges);
+}
+
+TEST(assembly, samplePieces) {
+    configureWorkingDirectory();
+
+    const SamplePhoto photo = samplePhotoPieces();
+    const SideDescriptorTable table = SideDescriptorTable::build(photo.pieces);
+    const SideCandidateIndex candidates = SideCandidateIndex::build(table);
+
+    // 6 pieces of the photo form a 3 x 2 grid
+    const Assembly assembly = assemblePuzzle(table, candidates);
+    EXPECT_EQ(assembly.components, 1);
+    EXPECT_EQ(assembly.edges, 7u);
+
+    AssemblyParams beam;
+    beam.beam_width = 16;
+    const Assembly beam_assembly = assemblePuzzle(table, candidates, beam);
+    EXPECT_EQ(beam_assembly.components, 1);
+    EXPECT_EQ(beam_assembly.edges, 7u);
+}
+
+TEST(assembly, beamSearch) {
+    const SyntheticBoard board = makePictureBoard(6, 5);
+    const SideDescriptorTable table = SideDescriptorTable::build(board.pieces);
+    const std::set<std::pair<std::size_t, std::size_t>> touching = touchingSides(board.pieces, table);
+    const SideCandidateIndex candidates = SideCandidateIndex::build(table);
+
+    AssemblyParams params;
+    params.refinement_passes = 0;
+    params.beam_width = 8;
+    const Assembly assembly = assemblePuzzle(table, candidates, params);
+    EXPECT_EQ(assembly.components, 1);
+    EXPECT_GT(assembly.search_nodes, 0u);
+    const auto [edges, correct] = checkEdges(assembly, table, touching);
+    EXPECT_EQ(edges, 5u * 5 + 6 * 4);
+    EXPECT_EQ(correct, edges);
+
+    // the result does not depend on threads
+    const Assembly single_thread = assemblePuzzle(table, candidates, params, false);
+    EXPECT_EQ(single_thread.cells, assembly.cells);
+    EXPECT_EQ(single_thread.search_nodes, assembly.search_nodes);
+}
+
+TEST(assembly, noisyPictureBoardBeamSearch) {
+    SyntheticBoard board = makePictureBoard(8, 6);
+    addNoise(board.image, 20);
+    const SideDescriptorTable table = SideDescriptorTable::build(board.pieces);
+    const std::set<std::pair<std::size_t, std::size_t>> touching = touchingSides(board.pieces, table);
+    const SideCandidateIndex candidates = SideCandidateIndex::build(table);
+
+    AssemblyParams greedy;
+    greedy.refinement_passes = 0;
+    const auto [greedy_edges, greedy_correct] = checkEdges(assemblePuzzle(table, candidates, greedy), table, touching);
+    EXPECT_LT(greedy_correct, greedy_edges);
+
+    // the beam keeps alternatives of ambiguous placements and prefers compact states, so the whole grid is found without its size
+    AssemblyParams beam = greedy;
+    beam.beam_width = 4;
+    const Assembly assembly = assemblePuzzle(table, candidates, beam);
+    EXPECT_EQ(assembly.components, 1);
+    const auto [edges, correct] = checkEdges(assembly, table, touching);
+    EXPECT_EQ(edges, assembly.edges);
+    EXPECT_EQ(edges, 7u * 6 + 8 * 5);
+    EXPECT_EQ(correct, edges);
+}
@@ -0,0 +1,187 @@
+#include "batch_solver.h"
+
+#include <libbase/runtime_assert.h>
+#include <libbase/stats.h>
+#include <libbase/timer.h>
+#include <libimages/image_io.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string jsonString(const std::string &s) {
+    std::ostringstream out;
+    out << '"';
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u00" << "0123456789abcdef"[c >> 4] << "0123456789abcdef"[c & 15];
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+void writeFile(const fs::path &path, const std::string &text) {
+    std::ofstream out(path);
+    rassert(out, 5512093401, path.string());
+    out << text << std::endl;
+    rassert(out, 5512093402, path.string());
+}
+
+void solveItem(BatchItem &item, const SolverParams &params, bool with_openmp, const std::string &output_dir) {
+    Timer t;
+    try {
+        const image8u image = load_image(item.path);
+        item.result = solvePuzzle(image, params, with_openmp);
+        item.ok = true;
+    } catch (const std::exception &e) {
+        item.error = e.what();
+    }
+    item.latency = t.elapsed();
+    if (!output_dir.empty())
+        writeFile(fs::path(output_dir) / (item.name + ".json"), toJson(item));
+}
+
+} // namespace
+
+std::size_t BatchReport::failed() const {
+    return std::count_if(items.begin(), items.end(), [](const BatchItem &item) { return !item.ok; });
+}
+
+double BatchReport::imagesPerSecond() const { return seconds > 0.0 ? items.size() / seconds : 0.0; }
+
+double BatchReport::latencyPercentile(double p) const {
+    std::vector<double> latencies;
+    for (const BatchItem &item : items) {
+        if (item.ok)
+            latencies.push_back(item.latency);
+    }
+    return latencies.empty() ? 0.0 : stats::percentile(latencies, p);
+}
+
+BatchReport solveBatch(const std::vector<std::string> &paths, const SolverParams &params, const BatchParams &batch) {
+    rassert(batch.workers >= 0 && batch.threads_per_worker >= 0, 5512093403, batch.workers, batch.threads_per_worker);
+    BatchReport report;
+    report.items.resize(paths.size());
+    std::set<std::string> names = {"report"}; // report.json is written next to the photos
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        BatchItem &item = report.items[i];
+        item.path = paths[i];
+        const std::string stem = fs::path(paths[i]).stem().string();
+        item.name = stem;
+        for (int suffix = 1; !names.insert(item.name).second; ++suffix)
+            item.name = stem + "_" + std::to_string(suffix);
+    }
+    if (!batch.output_dir.empty())
+        fs::create_directories(batch.output_dir);
+
+    const int hardware = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    report.workers = batch.workers > 0 ? batch.workers : std::min(hardware, static_cast<int>(paths.size()));
+    report.workers = std::max(1, std::min(report.workers, static_cast<int>(paths.size())));
+    report.threads_per_worker = batch.threads_per_worker > 0 ? batch.threads_per_worker : std::max(1, hardware / report.workers);
+
+    Timer t;
+    std::atomic<std::size_t> next = 0;
+    std::vector<std::exception_ptr> errors(report.workers);
+    auto work = [&](int worker) {
+        try {
+#if defined(_OPENMP)
+            // the number of threads of parallel regions started by this thread only
+            omp_set_num_threads(report.threads_per_worker);
+#endif
+            for (std::size_t i = next++; i < paths.size(); i = next++)
+                solveItem(report.items[i], params, report.threads_per_worker > 1, batch.output_dir);
+        } catch (...) {
+            errors[worker] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int worker = 1; worker < report.workers; ++worker)
+        threads.emplace_back(work, worker);
+    work(0);
+    for (std::thread &thread : threads)
+        thread.join();
+    report.seconds = t.elapsed();
+    for (const std::exception_ptr &error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    if (!batch.output_dir.empty())
+        writeFile(fs::path(batch.output_dir) / "report.json", toJson(report));
+    return report;
+}
+
+std::vector<std::string> listBatchInputs(const std::string &path) {
+    std::vector<std::string> paths;
+    if (fs::is_directory(path)) {
+        for (const fs::directory_entry &entry : fs::directory_iterator(path)) {
+            std::string extension = entry.path().extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+            if (entry.is_regular_file() && (extension == ".jpg" || extension == ".jpeg" || extension == ".png"))
+                paths.push_back(entry.path().string());
+        }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    std::ifstream in(path);
+    rassert(in, 5512093404, path);
+    const fs::path base = fs::path(path).parent_path();
+    std::string line;
+    while (std::getline(in, line)) {
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty())
+            continue;
+        const fs::path input(line);
+        paths.push_back(input.is_absolute() ? input.string() : (base / input).string());
+    }
+    return paths;
+}
+
+std::string toJson(const BatchItem &item) {
+    std::ostringstream out;
+    out << "{\"path\": " << jsonString(item.path) << ", \"name\": " << jsonString(item.name) << ", \"ok\": " << (item.ok ? "true" : "false")
+        << ", \"latency\": " << item.latency;
+    if (item.ok) {
+        out << ", \"result\": " << toJson(item.result);
+    } else {
+        out << ", \"error\": " << jsonString(item.error);
+    }
+    out << "}";
+    return out.str();
+}
+
+std::string toJson(const BatchReport &report) {
+    std::ostringstream out;
+    out << "{\"images\": " << report.items.size() << ", \"failed\": " << report.failed() << ", \"workers\": " << report.workers
+        << ", \"threads_per_worker\": " << report.threads_per_worker << ", \"seconds\": " << report.seconds
+        << ", \"images_per_second\": " << report.imagesPerSecond() << ", \"latency_p50\": " << report.latencyPercentile(50.0)
+        << ", \"latency_p99\": " << report.latencyPercentile(99.0) << ", \"items\": [";
+    for (std::size_t i = 0; i < report.items.size(); ++i) {
+        const BatchItem &item = report.items[i];
+        out << (i == 0 ? "" : ", ") << "{\"name\": " << jsonString(item.name) << ", \"ok\": " << (item.ok ? "true" : "false")
+            << ", \"latency\": " << item.latency << "}";
+    }
+    out << "]}";
+    return out.str();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <libpuzzle/puzzle_solver.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct BatchParams {
+    int workers = 0; // photos processed at once (0 - one per hardware thread, but not more than photos)
+    // OpenMP threads of every worker (0 - hardware threads divided between workers), so that parallel loops
+    // inside of the pipeline do not oversubscribe cores (1 - the pipeline of every worker is sequential)
+    int threads_per_worker = 0;
+    std::string output_dir; // if not empty - <name>.json of every photo and report.json are written there
+};
+
+struct BatchItem {
+    std::string path;
+    std::string name; // unique within the batch and not "report": file name without extension (and _1, _2, ... if it is taken)
+    bool ok = false;
+    std::string error; // message of the exception if the photo failed
+    SolverResult result;
+    double latency = 0.0; // seconds from the start of loading to the end of assembly
+};
+
+struct BatchReport {
+    std::vector<BatchItem> items; // in the order of paths
+    int workers = 0;
+    int threads_per_worker = 0;
+    double seconds = 0.0; // wall time of the whole batch
+
+    std::size_t failed() const;
+    double imagesPerSecond() const;
+    // p-th percentile (p in [0, 100]) of latencies of solved photos, 0 if there are none
+    double latencyPercentile(double p) const;
+};
+
+// Solves every photo on a bounded pool of worker threads, every worker takes the next photo when it is done with its own.
+// Photos that fail (can't be loaded, pieces without 4 sides, ...) are reported, others are solved anyway.
+BatchReport solveBatch(const std::vector<std::string> &paths, const SolverParams &params = {}, const BatchParams &batch = {});
+
+// Photos (.jpg, .jpeg, .png) of the directory sorted by name, or the paths listed in the text file (one per line,
+// relative ones are relative to the file)
+std::vector<std::string> listBatchInputs(const std::string &path);
+
+std::string toJson(const BatchItem &item);
+// Throughput, latency percentiles and the status of every photo
+std::string toJson(const BatchReport &report);
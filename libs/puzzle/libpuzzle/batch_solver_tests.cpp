@@ -0,0 +1,118 @@
+#include "batch_solver.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/configure_working_directory.h>
+#include <libimages/image_io.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Empty directory for the files of a test
+fs::path testDirectory(const std::string &name) {
+    const fs::path dir = fs::temp_directory_path() / ("libpuzzle_" + name);
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+} // namespace
+
+TEST(batch_solver, samplePhotos) {
+    configureWorkingDirectory();
+
+    const std::string photo = "data/00_photo_six_parts_downscaled_x4.jpg";
+    const SolverResult expected = solvePuzzle(load_image(photo));
+    const fs::path output = testDirectory("batch_solver_samplePhotos");
+
+    BatchParams batch;
+    batch.workers = 2;
+    batch.output_dir = output.string();
+    const std::vector<std::string> paths = {photo, "data/missing_photo.jpg", photo, photo};
+    const BatchReport report = solveBatch(paths, {}, batch);
+    EXPECT_EQ(report.workers, 2);
+    EXPECT_GE(report.threads_per_worker, 1);
+    ASSERT_EQ(report.items.size(), 4u);
+    EXPECT_EQ(report.failed(), 1u);
+
+    // photos are reported in the order of paths with unique names, a failed one does not stop others
+    const std::vector<std::string> names = {"00_photo_six_parts_downscaled_x4", "missing_photo", "00_photo_six_parts_downscaled_x4_1",
+                                            "00_photo_six_parts_downscaled_x4_2"};
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        const BatchItem &item = report.items[i];
+        EXPECT_EQ(item.path, paths[i]);
+        EXPECT_EQ(item.name, names[i]);
+        EXPECT_TRUE(fs::exists(output / (item.name + ".json"))) << item.name;
+        if (i == 1) {
+            EXPECT_FALSE(item.ok);
+            EXPECT_FALSE(item.error.empty());
+            continue;
+        }
+        EXPECT_TRUE(item.ok) << item.error;
+        EXPECT_GT(item.latency, 0.0);
+        EXPECT_EQ(item.result.assembly.cells, expected.assembly.cells);
+        EXPECT_EQ(item.result.assembly.cost, expected.assembly.cost);
+    }
+    EXPECT_TRUE(fs::exists(output / "report.json"));
+
+    EXPECT_GT(report.imagesPerSecond(), 0.0);
+    EXPECT_LE(report.latencyPercentile(50.0), report.latencyPercentile(99.0));
+    EXPECT_LE(report.latencyPercentile(99.0), report.seconds);
+    const std::string json = toJson(report);
+    EXPECT_NE(json.find("\"images\": 4, \"failed\": 1"), std::string::npos);
+    EXPECT_NE(json.find("\"latency_p99\": "), std::string::npos);
+    fs::remove_all(output);
+}
+
+TEST(batch_solver, uniqueNames) {
+    const fs::path output = testDirectory("batch_solver_uniqueNames");
+
+    // a suffixed name may already be taken by another photo, and report.json is reserved for the report
+    BatchParams batch;
+    batch.output_dir = output.string();
+    const std::vector<std::string> paths = {"a.jpg", "a_1.jpg", "a.jpg", "report.jpg"};
+    const BatchReport report = solveBatch(paths, {}, batch);
+    ASSERT_EQ(report.items.size(), 4u);
+    const std::vector<std::string> names = {"a", "a_1", "a_2", "report_1"};
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        EXPECT_EQ(report.items[i].name, names[i]);
+        EXPECT_TRUE(fs::exists(output / (names[i] + ".json"))) << names[i];
+    }
+
+    std::ifstream in(output / "report.json");
+    const std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_NE(json.find("\"images\": 4, \"failed\": 4"), std::string::npos);
+    fs::remove_all(output);
+}
+
+TEST(batch_solver, emptyBatch) {
+    const BatchReport report = solveBatch({});
+    EXPECT_TRUE(report.items.empty());
+    EXPECT_EQ(report.failed(), 0u);
+    EXPECT_EQ(report.latencyPercentile(99.0), 0.0);
+}
+
+TEST(batch_solver, listBatchInputs) {
+    const fs::path dir = testDirectory("batch_solver_listBatchInputs");
+    for (const std::string name : {"b.jpg", "a.PNG", "c.jpeg", "notes.txt"})
+        std::ofstream(dir / name) << "x";
+    fs::create_directories(dir / "nested.jpg");
+
+    const std::vector<std::string> photos = listBatchInputs(dir.string());
+    const std::vector<std::string> expected = {(dir / "a.PNG").string(), (dir / "b.jpg").string(), (dir / "c.jpeg").string()};
+    EXPECT_EQ(photos, expected);
+
+    // relative paths of a list are relative to the list
+    std::ofstream(dir / "list.txt") << "b.jpg\n\n  /absolute/photo.jpg \r\n";
+    const std::vector<std::string> listed = listBatchInputs((dir / "list.txt").string());
+    const std::vector<std::string> expected_listed = {(dir / "b.jpg").string(), "/absolute/photo.jpg"};
+    EXPECT_EQ(listed, expected_listed);
+
+    EXPECT_THROW(listBatchInputs((dir / "missing.txt").string()), std::exception);
+    fs::remove_all(dir);
+}
@@ -0,0 +1,95 @@
+#include "piece_processor.h"
+
+#include <libbase/fast_random.h>
+#include <libbase/runtime_assert.h>
+#include <libimages/algorithms/extract_contour.h>
+#include <libimages/algorithms/split_into_parts.h>
+#include <libimages/debug_io.h>
+#include <libimages/draw.h>
+
+#include <exception>
+#include <mutex>
+
+Piece processPiece(int index, point2i offset, ImageView<const std::uint8_t> image, image8u mask,
+                   const std::vector<point2i> &contour, const PieceParams &params) {
+    rassert(mask.width() == image.width() && mask.height() == image.height(), 5512983401, mask.width(), image.width());
+    rassert(!contour.empty(), 5512983402, index);
+
+    Piece piece;
+    piece.offset = offset;
+    piece.image = image;
+    piece.mask = std::move(mask);
+
+    const bool dump = !params.debug_dir.empty();
+    const std::string obj_debug_dir = params.debug_dir + "objects/object" + std::to_string(index) + "/";
+    if (dump) {
+        debug_io::dump_image(obj_debug_dir + "01_image.jpg", piece.image);
+        debug_io::dump_image(obj_debug_dir + "02_mask.jpg", piece.mask);
+    }
+
+    piece.contour = ChainCode::fromContour(contour);
+    piece.contour.translate(-offset);
+    const std::vector<point2i> points = piece.contour.toPoints();
+
+    if (dump) {
+        // brightness grows along the contour (to check that it is clockwise)
+        image32f contour_visualization(image.width(), image.height(), 1);
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            drawPoint(contour_visualization, points[i], color32f(i * 255.0f / points.size()));
+        }
+        debug_io::dump_image(obj_debug_dir + "04_mask_contour_clockwise.jpg", contour_visualization);
+    }
+
+    piece.corners = simplifyContourIndices(points, params.corners, params.corner_method);
+    rassert(piece.corners.size() == params.corners, 5512983403, index, piece.corners.size());
+
+    if (dump) {
+        image32f corners_visualization(image.width(), image.height(), 1);
+        for (std::size_t corner : piece.corners) {
+            drawPoint(corners_visualization, points[corner], color32f(255.0f), 10);
+        }
+        debug_io::dump_image(obj_debug_dir + "05_corners_visualization.jpg", corners_visualization);
+    }
+
+    piece.sides = splitContourByCornerIndices(points.size(), piece.corners);
+
+    if (dump) {
+        image8u sides_visualization(image.width(), image.height(), 3);
+        FastRandom r(2391);
+        for (std::size_t k = 0; k < piece.sides.size(); ++k) {
+            color8u side_color = {(uint8_t) r.nextInt(0, 255), (uint8_t) r.nextInt(0, 255), (uint8_t) r.nextInt(0, 255)};
+            drawPoints(sides_visualization, piece.side(k).toPoints(), side_color);
+        }
+        debug_io::dump_image(obj_debug_dir + "06_sides.jpg", sides_visualization);
+    }
+
+    return piece;
+}
+
+std::vector<Piece> processPieces(const image8u &image, const ConnectedComponents &components,
+                                 const PieceParams &params, bool with_openmp) {
+    auto [offsets, images, masks] = splitObjects(image, components);
+    const std::vector<std::vector<point2i>> contours = extractContours(components, with_openmp);
+
+    const int count = static_cast<int>(offsets.size());
+    std::vector<Piece> pieces(count);
+
+    // exceptions must not leave the parallel region: the first caught one is rethrown after it
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    #pragma omp parallel for schedule(dynamic, 1) if(with_openmp)
+    for (int k = 0; k < count; ++k) {
+        try {
+            pieces[k] = processPiece(k, offsets[k], images[k], std::move(masks[k]), contours[k], params);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
+
+    return pieces;
+}
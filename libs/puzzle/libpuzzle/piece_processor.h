@@ -0,0 +1,45 @@
+#pragma once
+
+#include <libbase/point2.h>
+#include <libimages/algorithms/connected_components.h>
+#include <libimages/algorithms/simplify_contours.h>
+#include <libimages/chain_code.h>
+#include <libimages/image.h>
+#include <libimages/image_view.h>
+
+#include <string>
+#include <vector>
+
+struct PieceParams {
+    std::size_t corners = 4;
+    SimplifyMethod corner_method = SimplifyMethod::Prefiltered;
+    // if not empty - debug images of every piece are saved to debug_dir + "objects/object<index>/"
+    std::string debug_dir;
+};
+
+// One puzzle piece cut out of the board photo, everything is in piece coordinates (relative to offset)
+struct Piece {
+    point2i offset;                     // top-left corner of the piece bbox in the board image
+    ImageView<const std::uint8_t> image; // bbox of the piece in the board image (not a copy)
+    image8u mask;                       // 255 = pixel of this piece
+    ChainCode contour;                  // clockwise outer contour
+    std::vector<std::size_t> corners;   // increasing indices into contour
+    std::vector<ContourRange> sides;    // sides[k] goes from corners[k] to the next corner (both included)
+
+    // Points of side k without copying them (valid while this piece is alive and not moved)
+    ChainCodeSlice side(std::size_t k) const { return contour.slice(sides.at(k).begin, sides.at(k).length); }
+};
+
+// Per-piece stage of the pipeline: contour (in board coordinates) -> corners -> sides, plus debug dumps.
+// index is only used for the debug directory name.
+Piece processPiece(int index, point2i offset, ImageView<const std::uint8_t> image, image8u mask,
+                   const std::vector<point2i> &contour, const PieceParams &params = {});
+
+// Splits the board into components.components.size() pieces and processes them in parallel.
+// pieces[k] is the piece of components.components[k] regardless of the number of threads.
+std::vector<Piece> processPieces(const image8u &image, const ConnectedComponents &components,
+                                 const PieceParams &params = {}, bool with_openmp = true);
+
+// Pieces would be views into a destroyed temporary.
+std::vector<Piece> processPieces(image8u &&image, const ConnectedComponents &components,
+                                 const PieceParams &params = {}, bool with_openmp = true) = delete;
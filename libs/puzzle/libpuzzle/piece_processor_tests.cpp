@@ -0,0 +1,65 @@
+#include "piece_processor.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/configure_working_directory.h>
+#include <libimages/algorithms/extract_contour.h>
+#include <libpuzzle/tests_utils.h>
+
+#include <filesystem>
+
+TEST(piece_processor, samplePieces) {
+    configureWorkingDirectory();
+
+    const SamplePhoto photo = samplePhotoPieces();
+    const ConnectedComponents &components = photo.components;
+    const std::vector<Piece> &pieces = photo.pieces;
+    ASSERT_EQ(pieces.size(), 6u);
+
+    const std::vector<std::vector<point2i>> contours = extractContours(components);
+    for (std::size_t k = 0; k < pieces.size(); ++k) {
+        const Piece &piece = pieces[k];
+        EXPECT_EQ(piece.offset, components.components[k].bbox.min);
+        EXPECT_EQ(piece.image.width(), piece.mask.width());
+        ASSERT_EQ(piece.contour.size(), contours[k].size());
+        EXPECT_EQ(piece.contour[0] + piece.offset, contours[k][0]);
+
+        ASSERT_EQ(piece.corners.size(), 4u);
+        ASSERT_EQ(piece.sides.size(), 4u);
+        std::size_t perimeter = 0;
+        for (std::size_t s = 0; s < 4; ++s) {
+            EXPECT_EQ(piece.side(s).front(), piece.contour[piece.corners[s]]);
+            EXPECT_EQ(piece.side(s).back(), piece.contour[piece.corners[(s + 1) % 4]]);
+            perimeter += piece.sides[s].length - 1;
+        }
+        EXPECT_EQ(perimeter, piece.contour.size());
+    }
+}
+
+TEST(piece_processor, deterministicWithThreadsAndDumps) {
+    configureWorkingDirectory();
+
+    PieceParams params;
+    params.debug_dir = "debug/unit-tests/piece_processor/deterministicWithThreadsAndDumps/";
+    std::filesystem::remove_all(params.debug_dir);
+
+    const SamplePhoto photo = samplePhotoPieces(params, true);
+    const std::vector<Piece> &parallel = photo.pieces;
+    const std::vector<Piece> sequential = processPieces(photo.image, photo.components, {}, false);
+    ASSERT_EQ(parallel.size(), sequential.size());
+    for (std::size_t k = 0; k < parallel.size(); ++k) {
+        EXPECT_EQ(parallel[k].offset, sequential[k].offset);
+        EXPECT_EQ(parallel[k].contour, sequential[k].contour);
+        EXPECT_EQ(parallel[k].corners, sequential[k].corners);
+        EXPECT_EQ(parallel[k].sides, sequential[k].sides);
+        EXPECT_TRUE(std::filesystem::exists(params.debug_dir + "objects/object" + std::to_string(k) + "/06_sides.jpg"));
+    }
+}
+
+TEST(piece_processor, errorsLeaveParallelLoop) {
+    configureWorkingDirectory();
+
+    PieceParams params;
+    params.corners = 1; // splitting into sides needs at least 2 corners
+    EXPECT_THROW(samplePhotoPieces(params), assertion_error);
+}
@@ -0,0 +1,50 @@
+#include "puzzle_solver.h"
+
+#include <libbase/timer.h>
+#include <libimages/algorithms/connected_components.h>
+#include <libimages/algorithms/morphology.h>
+#include <libpuzzle/side_descriptor.h>
+
+#include <sstream>
+
+SolverResult solvePuzzle(const image8u &image, const SolverParams &params, bool with_openmp) {
+    SolverResult result;
+    Timer t;
+    const ForegroundSegmentation segmentation = segmentForeground(image, params.foreground, with_openmp);
+    const BitMask mask = morphology::open(morphology::close(segmentation.mask, params.morphology_strength, with_openmp),
+                                          params.morphology_strength, with_openmp);
+    const ConnectedComponents components = findConnectedComponents(mask, with_openmp);
+    result.segmentation_time = t.elapsed();
+
+    t.restart();
+    const std::vector<Piece> pieces = processPieces(image, components, params.pieces, with_openmp);
+    const SideDescriptorTable table = SideDescriptorTable::build(pieces, with_openmp);
+    result.pieces_count = static_cast<int>(pieces.size());
+    result.sides_count = table.size();
+    result.pieces_time = t.elapsed();
+
+    t.restart();
+    const SideCandidateIndex candidates = SideCandidateIndex::build(table, params.candidates, with_openmp);
+    result.matching_time = t.elapsed();
+
+    t.restart();
+    result.assembly = assemblePuzzle(table, candidates, params.assembly, with_openmp);
+    result.assembly_time = t.elapsed();
+    return result;
+}
+
+std::string toJson(const SolverResult &result) {
+    const Assembly &assembly = result.assembly;
+    std::ostringstream out;
+    out << "{\"pieces\": " << result.pieces_count << ", \"sides\": " << result.sides_count << ", \"components\": " << assembly.components
+        << ", \"edges\": " << assembly.edges << ", \"cost\": " << assembly.cost << ", \"search_nodes\": " << assembly.search_nodes
+        << ", \"times\": {\"segmentation\": " << result.segmentation_time << ", \"pieces\": " << result.pieces_time
+        << ", \"matching\": " << result.matching_time << ", \"assembly\": " << result.assembly_time << "}, \"placements\": [";
+    for (std::size_t piece = 0; piece < assembly.placements.size(); ++piece) {
+        const PiecePlacement &placement = assembly.placements[piece];
+        out << (piece == 0 ? "" : ", ") << "{\"piece\": " << piece << ", \"component\": " << placement.component << ", \"x\": " << placement.x
+            << ", \"y\": " << placement.y << ", \"rotation\": " << placement.rotation << "}";
+    }
+    out << "]}";
+    return out.str();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <libimages/algorithms/foreground_segmentation.h>
+#include <libimages/image.h>
+#include <libpuzzle/assembly.h>
+#include <libpuzzle/piece_processor.h>
+#include <libpuzzle/side_candidates.h>
+
+#include <cstddef>
+#include <string>
+
+struct SolverParams {
+    ForegroundParams foreground;
+    int morphology_strength = 3; // close then open of the foreground mask
+    PieceParams pieces;
+    CandidateParams candidates;
+    AssemblyParams assembly = {.beam_width = 16};
+};
+
+struct SolverResult {
+    int pieces_count = 0;
+    std::size_t sides_count = 0;
+    Assembly assembly;
+    // time of every stage (in seconds)
+    double segmentation_time = 0.0; // foreground mask, morphology and connected components
+    double pieces_time = 0.0;       // contours, corners, sides and their descriptors
+    double matching_time = 0.0;     // candidates of sides
+    double assembly_time = 0.0;
+};
+
+// The whole pipeline without debug output: foreground mask -> pieces -> side descriptors -> candidates -> assembly.
+// Throws (like the stages do) if the photo does not fit the pipeline, e.g. a piece does not have 4 sides.
+SolverResult solvePuzzle(const image8u &image, const SolverParams &params = {}, bool with_openmp = true);
+
+// One JSON object with the placements of all pieces, the costs and the times
+std::string toJson(const SolverResult &result);
@@ -0,0 +1,30 @@
+#include "puzzle_solver.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/configure_working_directory.h>
+#include <libimages/image_io.h>
+
+TEST(puzzle_solver, samplePhoto) {
+    configureWorkingDirectory();
+
+    const image8u img = load_image("data/00_photo_six_parts_downscaled_x4.jpg");
+    const SolverResult result = solvePuzzle(img);
+    EXPECT_EQ(result.pieces_count, 6);
+    EXPECT_EQ(result.sides_count, 24u);
+    // 6 pieces of the photo form a 3 x 2 grid
+    EXPECT_EQ(result.assembly.components, 1);
+    EXPECT_EQ(result.assembly.edges, 7u);
+    EXPECT_EQ(result.assembly.placements.size(), 6u);
+
+    // the same without threads
+    const SolverResult single_thread = solvePuzzle(img, {}, false);
+    EXPECT_EQ(single_thread.assembly.cells, result.assembly.cells);
+    EXPECT_EQ(single_thread.assembly.cost, result.assembly.cost);
+
+    const std::string json = toJson(result);
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find("\"components\": 1"), std::string::npos);
+    EXPECT_NE(json.find("{\"piece\": 5, "), std::string::npos);
+}
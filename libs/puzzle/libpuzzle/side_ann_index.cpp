@@ -0,0 +1,237 @@
+#include "side_ann_index.h"
+
+#include "side_matching_kernels.h"
+
+#include <libbase/fast_random.h>
+#include <libbase/runtime_assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace {
+
+constexpr int kLength = SideDescriptorTable::kChannels * SideDescriptorTable::kProfileLength;
+
+// Nodes visited by the current search of this thread: tags equal to the epoch (so they are not cleared between searches)
+struct Visited {
+    std::vector<std::uint32_t> tags;
+    std::uint32_t epoch = 0;
+
+    void reset(std::size_t n) {
+        if (tags.size() != n || ++epoch == 0) {
+            tags.assign(n, 0);
+            epoch = 1;
+        }
+    }
+    bool insert(int node) {
+        if (tags[node] == epoch)
+            return false;
+        tags[node] = epoch;
+        return true;
+    }
+};
+
+thread_local Visited visited;
+
+template <typename T>
+bool closer(const T &a, const T &b) {
+    return a.distance < b.distance || (a.distance == b.distance && a.node < b.node);
+}
+
+template <typename T>
+bool farther(const T &a, const T &b) {
+    return closer(b, a);
+}
+
+void reverseProfile(const float *src, float *dst) {
+    const int L = SideDescriptorTable::kProfileLength;
+    for (int c = 0; c < SideDescriptorTable::kChannels; ++c)
+        std::reverse_copy(src + c * L, src + (c + 1) * L, dst + c * L);
+}
+
+} // namespace
+
+SideAnnIndex SideAnnIndex::build(const SideDescriptorTable &table, const AnnParams &params) {
+    rassert(params.m >= 2 && params.ef_construction >= 1 && params.ef_search >= 1, 6601734401, params.m, params.ef_construction, params.ef_search);
+
+    const int n = static_cast<int>(table.size());
+    SideAnnIndex index;
+    index.params_ = params;
+    index.profiles_.assign(table.colors(0), table.colors(0) + static_cast<std::size_t>(n) * kLength);
+    index.pieces_.resize(n);
+    index.piece_sides_.assign(table.piecesCount(), 0);
+    for (int i = 0; i < n; ++i) {
+        index.pieces_[i] = table.piece(i);
+        ++index.piece_sides_[table.piece(i)];
+    }
+
+    // levels are geometrically distributed: a node reaches every next level with probability 1 / m
+    FastRandom r(params.seed);
+    const double level_multiplier = 1.0 / std::log(static_cast<double>(params.m));
+    index.links_.resize(n);
+    for (int i = 0; i < n; ++i) {
+        const double u = std::max(1.0 - r.nextFloat(), 1e-7);
+        const int level = static_cast<int>(-std::log(u) * level_multiplier);
+        index.insert(i, level);
+    }
+    return index;
+}
+
+const float *SideAnnIndex::profile(int node) const {
+    return profiles_.data() + static_cast<std::size_t>(node) * kLength;
+}
+
+float SideAnnIndex::distance(const float *profile, int node) const {
+    const side_matching_kernels::Kernels &kernels = side_matching_kernels::currentKernels();
+    const std::ptrdiff_t row = node;
+    float sum = 0.0f;
+    (params_.metric == SideMetric::L1 ? kernels.l1_rows : kernels.l2_rows)(profile, profiles_.data(), &row, 1, kLength, &sum);
+    return sum;
+}
+
+// Best-first search of ef nodes closest to the profile on the level starting from the entries, results are ordered by distance
+std::vector<SideAnnIndex::Scored> SideAnnIndex::searchLayer(const float *profile, const std::vector<Scored> &entries, int ef, int level) const {
+    const side_matching_kernels::Kernels &kernels = side_matching_kernels::currentKernels();
+    const auto rows_kernel = params_.metric == SideMetric::L1 ? kernels.l1_rows : kernels.l2_rows;
+
+    visited.reset(size());
+    std::priority_queue<Scored, std::vector<Scored>, decltype(&farther<Scored>)> candidates(farther<Scored>); // the closest on top
+    std::priority_queue<Scored, std::vector<Scored>, decltype(&closer<Scored>)> results(closer<Scored>);      // the farthest on top
+    for (const Scored &entry : entries) {
+        visited.insert(entry.node);
+        candidates.push(entry);
+        results.push(entry);
+        if (static_cast<int>(results.size()) > ef)
+            results.pop();
+    }
+
+    std::vector<std::ptrdiff_t> rows;
+    std::vector<float> distances;
+    while (!candidates.empty()) {
+        const Scored current = candidates.top();
+        if (static_cast<int>(results.size()) >= ef && farther(current, results.top()))
+            break;
+        candidates.pop();
+
+        // distances to all not yet visited neighbours at once
+        rows.clear();
+        for (int neighbour : links_[current.node][level]) {
+            if (visited.insert(neighbour))
+                rows.push_back(neighbour);
+        }
+        distances.resize(rows.size());
+        rows_kernel(profile, profiles_.data(), rows.data(), static_cast<int>(rows.size()), kLength, distances.data());
+
+        for (std::size_t j = 0; j < rows.size(); ++j) {
+            const Scored neighbour{distances[j], static_cast<int>(rows[j])};
+            if (static_cast<int>(results.size()) < ef || closer(neighbour, results.top())) {
+                candidates.push(neighbour);
+                results.push(neighbour);
+                if (static_cast<int>(results.size()) > ef)
+                    results.pop();
+            }
+        }
+    }
+
+    std::vector<Scored> nearest(results.size());
+    for (std::size_t j = nearest.size(); j-- > 0; results.pop())
+        nearest[j] = results.top();
+    return nearest;
+}
+
+// Heuristic of HNSW: a candidate is linked only if it is closer to the node than to every already selected neighbour,
+// so links spread in different directions instead of one dense cluster
+std::vector<int> SideAnnIndex::selectNeighbours(const std::vector<Scored> &candidates, int max_count) const {
+    const side_matching_kernels::Kernels &kernels = side_matching_kernels::currentKernels();
+    const auto rows_kernel = params_.metric == SideMetric::L1 ? kernels.l1_rows : kernels.l2_rows;
+
+    std::vector<int> selected;
+    std::vector<std::ptrdiff_t> rows;
+    std::vector<float> distances;
+    for (const Scored &candidate : candidates) {
+        if (static_cast<int>(selected.size()) >= max_count)
+            break;
+        rows.assign(selected.begin(), selected.end());
+        distances.resize(rows.size());
+        rows_kernel(profile(candidate.node), profiles_.data(), rows.data(), static_cast<int>(rows.size()), kLength, distances.data());
+        if (std::all_of(distances.begin(), distances.end(), [&](float d) { return d >= candidate.distance; }))
+            selected.push_back(candidate.node);
+    }
+    return selected;
+}
+
+void SideAnnIndex::insert(int node, int level) {
+    links_[node].resize(level + 1);
+    if (entry_ == -1) {
+        entry_ = node;
+        top_level_ = level;
+        return;
+    }
+
+    const float *q = profile(node);
+    std::vector<Scored> entries = {{distance(q, entry_), entry_}};
+    for (int l = top_level_; l > level; --l)
+        entries = searchLayer(q, entries, 1, l);
+
+    for (int l = std::min(level, top_level_); l >= 0; --l) {
+        entries = searchLayer(q, entries, params_.ef_construction, l);
+        links_[node][l] = selectNeighbours(entries, params_.m);
+
+        // back links, a neighbour with too many links keeps the best of them by the same heuristic
+        for (int neighbour : links_[node][l]) {
+            std::vector<int> &links = links_[neighbour][l];
+            links.push_back(node);
+            if (static_cast<int>(links.size()) <= maxLinks(l))
+                continue;
+            std::vector<Scored> scored;
+            scored.reserve(links.size());
+            for (int other : links)
+                scored.push_back({distance(profile(neighbour), other), other});
+            std::sort(scored.begin(), scored.end(), closer<Scored>);
+            links = selectNeighbours(scored, maxLinks(l));
+        }
+    }
+
+    if (level > top_level_) {
+        entry_ = node;
+        top_level_ = level;
+    }
+}
+
+std::vector<SideCandidate> SideAnnIndex::search(const float *profile, std::size_t k, int ef) const {
+    std::vector<SideCandidate> result;
+    if (entry_ == -1 || k == 0)
+        return result;
+
+    std::vector<Scored> entries = {{distance(profile, entry_), entry_}};
+    for (int l = top_level_; l > 0; --l)
+        entries = searchLayer(profile, entries, 1, l);
+    entries = searchLayer(profile, entries, std::max(ef > 0 ? ef : params_.ef_search, static_cast<int>(k)), 0);
+
+    for (std::size_t j = 0; j < std::min(k, entries.size()); ++j) {
+        const float mean = entries[j].distance / kLength;
+        result.push_back({static_cast<std::size_t>(entries[j].node), params_.metric == SideMetric::L1 ? mean : std::sqrt(mean)});
+    }
+    return result;
+}
+
+std::vector<SideCandidate> SideAnnIndex::query(std::size_t i, std::size_t k, QueryDirection direction, int ef) const {
+    rassert(i < size(), 6601734402, i, size());
+
+    std::vector<float> reversed;
+    const float *q = profile(static_cast<int>(i));
+    if (direction == QueryDirection::Reversed) {
+        reversed.resize(kLength);
+        reverseProfile(q, reversed.data());
+        q = reversed.data();
+    }
+
+    // sides of the same piece can be among the nearest ones, so a few more are searched
+    const int piece = pieces_[i];
+    std::vector<SideCandidate> result = search(q, k + piece_sides_[piece], ef);
+    std::erase_if(result, [&](const SideCandidate &candidate) { return pieces_[candidate.side] == piece; });
+    if (result.size() > k)
+        result.resize(k);
+    return result;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <libpuzzle/side_candidates.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class QueryDirection {
+    Forward,  // sides with the same color profile
+    Reversed, // sides with the same color profile traversed in the opposite direction - sides that fit together (as in compareSides)
+};
+
+struct AnnParams {
+    SideMetric metric = SideMetric::L1;
+    int m = 12;               // links of a node on upper layers (2 * m on the bottom layer)
+    int ef_construction = 64; // size of the candidates list while inserting a node
+    int ef_search = 48;       // default size of the candidates list of a query
+    std::uint32_t seed = 239;
+};
+
+// Approximate nearest neighbour search over color profiles of sides (HNSW: hierarchical navigable small world graph).
+//
+// Every side is a node of a layered proximity graph, the bottom layer contains all sides and every next layer is
+// an exponentially smaller random subset of the previous one. A query greedily descends from the top layer
+// and then runs a best-first search of ef candidates on the bottom layer, so it takes about O(log n) distance computations
+// instead of n. Results are approximate: a true neighbour may be missed (see recall in side_ann_index_benchmark.cpp).
+// Nodes are inserted sequentially (the graph is deterministic for a given seed), queries are thread-safe.
+class SideAnnIndex final {
+  public:
+    SideAnnIndex() = default;
+
+    static SideAnnIndex build(const SideDescriptorTable &table, const AnnParams &params = {});
+
+    std::size_t size() const noexcept { return pieces_.size(); }
+    int levels() const noexcept { return static_cast<int>(top_level_) + 1; }
+
+    // k approximate nearest sides to a color profile (kChannels x kProfileLength values as SideDescriptor::colors),
+    // ordered by difference (ef = 0 means params.ef_search, at least k is used)
+    std::vector<SideCandidate> search(const float *profile, std::size_t k, int ef = 0) const;
+
+    // k approximate best matches of side i of the table among sides of other pieces
+    std::vector<SideCandidate> query(std::size_t i, std::size_t k, QueryDirection direction = QueryDirection::Reversed, int ef = 0) const;
+
+  private:
+    struct Scored {
+        float distance; // unnormalized sum of differences
+        int node;
+    };
+
+    float distance(const float *profile, int node) const;
+    std::vector<Scored> searchLayer(const float *profile, const std::vector<Scored> &entries, int ef, int level) const;
+    std::vector<int> selectNeighbours(const std::vector<Scored> &candidates, int max_count) const;
+    void insert(int node, int level);
+
+    const float *profile(int node) const;
+    int maxLinks(int level) const { return level == 0 ? 2 * params_.m : params_.m; }
+
+    AnnParams params_;
+    std::vector<float> profiles_;                // kChannels * kProfileLength values per side
+    std::vector<int> pieces_;                    // piece of every side
+    std::vector<int> piece_sides_;               // sides count of every piece
+    std::vector<std::vector<std::vector<int>>> links_; // links_[node][level] - neighbours of the node on the level
+    int entry_ = -1;
+    int top_level_ = -1;
+};
@@ -0,0 +1,64 @@
+#include "side_ann_index.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/configure_working_directory.h>
+#include <libimages/benchmark_utils.h>
+#include <libpuzzle/tests_utils.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+// Recall and latency of k approximate best matches of every side against the exact ones (top-k of all pairs without the prefilter)
+void benchmarkRecall(const std::string &name, const std::vector<Piece> &pieces) {
+    const SideDescriptorTable table = SideDescriptorTable::build(pieces);
+    const std::size_t k = 4;
+
+    CandidateParams exact_params;
+    exact_params.k = k;
+    exact_params.max_length_ratio = std::numeric_limits<float>::max();
+    exact_params.max_chord_ratio = std::numeric_limits<float>::max();
+    SideCandidateIndex exact;
+    benchmark(name + ": exact top-4 of all pairs", [&]() { exact = SideCandidateIndex::build(table, exact_params); }, 1);
+
+    SideAnnIndex index;
+    benchmark(name + ": SideAnnIndex::build", [&]() { index = SideAnnIndex::build(table); }, 1);
+
+    for (int ef : {16, 48, 128}) {
+        std::size_t found = 0;
+        const double time = benchmark(name + ": SideAnnIndex queries ef=" + std::to_string(ef), [&]() {
+            found = 0;
+            for (std::size_t a = 0; a < table.size(); ++a) {
+                for (const SideCandidate &candidate : index.query(a, k, QueryDirection::Reversed, ef)) {
+                    for (const SideCandidate &expected : exact.candidates(a))
+                        found += expected.side == candidate.side;
+                }
+            }
+        }, 1);
+        std::cout << name << ": ef=" << ef << " recall@4 " << 100.0 * found / (k * table.size()) << "%, "
+                  << 1e6 * time / table.size() << " us per query" << std::endl;
+    }
+}
+
+} // namespace
+
+TEST(side_ann_index_benchmark, samplePhoto) {
+    configureWorkingDirectory();
+
+    benchmarkRecall("24 sample sides", samplePhotoPieces().pieces);
+}
+
+TEST(side_ann_index_benchmark, syntheticBoards) {
+    // 2000 pieces = 8000 sides
+    const int pieces_count = 2000;
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    const ConnectedComponents components = findConnectedComponents(mask);
+    // all pieces of the synthetic board have the same colors, only a noise of the colors tells sides apart (the hardest case)
+    const image8u board = makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    benchmarkRecall("8000 sides", processPieces(board, components));
+    const image8u tinted = makeTintedBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    benchmarkRecall("8000 tinted sides", processPieces(tinted, components));
+}
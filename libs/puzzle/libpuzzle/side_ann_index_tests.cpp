@@ -0,0 +1,87 @@
+#include "side_ann_index.h"
+
+#include <gtest/gtest.h>
+
+#include <libpuzzle/tests_utils.h>
+
+#include <algorithm>
+
+namespace {
+
+// Exact k best sides of other pieces for side a
+std::vector<std::size_t> exactNearest(const SideDescriptorTable &table, std::size_t a, std::size_t k, QueryDirection direction, SideMetric metric) {
+    SideDescriptor query = table[a];
+    const int L = SideDescriptorTable::kProfileLength;
+    std::vector<float> reversed(SideDescriptorTable::kChannels * L);
+    if (direction == QueryDirection::Forward) {
+        // compareSides reverses the second side, so the forward difference is the one with the reversed query
+        for (int c = 0; c < SideDescriptorTable::kChannels; ++c)
+            std::reverse_copy(query.colors + c * L, query.colors + (c + 1) * L, reversed.begin() + c * L);
+        query.colors = reversed.data();
+    }
+    std::vector<std::pair<float, std::size_t>> all;
+    for (std::size_t b = 0; b < table.size(); ++b) {
+        if (table.piece(b) != table.piece(a))
+            all.emplace_back(compareSides(query, table[b], metric), b);
+    }
+    std::sort(all.begin(), all.end());
+    std::vector<std::size_t> nearest;
+    for (std::size_t j = 0; j < std::min(k, all.size()); ++j)
+        nearest.push_back(all[j].second);
+    return nearest;
+}
+
+} // namespace
+
+TEST(side_ann_index, searchFindsItself) {
+    const SyntheticBoard board = makeColoredBoard(12, 10);
+    const SideDescriptorTable table = SideDescriptorTable::build(board.pieces);
+    const SideAnnIndex index = SideAnnIndex::build(table);
+    ASSERT_EQ(index.size(), table.size());
+    EXPECT_GT(index.levels(), 1);
+
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        const std::vector<SideCandidate> nearest = index.search(table.colors(i), 3);
+        ASSERT_EQ(nearest.size(), 3u);
+        EXPECT_EQ(nearest[0].side, i);
+        EXPECT_EQ(nearest[0].difference, 0.0f);
+        EXPECT_LE(nearest[1].difference, nearest[2].difference);
+    }
+}
+
+TEST(side_ann_index, recallOfBothDirections) {
+    const SyntheticBoard board = makeColoredBoard(12, 10);
+    const SideDescriptorTable table = SideDescriptorTable::build(board.pieces);
+    const std::size_t k = 4;
+    for (SideMetric metric : {SideMetric::L1, SideMetric::L2}) {
+        AnnParams params;
+        params.metric = metric;
+        const SideAnnIndex index = SideAnnIndex::build(table, params);
+        for (QueryDirection direction : {QueryDirection::Forward, QueryDirection::Reversed}) {
+            std::size_t found = 0;
+            for (std::size_t a = 0; a < table.size(); ++a) {
+                const std::vector<SideCandidate> nearest = index.query(a, k, direction);
+                ASSERT_EQ(nearest.size(), k);
+                const std::vector<std::size_t> expected = exactNearest(table, a, k, direction, metric);
+                for (const SideCandidate &candidate : nearest) {
+                    EXPECT_NE(table.piece(candidate.side), table.piece(a));
+                    found += std::count(expected.begin(), expected.end(), candidate.side);
+                    if (direction == QueryDirection::Reversed) {
+                        // reversed query differences are the differences of compareSides
+                        const float difference = compareSides(table[a], table[candidate.side], metric);
+                        EXPECT_NEAR(candidate.difference, difference, 1e-3f * (1.0f + difference));
+                    }
+                }
+            }
+            EXPECT_GE(found, 0.95 * k * table.size()) << (metric == SideMetric::L1 ? "L1 " : "L2 ") << static_cast<int>(direction);
+        }
+    }
+}
+
+TEST(side_ann_index, emptyTable) {
+    const SideAnnIndex index = SideAnnIndex::build(SideDescriptorTable());
+    EXPECT_EQ(index.size(), 0u);
+    std::vector<float> profile(SideDescriptorTable::kChannels * SideDescriptorTable::kProfileLength, 0.0f);
+    EXPECT_TRUE(index.search(profile.data(), 4).empty());
+    EXPECT_THROW(index.query(0, 4), assertion_error);
+}
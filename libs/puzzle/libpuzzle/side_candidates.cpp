@@ -0,0 +1,204 @@
+#include "side_candidates.h"
+
+#include "side_matching_kernels.h"
+
+#include <libbase/runtime_assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+constexpr int kChannels = SideDescriptorTable::kChannels;
+constexpr int kLength = SideDescriptorTable::kChannels * SideDescriptorTable::kProfileLength;
+
+// Coarse color profiles: means of kSegments equal segments of every channel
+constexpr int kSegments = 8;
+constexpr int kSegmentLength = SideDescriptorTable::kProfileLength / kSegments;
+constexpr int kCoarseLength = kChannels * kSegments;
+static_assert(SideDescriptorTable::kProfileLength % kSegments == 0);
+
+// Sides compared at once by the kernels
+constexpr std::size_t kBatch = 32;
+
+// Lower bounds are computed in another order than the differences themselves, so they are relaxed by float rounding errors
+constexpr float kBoundSlack = 1e-4f;
+
+bool exceeds(float bound, float worst) { return bound > worst + kBoundSlack * (1.0f + worst); }
+
+bool ratioAbove(float a, float b, float max_ratio) { return std::max(a, b) > max_ratio * std::min(a, b); }
+
+// Orders candidates by difference, then by side index (so results do not depend on the order of comparisons)
+bool better(const SideCandidate &a, const SideCandidate &b) {
+    return a.difference < b.difference || (a.difference == b.difference && a.side < b.side);
+}
+
+} // namespace
+
+SideCandidateIndex SideCandidateIndex::build(const SideDescriptorTable &table, const CandidateParams &params, bool with_openmp) {
+    rassert(params.k > 0, 7719203401);
+    rassert(params.max_length_ratio > 1.0f && params.max_chord_ratio >= 1.0f, 7719203402, params.max_length_ratio, params.max_chord_ratio);
+
+    const std::ptrdiff_t n = static_cast<std::ptrdiff_t>(table.size());
+    SideCandidateIndex index;
+    index.k_ = params.k;
+    index.candidates_.resize(n * params.k);
+    index.counts_.resize(n, 0);
+    if (n == 0)
+        return index;
+
+    // pairs of sides of different pieces
+    std::vector<std::size_t> piece_sides(table.piecesCount(), 0);
+    for (std::ptrdiff_t i = 0; i < n; ++i)
+        ++piece_sides[table.piece(i)];
+    std::size_t total_pairs = static_cast<std::size_t>(n) * n;
+    for (std::size_t sides : piece_sides)
+        total_pairs -= sides * sides;
+
+    // sides are split into buckets of lengths in [max_length_ratio^t, max_length_ratio^(t + 1)),
+    // so the prefilter passes only sides of the same and of the two adjacent buckets,
+    // and are sorted by mean brightness in every bucket
+    std::vector<int> bucket(n);
+    std::vector<float> brightness(n);
+    for (std::ptrdiff_t i = 0; i < n; ++i) {
+        bucket[i] = static_cast<int>(std::floor(std::log(table.length(i)) / std::log(params.max_length_ratio)));
+        brightness[i] = static_cast<float>(std::accumulate(table.colors(i), table.colors(i) + kLength, 0.0) / kLength);
+    }
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return bucket[a] < bucket[b] || (bucket[a] == bucket[b] && brightness[a] < brightness[b]);
+    });
+    struct Bucket {
+        int id;
+        std::ptrdiff_t begin, end; // range of positions in the order
+    };
+    std::vector<Bucket> buckets;
+    std::vector<std::size_t> bucket_of(n); // index in buckets of the side at every position
+    for (std::ptrdiff_t p = 0; p < n; ++p) {
+        if (buckets.empty() || buckets.back().id != bucket[order[p]])
+            buckets.push_back({bucket[order[p]], p, p});
+        buckets.back().end = p + 1;
+        bucket_of[p] = buckets.size() - 1;
+    }
+
+    // the search walks along this order, so everything it reads is laid out in it (p is a position in the order):
+    // scalars of the sides, coarse color profiles (means of segments of every channel) and full color profiles,
+    // both as is for side a and reversed for side b
+    std::vector<int> piece(n);
+    std::vector<float> length(n), chord(n), sorted_brightness(n);
+    std::vector<float> coarse(n * kCoarseLength), coarse_reversed(n * kCoarseLength);
+    std::vector<float> profiles(n * kLength);
+    const std::vector<float> table_reversed = side_matching_kernels::reversedProfiles(table, with_openmp);
+    std::vector<float> reversed(n * kLength);
+    #pragma omp parallel for if(with_openmp)
+    for (std::ptrdiff_t p = 0; p < n; ++p) {
+        const std::size_t i = order[p];
+        piece[p] = table.piece(i);
+        length[p] = table.length(i);
+        chord[p] = table.chord(i);
+        sorted_brightness[p] = brightness[i];
+        std::copy(table.colors(i), table.colors(i) + kLength, profiles.begin() + p * kLength);
+        std::copy(table_reversed.begin() + i * kLength, table_reversed.begin() + (i + 1) * kLength, reversed.begin() + p * kLength);
+        for (int c = 0; c < kChannels; ++c) {
+            for (int s = 0; s < kSegments; ++s) {
+                const float *segment = table.colors(i) + c * SideDescriptorTable::kProfileLength + s * kSegmentLength;
+                const float mean = static_cast<float>(std::accumulate(segment, segment + kSegmentLength, 0.0) / kSegmentLength);
+                coarse[p * kCoarseLength + c * kSegments + s] = mean;
+                coarse_reversed[p * kCoarseLength + c * kSegments + kSegments - 1 - s] = mean;
+            }
+        }
+    }
+
+    const side_matching_kernels::Kernels &kernels = side_matching_kernels::currentKernels();
+    const auto rows_kernel = params.metric == SideMetric::L1 ? kernels.l1_rows : kernels.l2_rows;
+
+    std::size_t compared = 0;
+    #pragma omp parallel if(with_openmp) reduction(+:compared)
+    {
+        std::vector<SideCandidate> heap; // the worst kept candidate is at the front
+        heap.reserve(params.k);
+        std::vector<std::ptrdiff_t> batch, survivors;
+        batch.reserve(kBatch);
+        survivors.reserve(kBatch);
+        std::vector<float> sums(kBatch);
+
+        #pragma omp for schedule(dynamic, 16)
+        for (std::ptrdiff_t pa = 0; pa < n; ++pa) {
+            heap.clear();
+            auto worst = [&]() { return heap.size() < params.k ? std::numeric_limits<float>::infinity() : heap.front().difference; };
+
+            // sides that passed the cheap checks are compared in batches: first by the coarse profiles, then by the full ones
+            auto flush = [&]() {
+                // mean of a segment of the difference is a mean of differences of the coarse profiles,
+                // so the mean absolute difference of the coarse profiles is a lower bound of both L1 and L2
+                kernels.l1_rows(coarse.data() + pa * kCoarseLength, coarse_reversed.data(), batch.data(),
+                                static_cast<int>(batch.size()), kCoarseLength, sums.data());
+                survivors.clear();
+                for (std::size_t j = 0; j < batch.size(); ++j) {
+                    if (!exceeds(sums[j] / kCoarseLength, worst()))
+                        survivors.push_back(batch[j]);
+                }
+                batch.clear();
+
+                rows_kernel(profiles.data() + pa * kLength, reversed.data(), survivors.data(),
+                            static_cast<int>(survivors.size()), kLength, sums.data());
+                compared += survivors.size();
+                for (std::size_t j = 0; j < survivors.size(); ++j) {
+                    const float mean = sums[j] / kLength;
+                    const SideCandidate candidate{order[survivors[j]], params.metric == SideMetric::L1 ? mean : std::sqrt(mean)};
+                    if (heap.size() < params.k) {
+                        heap.push_back(candidate);
+                        std::push_heap(heap.begin(), heap.end(), better);
+                    } else if (better(candidate, heap.front())) {
+                        std::pop_heap(heap.begin(), heap.end(), better);
+                        heap.back() = candidate;
+                        std::push_heap(heap.begin(), heap.end(), better);
+                    }
+                }
+            };
+
+            auto visit = [&](std::ptrdiff_t pb) {
+                if (piece[pb] == piece[pa] || ratioAbove(length[pa], length[pb], params.max_length_ratio)
+                    || ratioAbove(chord[pa], chord[pb], params.max_chord_ratio))
+                    return;
+                batch.push_back(pb);
+                if (batch.size() == kBatch)
+                    flush();
+            };
+
+            // walk away from the brightness of side a in its bucket and in the adjacent ones, always to the closer of the two neighbours,
+            // until the brightness gap (a lower bound of the difference) exceeds the worst kept candidate
+            const std::size_t own = bucket_of[pa];
+            for (std::size_t k : {own, own - 1, own + 1}) {
+                if (k >= buckets.size() || std::abs(buckets[k].id - buckets[own].id) > 1)
+                    continue;
+                const Bucket &range = buckets[k];
+                std::ptrdiff_t hi = std::lower_bound(sorted_brightness.begin() + range.begin, sorted_brightness.begin() + range.end,
+                                                     sorted_brightness[pa]) - sorted_brightness.begin();
+                std::ptrdiff_t lo = hi - 1;
+                while (lo >= range.begin || hi < range.end) {
+                    const float gap_lo = lo >= range.begin ? sorted_brightness[pa] - sorted_brightness[lo] : std::numeric_limits<float>::infinity();
+                    const float gap_hi = hi < range.end ? sorted_brightness[hi] - sorted_brightness[pa] : std::numeric_limits<float>::infinity();
+                    const bool take_lo = gap_lo <= gap_hi;
+                    if (exceeds(take_lo ? gap_lo : gap_hi, worst()))
+                        break;
+                    visit(take_lo ? lo-- : hi++);
+                }
+            }
+
+            flush();
+
+            const std::size_t a = order[pa];
+            std::sort_heap(heap.begin(), heap.end(), better);
+            std::copy(heap.begin(), heap.end(), index.candidates_.begin() + a * params.k);
+            index.counts_[a] = heap.size();
+        }
+    }
+
+    index.compared_pairs_ = compared;
+    index.pruned_pairs_ = total_pairs - compared;
+    return index;
+}
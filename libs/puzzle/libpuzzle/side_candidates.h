@@ -0,0 +1,55 @@
+#pragma once
+
+#include <libpuzzle/side_matching.h>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+struct SideCandidate {
+    std::size_t side = 0;    // row of the SideDescriptorTable
+    float difference = 0.0f; // compareSides() of the side with this candidate
+
+    bool operator==(const SideCandidate &) const = default;
+};
+
+struct CandidateParams {
+    std::size_t k = 4; // candidates kept per side
+    SideMetric metric = SideMetric::L1;
+    // prefilter: sides that fit together have nearly the same arc length and the same distance between their corners
+    // (ratios of the longer value to the shorter one, pairs above them are never compared, max_length_ratio > 1)
+    float max_length_ratio = 1.3f;
+    float max_chord_ratio = 1.2f;
+};
+
+// Top-k best matching sides of other pieces for every side of a table.
+//
+// Pairs are rejected before the color comparison by the length and chord ratios and by a lower bound of the difference:
+// mean absolute difference of coarse color profiles (means of segments of the profiles), never more than both L1 and L2.
+// Sides are bucketed by length and sorted by mean brightness, the search around every side walks only the adjacent buckets
+// and stops as soon as the brightness gap alone exceeds the worst of its k candidates kept in a bounded heap.
+// So candidates are exactly the same as with a full compareSides(table) matrix (with the same prefilter),
+// but only a small part of all pairs is compared.
+class SideCandidateIndex final {
+  public:
+    SideCandidateIndex() = default;
+
+    static SideCandidateIndex build(const SideDescriptorTable &table, const CandidateParams &params = {}, bool with_openmp = true);
+
+    std::size_t size() const noexcept { return counts_.size(); }
+    std::size_t k() const noexcept { return k_; }
+
+    // Candidates of side i ordered by difference (ties by side index), less than k if the prefilter rejected the rest
+    std::span<const SideCandidate> candidates(std::size_t i) const { return {candidates_.data() + i * k_, counts_[i]}; }
+
+    // Pairs (a, b) of sides of different pieces that were compared / rejected without comparison
+    std::size_t comparedPairs() const noexcept { return compared_pairs_; }
+    std::size_t prunedPairs() const noexcept { return pruned_pairs_; }
+
+  private:
+    std::size_t k_ = 0;
+    std::vector<SideCandidate> candidates_; // k_ slots per side
+    std::vector<std::size_t> counts_;
+    std::size_t compared_pairs_ = 0;
+    std::size_t pruned_pairs_ = 0;
+};
@@ -0,0 +1,53 @@
+#include "side_candidates.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/benchmark_utils.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+void benchmarkIndex(const std::string &name, const image8u &board, int pieces_count) {
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    const std::vector<Piece> pieces = processPieces(board, findConnectedComponents(mask));
+    const SideDescriptorTable table = SideDescriptorTable::build(pieces);
+
+    SideCandidateIndex index;
+    benchmark(name + ": SideCandidateIndex::build", [&]() { index = SideCandidateIndex::build(table); });
+    benchmark(name + ": SideCandidateIndex::build single thread", [&]() { SideCandidateIndex::build(table, {}, false); });
+    const std::size_t pairs = index.comparedPairs() + index.prunedPairs();
+    std::cout << name << ": compared " << index.comparedPairs() << " of " << pairs << " pairs ("
+              << 100.0 * index.comparedPairs() / pairs << "%)" << std::endl;
+}
+
+} // namespace
+
+TEST(side_candidates_benchmark, topCandidates4000) {
+    // 1000 pieces = 4000 sides, 16M pairs
+    const int pieces_count = 1000;
+    const image8u board = makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    const std::vector<Piece> pieces = processPieces(board, findConnectedComponents(mask));
+    const SideDescriptorTable table = SideDescriptorTable::build(pieces);
+    const CandidateParams params;
+
+    // as without the index: the full matrix and the best k of every row
+    benchmark("4000 sides: full matrix + top-4 of every row", [&]() {
+        const SideDifferenceMatrix matrix = compareSides(table, params.metric);
+        std::vector<std::size_t> order(table.size());
+        for (std::size_t a = 0; a < table.size(); ++a) {
+            for (std::size_t b = 0; b < table.size(); ++b)
+                order[b] = b;
+            std::partial_sort(order.begin(), order.begin() + params.k, order.end(),
+                              [&](std::size_t x, std::size_t y) { return matrix(a, x) < matrix(a, y); });
+        }
+    }, 1);
+
+    // all pieces of the synthetic board have the same colors, so only a noise of the colors tells sides apart
+    benchmarkIndex("4000 sides", board, pieces_count);
+    // sub-quadratic growth: twice as many pieces on a picture with changing colors
+    benchmarkIndex("4000 tinted sides", makeTintedBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight, pieces_count), pieces_count);
+    benchmarkIndex("8000 tinted sides", makeTintedBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight, 2 * pieces_count), 2 * pieces_count);
+}
@@ -0,0 +1,85 @@
+#include "side_candidates.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/simd_level.h>
+#include <libpuzzle/tests_utils.h>
+
+#include <algorithm>
+
+namespace {
+
+// Top-k by the full matrix with the same prefilter
+std::vector<SideCandidate> bruteForce(const SideDescriptorTable &table, const SideDifferenceMatrix &matrix, std::size_t a, const CandidateParams &params) {
+    auto ratio = [](float x, float y) { return std::max(x, y) / std::min(x, y); };
+    std::vector<SideCandidate> candidates;
+    for (std::size_t b = 0; b < table.size(); ++b) {
+        if (table.piece(b) == table.piece(a) || ratio(table.length(a), table.length(b)) > params.max_length_ratio
+            || ratio(table.chord(a), table.chord(b)) > params.max_chord_ratio)
+            continue;
+        candidates.push_back({b, matrix(a, b)});
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const SideCandidate &x, const SideCandidate &y) {
+        return x.difference < y.difference || (x.difference == y.difference && x.side < y.side);
+    });
+    candidates.resize(std::min(candidates.size(), params.k));
+    return candidates;
+}
+
+} // namespace
+
+TEST(side_candidates, sameAsFullMatrix) {
+    const SyntheticBoard board = makeColoredBoard(12, 10);
+    const SideDescriptorTable table = SideDescriptorTable::build(board.pieces);
+    ASSERT_EQ(table.size(), 480u);
+
+    const SimdLevel supported = supportedSimdLevel();
+    for (int level = 0; level <= static_cast<int>(supported); ++level) {
+        setSimdLevel(static_cast<SimdLevel>(level));
+        for (SideMetric metric : {SideMetric::L1, SideMetric::L2}) {
+            const SideDifferenceMatrix matrix = compareSides(table, metric);
+            for (std::size_t k : {1, 4, 9}) {
+                CandidateParams params;
+                params.k = k;
+                params.metric = metric;
+                const SideCandidateIndex index = SideCandidateIndex::build(table, params);
+                ASSERT_EQ(index.size(), table.size());
+                ASSERT_EQ(index.k(), k);
+                for (std::size_t a = 0; a < table.size(); ++a) {
+                    const std::vector<SideCandidate> expected = bruteForce(table, matrix, a, params);
+                    const auto candidates = index.candidates(a);
+                    ASSERT_EQ(candidates.size(), expected.size()) << a;
+                    for (std::size_t i = 0; i < expected.size(); ++i) {
+                        EXPECT_EQ(candidates[i].side, expected[i].side) << toString(static_cast<SimdLevel>(level)) << " " << a << " " << i;
+                        EXPECT_NEAR(candidates[i].difference, expected[i].difference, 1e-3f * (1.0f + expected[i].difference));
+                    }
+                }
+            }
+        }
+    }
+    setSimdLevel(supported);
+}
+
+TEST(side_candidates, pruning) {
+    const SyntheticBoard board = makeColoredBoard(12, 10);
+    const SideDescriptorTable table = SideDescriptorTable::build(board.pieces);
+    const SideCandidateIndex index = SideCandidateIndex::build(table);
+    const SideCandidateIndex sequential = SideCandidateIndex::build(table, {}, false);
+
+    // 120 pieces with 4 sides each
+    const std::size_t pairs = 480 * 480 - 120 * 4 * 4;
+    EXPECT_EQ(index.comparedPairs() + index.prunedPairs(), pairs);
+    EXPECT_LT(index.comparedPairs() * 10, pairs);
+    EXPECT_EQ(sequential.comparedPairs(), index.comparedPairs());
+    for (std::size_t a = 0; a < table.size(); ++a) {
+        ASSERT_EQ(index.candidates(a).size(), index.k());
+        EXPECT_TRUE(std::ranges::equal(index.candidates(a), sequential.candidates(a)));
+        for (const SideCandidate &candidate : index.candidates(a))
+            EXPECT_NE(table.piece(candidate.side), table.piece(a));
+    }
+
+    CandidateParams params;
+    params.k = 0;
+    EXPECT_THROW(SideCandidateIndex::build(table, params), assertion_error);
+    EXPECT_EQ(SideCandidateIndex::build(SideDescriptorTable()).size(), 0u);
+}
@@ -0,0 +1,138 @@
+#include "side_descriptor.h"
+
+#include <libbase/runtime_assert.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Area resampling of m piecewise-constant values src[0..m) (value src[i] on [i, i + 1)) to n values:
+// dst[k] is the mean over [k * m / n, (k + 1) * m / n). prefix is a buffer for m + 1 prefix sums.
+void resampleArea(const float *src, int m, float *dst, int n, std::vector<double> &prefix) {
+    prefix.resize(m + 1);
+    prefix[0] = 0.0;
+    for (int i = 0; i < m; ++i)
+        prefix[i + 1] = prefix[i] + src[i];
+
+    // integral of the values over [0, x]
+    auto integral = [&](double x) {
+        const int i = std::min(static_cast<int>(x), m - 1);
+        return prefix[i] + (x - i) * src[i];
+    };
+
+    const double step = static_cast<double>(m) / n;
+    for (int k = 0; k < n; ++k) {
+        const double a = k * step;
+        const double b = (k + 1) * step;
+        dst[k] = static_cast<float>((integral(b) - integral(a)) / step);
+    }
+}
+
+} // namespace
+
+SideDescriptorTable SideDescriptorTable::build(const std::vector<Piece> &pieces, bool with_openmp) {
+    SideDescriptorTable table;
+    table.first_side_.resize(pieces.size() + 1, 0);
+    for (std::size_t k = 0; k < pieces.size(); ++k)
+        table.first_side_[k + 1] = table.first_side_[k] + pieces[k].sides.size();
+
+    const std::size_t n = table.first_side_.back();
+    table.piece_.resize(n);
+    table.side_.resize(n);
+    table.length_.resize(n);
+    table.chord_.resize(n);
+    table.colors_.resize(n * kChannels * kProfileLength);
+    table.shape_.resize(n * kProfileLength);
+    table.curvature_.resize(n * kCurvatureLength);
+    for (std::size_t k = 0; k < pieces.size(); ++k) {
+        const int channels = pieces[k].image.channels();
+        rassert(channels == 1 || channels == kChannels, 4409182302, k, channels);
+        for (std::size_t s = 0; s < pieces[k].sides.size(); ++s) {
+            rassert(pieces[k].sides[s].length >= 2, 4409182301, k, s);
+            table.piece_[table.first_side_[k] + s] = static_cast<int>(k);
+            table.side_[table.first_side_[k] + s] = static_cast<int>(s);
+        }
+    }
+
+    #pragma omp parallel if(with_openmp)
+    {
+        std::vector<point2i> points;
+        std::vector<float> values;
+        std::vector<double> prefix;
+
+        #pragma omp for schedule(dynamic, 4)
+        for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(n); ++i) {
+            const Piece &piece = pieces[table.piece_[i]];
+            points = piece.side(table.side_[i]).toPoints();
+            const int m = static_cast<int>(points.size());
+
+            const point2i a = points.front();
+            const point2i b = points.back();
+            const double chord = std::sqrt(static_cast<double>((b - a).norm2()));
+            double length = 0.0;
+            for (int t = 1; t < m; ++t)
+                length += (points[t].x != points[t - 1].x && points[t].y != points[t - 1].y) ? std::sqrt(2.0) : 1.0;
+            table.length_[i] = static_cast<float>(length);
+            table.chord_[i] = static_cast<float>(chord);
+
+            // colors of the side pixels, channel by channel
+            ImageView<const std::uint8_t> image = piece.image;
+            values.resize(m);
+            for (int c = 0; c < kChannels; ++c) {
+                const int src_c = image.channels() == 1 ? 0 : c;
+                for (int t = 0; t < m; ++t)
+                    values[t] = image(points[t].y, points[t].x, src_c);
+                resampleArea(values.data(), m, table.colors_.data() + (i * kChannels + c) * kProfileLength, kProfileLength, prefix);
+            }
+
+            // signed distances from the chord
+            const double dx = b.x - a.x;
+            const double dy = b.y - a.y;
+            for (int t = 0; t < m; ++t) {
+                const double cross = dx * (points[t].y - a.y) - dy * (points[t].x - a.x);
+                values[t] = chord > 0.0 ? static_cast<float>(cross / chord) : 0.0f;
+            }
+            resampleArea(values.data(), m, table.shape_.data() + i * kProfileLength, kProfileLength, prefix);
+
+            // turning angles between consecutive segments of a polyline through kCurvatureLength + 2 evenly spaced points
+            float *curvature = table.curvature_.data() + i * kCurvatureLength;
+            auto sample = [&](int k) { return points[static_cast<std::size_t>(std::lround(k * (m - 1.0) / (kCurvatureLength + 1)))]; };
+            for (int k = 0; k < kCurvatureLength; ++k) {
+                const point2i p0 = sample(k);
+                const point2i p1 = sample(k + 1);
+                const point2i p2 = sample(k + 2);
+                const double ux = p1.x - p0.x, uy = p1.y - p0.y;
+                const double vx = p2.x - p1.x, vy = p2.y - p1.y;
+                const double cross = ux * vy - uy * vx;
+                const double dot = ux * vx + uy * vy;
+                curvature[k] = (cross == 0.0 && dot == 0.0) ? 0.0f : static_cast<float>(std::atan2(cross, dot));
+            }
+        }
+    }
+
+    return table;
+}
+
+std::size_t SideDescriptorTable::index(int piece, int side) const {
+    rassert(piece >= 0 && static_cast<std::size_t>(piece) < piecesCount(), 4409182303, piece, piecesCount());
+    const std::size_t i = first_side_[piece] + side;
+    rassert(side >= 0 && i < first_side_[piece + 1], 4409182304, piece, side);
+    return i;
+}
+
+SideDescriptor SideDescriptorTable::operator[](std::size_t i) const {
+    rassert(i < size(), 4409182305, i, size());
+    return {piece_[i], side_[i], length_[i], chord_[i], colors(i), shape(i), curvature(i)};
+}
+
+std::vector<color8u> SideDescriptorTable::colorProfile(std::size_t i) const {
+    const float *profile = colors(i);
+    std::vector<color8u> out;
+    out.reserve(kProfileLength);
+    for (int k = 0; k < kProfileLength; ++k) {
+        auto channel = [&](int c) { return static_cast<std::uint8_t>(std::lround(std::clamp(profile[c * kProfileLength + k], 0.0f, 255.0f))); };
+        out.emplace_back(channel(0), channel(1), channel(2));
+    }
+    return out;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <libimages/color.h>
+#include <libpuzzle/piece_processor.h>
+
+#include <cstddef>
+#include <vector>
+
+// One row of SideDescriptorTable (pointers into the table, valid while it is alive)
+struct SideDescriptor {
+    int piece = -1;
+    int side = -1;
+    float length = 0.0f;              // length of the contour from the first corner of the side to the second one
+    float chord = 0.0f;               // distance between the corners
+    const float *colors = nullptr;    // colors[c * kProfileLength + k] - channel c of sample k
+    const float *shape = nullptr;     // shape[k] - signed distance of sample k from the chord (> 0 - to the right, i.e. into the piece)
+    const float *curvature = nullptr; // curvature[k] - turning angle (radians, > 0 - clockwise) at kCurvatureLength points
+};
+
+// Descriptors of all sides of all pieces computed once, stored as a structure of arrays:
+// every profile has a fixed length, so the profiles of all sides lie in one contiguous array each
+// and pairwise comparison of sides doesn't touch images or contours at all.
+// Profiles are sampled from the first corner of a side to the second one (clockwise along the piece contour).
+class SideDescriptorTable final {
+  public:
+    static constexpr int kChannels = 3;
+    static constexpr int kProfileLength = 64;
+    static constexpr int kCurvatureLength = 16;
+
+    SideDescriptorTable() = default;
+
+    // Sides of pieces[k] are rows index(k, 0), ..., index(k, pieces[k].sides.size() - 1)
+    static SideDescriptorTable build(const std::vector<Piece> &pieces, bool with_openmp = true);
+
+    std::size_t size() const noexcept { return piece_.size(); }
+    std::size_t piecesCount() const noexcept { return first_side_.empty() ? 0 : first_side_.size() - 1; }
+    std::size_t index(int piece, int side) const;
+    std::size_t sidesCount(int piece) const { return first_side_[piece + 1] - first_side_[piece]; }
+
+    int piece(std::size_t i) const { return piece_[i]; }
+    int side(std::size_t i) const { return side_[i]; }
+    float length(std::size_t i) const { return length_[i]; }
+    float chord(std::size_t i) const { return chord_[i]; }
+    const float *colors(std::size_t i) const { return colors_.data() + i * kChannels * kProfileLength; }
+    const float *shape(std::size_t i) const { return shape_.data() + i * kProfileLength; }
+    const float *curvature(std::size_t i) const { return curvature_.data() + i * kCurvatureLength; }
+
+    SideDescriptor operator[](std::size_t i) const;
+
+    // Color profile rounded to 8 bits (f.e. for plots)
+    std::vector<color8u> colorProfile(std::size_t i) const;
+
+  private:
+    std::vector<std::size_t> first_side_; // sides of piece k are rows [first_side_[k], first_side_[k + 1])
+    std::vector<int> piece_;
+    std::vector<int> side_;
+    std::vector<float> length_;
+    std::vector<float> chord_;
+    std::vector<float> colors_;
+    std::vector<float> shape_;
+    std::vector<float> curvature_;
+};
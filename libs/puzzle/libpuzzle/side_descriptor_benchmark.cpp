@@ -0,0 +1,65 @@
+#include "side_descriptor.h"
+
+#include <gtest/gtest.h>
+
+#include <libimages/algorithms/downsample.h>
+#include <libimages/benchmark_utils.h>
+
+#include <cmath>
+#include <iostream>
+
+TEST(side_descriptor_benchmark, pairwiseColorDifferences) {
+    // 1000 pieces = 4000 sides
+    const int pieces_count = 1000;
+    const image8u board = makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    const std::vector<Piece> pieces = processPieces(board, findConnectedComponents(mask));
+
+    SideDescriptorTable table;
+    benchmark("4000 sides: SideDescriptorTable::build", [&]() { table = SideDescriptorTable::build(pieces); });
+    benchmark("4000 sides: SideDescriptorTable::build single thread", [&]() { SideDescriptorTable::build(pieces, false); });
+
+    const int n = static_cast<int>(table.size());
+    const int L = SideDescriptorTable::kProfileLength;
+    double checksum = 0.0;
+    const double descriptors_time = benchmark("4000 sides: all pairs from descriptors", [&]() {
+        for (int a = 0; a < n; ++a) {
+            const float *colorsA = table.colors(a);
+            for (int b = 0; b < n; ++b) {
+                const float *colorsB = table.colors(b);
+                float d = 0.0f;
+                for (int k = 0; k < SideDescriptorTable::kChannels * L; ++k)
+                    d += std::abs(colorsA[k] - colorsB[k]);
+                checksum += d;
+            }
+        }
+    }, 1);
+
+    // as the matching loop did before: colors of both sides are extracted and resampled for every pair
+    const int sidesA = 20;
+    auto colorsOf = [&](int piece, int side) {
+        std::vector<color8u> colors;
+        pieces[piece].side(side).forEach([&](point2i p) {
+            colors.emplace_back(pieces[piece].image(p.y, p.x, 0), pieces[piece].image(p.y, p.x, 1), pieces[piece].image(p.y, p.x, 2));
+        });
+        return colors;
+    };
+    const double per_pair_time = benchmark("20 x 4000 sides: all pairs re-extracting colors", [&]() {
+        for (int a = 0; a < sidesA; ++a) {
+            const std::vector<color8u> colorsA = colorsOf(table.piece(a), table.side(a));
+            for (int b = 0; b < n; ++b) {
+                const std::vector<color8u> colorsB = colorsOf(table.piece(b), table.side(b));
+                const int m = static_cast<int>(std::min(colorsA.size(), colorsB.size()));
+                const std::vector<color8u> ca = downsample(colorsA, m);
+                const std::vector<color8u> cb = downsample(colorsB, m);
+                float d = 0.0f;
+                for (int k = 0; k < m; ++k)
+                    for (int c = 0; c < 3; ++c)
+                        d += std::abs(float(ca[k](c)) - float(cb[k](c)));
+                checksum += d;
+            }
+        }
+    }, 1);
+    std::cout << "all pairs: " << descriptors_time << " sec from descriptors vs ~" << per_pair_time * n / sidesA
+              << " sec re-extracting colors (checksum " << std::fmod(checksum, 10.0) << ")" << std::endl;
+}
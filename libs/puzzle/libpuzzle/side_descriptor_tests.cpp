@@ -0,0 +1,101 @@
+#include "side_descriptor.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/configure_working_directory.h>
+#include <libpuzzle/tests_utils.h>
+
+#include <cmath>
+
+namespace {
+
+// 40x30 rectangle piece at (5, 7) of a 60x50 board, its pixels are colored by x (red), y (green) and 200 (blue)
+struct RectangleBoard {
+    image8u image;
+    std::vector<Piece> pieces;
+
+    RectangleBoard() : image(60, 50, 3) {
+        image8u mask(60, 50, 1);
+        for (int j = 7; j < 37; ++j) {
+            for (int i = 5; i < 45; ++i) {
+                mask(j, i) = 255;
+                image(j, i, 0) = static_cast<std::uint8_t>(4 * i);
+                image(j, i, 1) = static_cast<std::uint8_t>(4 * j);
+                image(j, i, 2) = 200;
+            }
+        }
+        pieces = processPieces(image, findConnectedComponents(mask));
+    }
+};
+
+} // namespace
+
+TEST(side_descriptor, rectanglePiece) {
+    const RectangleBoard board;
+    ASSERT_EQ(board.pieces.size(), 1u);
+    const SideDescriptorTable table = SideDescriptorTable::build(board.pieces);
+    ASSERT_EQ(table.size(), 4u);
+    EXPECT_EQ(table.piecesCount(), 1u);
+
+    // clockwise from the top-left corner: top, right, bottom, left
+    const float lengths[4] = {39, 29, 39, 29};
+    for (int s = 0; s < 4; ++s) {
+        const std::size_t i = table.index(0, s);
+        const SideDescriptor d = table[i];
+        EXPECT_EQ(d.piece, 0);
+        EXPECT_EQ(d.side, s);
+        EXPECT_EQ(d.length, lengths[s]);
+        EXPECT_NEAR(d.chord, lengths[s], 1e-4);
+        for (int k = 0; k < SideDescriptorTable::kProfileLength; ++k) {
+            EXPECT_NEAR(d.colors[2 * SideDescriptorTable::kProfileLength + k], 200.0f, 1e-3);
+            EXPECT_NEAR(d.shape[k], 0.0f, 1e-4);
+        }
+        for (int k = 0; k < SideDescriptorTable::kCurvatureLength; ++k) {
+            EXPECT_NEAR(d.curvature[k], 0.0f, 1e-6);
+        }
+    }
+
+    // top side goes right: red grows from 4 * 5 to 4 * 44, green is constant 4 * 7
+    const float *top = table.colors(table.index(0, 0));
+    for (int k = 0; k + 1 < SideDescriptorTable::kProfileLength; ++k) {
+        EXPECT_LT(top[k], top[k + 1]);
+        EXPECT_NEAR(top[SideDescriptorTable::kProfileLength + k], 28.0f, 1e-3);
+    }
+    // area resampling keeps the mean of the side pixels
+    double mean = 0.0;
+    for (int k = 0; k < SideDescriptorTable::kProfileLength; ++k)
+        mean += top[k] / SideDescriptorTable::kProfileLength;
+    EXPECT_NEAR(mean, 4.0 * (5 + 44) / 2, 1e-3);
+
+    // left side goes up: green decreases
+    const float *left = table.colors(table.index(0, 3));
+    EXPECT_GT(left[SideDescriptorTable::kProfileLength], left[2 * SideDescriptorTable::kProfileLength - 1]);
+
+    const std::vector<color8u> profile = table.colorProfile(table.index(0, 0));
+    ASSERT_EQ(profile.size(), static_cast<std::size_t>(SideDescriptorTable::kProfileLength));
+    EXPECT_EQ(profile.front()(2), 200);
+
+    EXPECT_THROW(table.index(0, 4), assertion_error);
+    EXPECT_THROW(table.index(1, 0), assertion_error);
+}
+
+TEST(side_descriptor, samplePieces) {
+    configureWorkingDirectory();
+
+    const SamplePhoto photo = samplePhotoPieces();
+    const std::vector<Piece> &pieces = photo.pieces;
+
+    const SideDescriptorTable table = SideDescriptorTable::build(pieces);
+    const SideDescriptorTable sequential = SideDescriptorTable::build(pieces, false);
+    ASSERT_EQ(table.size(), 24u);
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        EXPECT_GE(table.length(i), table.chord(i) - 1e-3f);
+        // a side of a piece turns by less than half a turn in total
+        float turn = 0.0f;
+        for (int k = 0; k < SideDescriptorTable::kCurvatureLength; ++k)
+            turn += table.curvature(i)[k];
+        EXPECT_LT(std::abs(turn), 3.1416f);
+        for (int k = 0; k < SideDescriptorTable::kChannels * SideDescriptorTable::kProfileLength; ++k)
+            EXPECT_EQ(table.colors(i)[k], sequential.colors(i)[k]);
+    }
+}
@@ -0,0 +1,81 @@
+#include "side_matching.h"
+
+#include "side_matching_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int kLength = SideDescriptorTable::kChannels * SideDescriptorTable::kProfileLength;
+
+// Blocks of the matrix: profiles of 64 rows and 256 columns (48 KB + 192 KB) stay in L2 cache
+constexpr int kBlockRows = 64;
+constexpr int kBlockCols = 256;
+
+float normalize(float sum, SideMetric metric) {
+    const float mean = sum / kLength;
+    return metric == SideMetric::L1 ? mean : std::sqrt(mean);
+}
+
+} // namespace
+
+SideDifferenceMatrix compareSides(const SideDescriptorTable &table, SideMetric metric, bool with_openmp) {
+    const int n = static_cast<int>(table.size());
+    SideDifferenceMatrix matrix(n);
+    if (n == 0)
+        return matrix;
+
+    const std::vector<float> reversed = side_matching_kernels::reversedProfiles(table, with_openmp);
+    const side_matching_kernels::Kernels &kernels = side_matching_kernels::currentKernels();
+    const auto block_kernel = metric == SideMetric::L1 ? kernels.l1_block : kernels.l2_block;
+    const float *profiles = table.colors(0);
+
+    const int row_blocks = (n + kBlockRows - 1) / kBlockRows;
+    const int col_blocks = (n + kBlockCols - 1) / kBlockCols;
+    #pragma omp parallel for collapse(2) schedule(dynamic, 1) if(with_openmp)
+    for (int rb = 0; rb < row_blocks; ++rb) {
+        for (int cb = 0; cb < col_blocks; ++cb) {
+            const int a0 = rb * kBlockRows;
+            const int b0 = cb * kBlockCols;
+            const int a_count = std::min(kBlockRows, n - a0);
+            const int b_count = std::min(kBlockCols, n - b0);
+            block_kernel(profiles + static_cast<std::size_t>(a0) * kLength, a_count,
+                         reversed.data() + static_cast<std::size_t>(b0) * kLength, b_count, kLength,
+                         matrix.row(a0) + b0, matrix.size());
+            for (int a = a0; a < a0 + a_count; ++a) {
+                float *row = matrix.row(a);
+                for (int b = b0; b < b0 + b_count; ++b)
+                    row[b] = normalize(row[b], metric);
+            }
+        }
+    }
+
+    return matrix;
+}
+
+std::vector<float> side_matching_kernels::reversedProfiles(const SideDescriptorTable &table, bool with_openmp) {
+    const int n = static_cast<int>(table.size());
+    const int L = SideDescriptorTable::kProfileLength;
+    std::vector<float> reversed(static_cast<std::size_t>(n) * kLength);
+    #pragma omp parallel for if(with_openmp)
+    for (int i = 0; i < n; ++i) {
+        const float *src = table.colors(i);
+        float *dst = reversed.data() + static_cast<std::size_t>(i) * kLength;
+        for (int c = 0; c < SideDescriptorTable::kChannels; ++c)
+            std::reverse_copy(src + c * L, src + (c + 1) * L, dst + c * L);
+    }
+    return reversed;
+}
+
+float compareSides(const SideDescriptor &a, const SideDescriptor &b, SideMetric metric) {
+    const int L = SideDescriptorTable::kProfileLength;
+    float sum = 0.0f;
+    for (int c = 0; c < SideDescriptorTable::kChannels; ++c) {
+        for (int k = 0; k < L; ++k) {
+            const float d = a.colors[c * L + k] - b.colors[c * L + L - 1 - k];
+            sum += metric == SideMetric::L1 ? std::abs(d) : d * d;
+        }
+    }
+    return normalize(sum, metric);
+}
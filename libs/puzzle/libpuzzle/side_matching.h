@@ -0,0 +1,38 @@
+#pragma once
+
+#include <libpuzzle/side_descriptor.h>
+
+#include <cstddef>
+#include <vector>
+
+enum class SideMetric {
+    L1, // mean absolute difference of color samples
+    L2, // root mean square difference of color samples
+};
+
+// Dense row-major matrix of differences between sides (rows and columns are rows of a SideDescriptorTable)
+class SideDifferenceMatrix final {
+  public:
+    SideDifferenceMatrix() = default;
+    explicit SideDifferenceMatrix(std::size_t n) : n_(n), values_(n * n, 0.0f) {}
+
+    std::size_t size() const noexcept { return n_; }
+
+    float operator()(std::size_t a, std::size_t b) const { return values_[a * n_ + b]; }
+    float &operator()(std::size_t a, std::size_t b) { return values_[a * n_ + b]; }
+    const float *row(std::size_t a) const { return values_.data() + a * n_; }
+    float *row(std::size_t a) { return values_.data() + a * n_; }
+
+  private:
+    std::size_t n_ = 0;
+    std::vector<float> values_;
+};
+
+// Color difference of every side with every side (including itself and the other sides of its piece):
+// matrix(a, b) compares sample k of side a with sample kProfileLength - 1 - k of side b,
+// because sides that fit together run in opposite directions along their clockwise contours (so it is symmetric).
+// Blocks of the matrix are computed in parallel by SIMD kernels (see currentSimdLevel()).
+SideDifferenceMatrix compareSides(const SideDescriptorTable &table, SideMetric metric = SideMetric::L1, bool with_openmp = true);
+
+// The same difference for one pair of sides (reference implementation, f.e. for plots)
+float compareSides(const SideDescriptor &a, const SideDescriptor &b, SideMetric metric = SideMetric::L1);
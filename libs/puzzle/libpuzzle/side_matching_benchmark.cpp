@@ -0,0 +1,28 @@
+#include "side_matching.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/simd_level.h>
+#include <libimages/benchmark_utils.h>
+
+TEST(side_matching_benchmark, compareSides4000) {
+    // 1000 pieces = 4000 sides, 16M pairs
+    const int pieces_count = 1000;
+    const image8u board = makeBenchmarkBoard(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    const image8u mask = makeBenchmarkBoardMask(kBenchmarkWidth, kBenchmarkHeight, pieces_count);
+    const std::vector<Piece> pieces = processPieces(board, findConnectedComponents(mask));
+    const SideDescriptorTable table = SideDescriptorTable::build(pieces);
+
+    const SimdLevel supported = supportedSimdLevel();
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::AVX2}) {
+        if (level > supported)
+            continue;
+        setSimdLevel(level);
+        for (SideMetric metric : {SideMetric::L1, SideMetric::L2}) {
+            const std::string name = std::string("4000 sides: compareSides ") + (metric == SideMetric::L1 ? "L1 " : "L2 ") + toString(level);
+            benchmark(name, [&]() { compareSides(table, metric); });
+            benchmark(name + " single thread", [&]() { compareSides(table, metric, false); });
+        }
+    }
+    setSimdLevel(supported);
+}
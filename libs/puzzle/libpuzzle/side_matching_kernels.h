@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <libbase/simd_level.h>
+
+class SideDescriptorTable;
+
+// Inner loops of compareSides and SideCandidateIndex (internal header of side_matching.cpp and side_candidates.cpp),
+// implemented for scalar code and AVX2 in side_matching_kernels_<level>.cpp (each compiled with its own instruction set flags).
+namespace side_matching_kernels {
+
+    struct Kernels {
+        // dst[i * dst_stride + j] = sum_k |a[i * len + k] - b[j * len + k]|, i in [0, a_count), j in [0, b_count)
+        void (*l1_block)(const float* a, int a_count, const float* b, int b_count, int len, float* dst, std::size_t dst_stride);
+        // The same with squared differences
+        void (*l2_block)(const float* a, int a_count, const float* b, int b_count, int len, float* dst, std::size_t dst_stride);
+        // dst[j] = sum_k |a[k] - b[rows[j] * len + k]|, j in [0, count) (one vector against arbitrary rows of b)
+        void (*l1_rows)(const float* a, const float* b, const std::ptrdiff_t* rows, int count, int len, float* dst);
+        // The same with squared differences
+        void (*l2_rows)(const float* a, const float* b, const std::ptrdiff_t* rows, int count, int len, float* dst);
+    };
+
+    const Kernels& scalarKernels();
+#if defined(LIBPUZZLE_X86_SIMD_KERNELS)
+    const Kernels& avx2Kernels();
+#endif
+
+    // Kernels for currentSimdLevel() (or the best level below it that is compiled in)
+    const Kernels& currentKernels();
+
+    // Color profiles of all sides of the table reversed along the side (channel by channel),
+    // so kernels compare sample k of one side with sample kProfileLength - 1 - k of the other as contiguous vectors
+    std::vector<float> reversedProfiles(const SideDescriptorTable& table, bool with_openmp);
+
+} // namespace side_matching_kernels
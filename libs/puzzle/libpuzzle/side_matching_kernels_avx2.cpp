@@ -0,0 +1,134 @@
+#include "side_matching_kernels.h"
+
+#include <immintrin.h>
+
+#include <cmath>
+
+// compiled with -mavx2 -mfma (see CMakeLists.txt), 8 floats per register
+
+namespace side_matching_kernels {
+
+namespace {
+
+inline float hsum(__m256 v) {
+    const __m128 s4 = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    const __m128 s2 = _mm_add_ps(s4, _mm_movehl_ps(s4, s4));
+    return _mm_cvtss_f32(_mm_add_ss(s2, _mm_movehdup_ps(s2)));
+}
+
+struct AbsDiff {
+    __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 operator()(__m256 acc, __m256 x, __m256 y) const { return _mm256_add_ps(acc, _mm256_andnot_ps(sign, _mm256_sub_ps(x, y))); }
+    float operator()(float x, float y) const { return std::abs(x - y); }
+};
+
+struct SquaredDiff {
+    __m256 operator()(__m256 acc, __m256 x, __m256 y) const {
+        const __m256 d = _mm256_sub_ps(x, y);
+        return _mm256_fmadd_ps(d, d, acc);
+    }
+    float operator()(float x, float y) const { return (x - y) * (x - y); }
+};
+
+// Four rows of a share every load of a row of b
+template <typename Op>
+void block(const float* a, int a_count, const float* b, int b_count, int len, float* dst, std::size_t dst_stride) {
+    const Op op;
+    const int len8 = len - len % 8;
+    int i = 0;
+    for (; i + 4 <= a_count; i += 4) {
+        const float* a0 = a + static_cast<std::size_t>(i) * len;
+        const float* a1 = a0 + len;
+        const float* a2 = a1 + len;
+        const float* a3 = a2 + len;
+        for (int j = 0; j < b_count; ++j) {
+            const float* bj = b + static_cast<std::size_t>(j) * len;
+            __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+            __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+            for (int k = 0; k < len8; k += 8) {
+                const __m256 vb = _mm256_loadu_ps(bj + k);
+                acc0 = op(acc0, _mm256_loadu_ps(a0 + k), vb);
+                acc1 = op(acc1, _mm256_loadu_ps(a1 + k), vb);
+                acc2 = op(acc2, _mm256_loadu_ps(a2 + k), vb);
+                acc3 = op(acc3, _mm256_loadu_ps(a3 + k), vb);
+            }
+            float s0 = hsum(acc0), s1 = hsum(acc1), s2 = hsum(acc2), s3 = hsum(acc3);
+            for (int k = len8; k < len; ++k) {
+                s0 += op(a0[k], bj[k]);
+                s1 += op(a1[k], bj[k]);
+                s2 += op(a2[k], bj[k]);
+                s3 += op(a3[k], bj[k]);
+            }
+            dst[(i + 0) * dst_stride + j] = s0;
+            dst[(i + 1) * dst_stride + j] = s1;
+            dst[(i + 2) * dst_stride + j] = s2;
+            dst[(i + 3) * dst_stride + j] = s3;
+        }
+    }
+    for (; i < a_count; ++i) {
+        const float* ai = a + static_cast<std::size_t>(i) * len;
+        for (int j = 0; j < b_count; ++j) {
+            const float* bj = b + static_cast<std::size_t>(j) * len;
+            __m256 acc = _mm256_setzero_ps();
+            for (int k = 0; k < len8; k += 8)
+                acc = op(acc, _mm256_loadu_ps(ai + k), _mm256_loadu_ps(bj + k));
+            float s = hsum(acc);
+            for (int k = len8; k < len; ++k)
+                s += op(ai[k], bj[k]);
+            dst[i * dst_stride + j] = s;
+        }
+    }
+}
+
+// Every load of a is shared by four rows of b
+template <typename Op>
+void gather(const float* a, const float* b, const std::ptrdiff_t* rows, int count, int len, float* dst) {
+    const Op op;
+    const int len8 = len - len % 8;
+    int j = 0;
+    for (; j + 4 <= count; j += 4) {
+        const float* b0 = b + rows[j + 0] * len;
+        const float* b1 = b + rows[j + 1] * len;
+        const float* b2 = b + rows[j + 2] * len;
+        const float* b3 = b + rows[j + 3] * len;
+        __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+        for (int k = 0; k < len8; k += 8) {
+            const __m256 va = _mm256_loadu_ps(a + k);
+            acc0 = op(acc0, va, _mm256_loadu_ps(b0 + k));
+            acc1 = op(acc1, va, _mm256_loadu_ps(b1 + k));
+            acc2 = op(acc2, va, _mm256_loadu_ps(b2 + k));
+            acc3 = op(acc3, va, _mm256_loadu_ps(b3 + k));
+        }
+        float s0 = hsum(acc0), s1 = hsum(acc1), s2 = hsum(acc2), s3 = hsum(acc3);
+        for (int k = len8; k < len; ++k) {
+            s0 += op(a[k], b0[k]);
+            s1 += op(a[k], b1[k]);
+            s2 += op(a[k], b2[k]);
+            s3 += op(a[k], b3[k]);
+        }
+        dst[j + 0] = s0;
+        dst[j + 1] = s1;
+        dst[j + 2] = s2;
+        dst[j + 3] = s3;
+    }
+    for (; j < count; ++j) {
+        const float* bj = b + rows[j] * len;
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < len8; k += 8)
+            acc = op(acc, _mm256_loadu_ps(a + k), _mm256_loadu_ps(bj + k));
+        float s = hsum(acc);
+        for (int k = len8; k < len; ++k)
+            s += op(a[k], bj[k]);
+        dst[j] = s;
+    }
+}
+
+} // namespace
+
+const Kernels& avx2Kernels() {
+    static const Kernels kernels{block<AbsDiff>, block<SquaredDiff>, gather<AbsDiff>, gather<SquaredDiff>};
+    return kernels;
+}
+
+} // namespace side_matching_kernels
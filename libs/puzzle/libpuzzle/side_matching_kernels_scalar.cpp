@@ -0,0 +1,70 @@
+#include "side_matching_kernels.h"
+
+#include <cmath>
+
+namespace side_matching_kernels {
+
+namespace {
+
+void l1_block(const float* a, int a_count, const float* b, int b_count, int len, float* dst, std::size_t dst_stride) {
+    for (int i = 0; i < a_count; ++i) {
+        const float* ai = a + static_cast<std::size_t>(i) * len;
+        for (int j = 0; j < b_count; ++j) {
+            const float* bj = b + static_cast<std::size_t>(j) * len;
+            float acc = 0.0f;
+            for (int k = 0; k < len; ++k)
+                acc += std::abs(ai[k] - bj[k]);
+            dst[i * dst_stride + j] = acc;
+        }
+    }
+}
+
+void l2_block(const float* a, int a_count, const float* b, int b_count, int len, float* dst, std::size_t dst_stride) {
+    for (int i = 0; i < a_count; ++i) {
+        const float* ai = a + static_cast<std::size_t>(i) * len;
+        for (int j = 0; j < b_count; ++j) {
+            const float* bj = b + static_cast<std::size_t>(j) * len;
+            float acc = 0.0f;
+            for (int k = 0; k < len; ++k)
+                acc += (ai[k] - bj[k]) * (ai[k] - bj[k]);
+            dst[i * dst_stride + j] = acc;
+        }
+    }
+}
+
+void l1_rows(const float* a, const float* b, const std::ptrdiff_t* rows, int count, int len, float* dst) {
+    for (int j = 0; j < count; ++j) {
+        const float* bj = b + rows[j] * len;
+        float acc = 0.0f;
+        for (int k = 0; k < len; ++k)
+            acc += std::abs(a[k] - bj[k]);
+        dst[j] = acc;
+    }
+}
+
+void l2_rows(const float* a, const float* b, const std::ptrdiff_t* rows, int count, int len, float* dst) {
+    for (int j = 0; j < count; ++j) {
+        const float* bj = b + rows[j] * len;
+        float acc = 0.0f;
+        for (int k = 0; k < len; ++k)
+            acc += (a[k] - bj[k]) * (a[k] - bj[k]);
+        dst[j] = acc;
+    }
+}
+
+} // namespace
+
+const Kernels& scalarKernels() {
+    static const Kernels kernels{l1_block, l2_block, l1_rows, l2_rows};
+    return kernels;
+}
+
+const Kernels& currentKernels() {
+#if defined(LIBPUZZLE_X86_SIMD_KERNELS)
+    if (currentSimdLevel() == SimdLevel::AVX2)
+        return avx2Kernels();
+#endif
+    return scalarKernels();
+}
+
+} // namespace side_matching_kernels
@@ -0,0 +1,57 @@
+#include "side_matching.h"
+
+#include <gtest/gtest.h>
+
+#include <libbase/simd_level.h>
+#include <libpuzzle/tests_utils.h>
+
+TEST(side_matching, allSimdLevelsMatchReference) {
+    const SyntheticBoard board = makeNoisyBoard(25, 12);
+    const SideDescriptorTable table = SideDescriptorTable::build(board.pieces);
+    ASSERT_EQ(table.size(), 1200u);
+
+    const SimdLevel supported = supportedSimdLevel();
+    for (int level = 0; level <= static_cast<int>(supported); ++level) {
+        setSimdLevel(static_cast<SimdLevel>(level));
+        for (SideMetric metric : {SideMetric::L1, SideMetric::L2}) {
+            const SideDifferenceMatrix matrix = compareSides(table, metric);
+            ASSERT_EQ(matrix.size(), table.size());
+            for (std::size_t a = 0; a < table.size(); a += 7) {
+                for (std::size_t b = 0; b < table.size(); ++b) {
+                    const float expected = compareSides(table[a], table[b], metric);
+                    ASSERT_NEAR(matrix(a, b), expected, 1e-3f * (1.0f + expected))
+                        << toString(static_cast<SimdLevel>(level)) << " " << a << " " << b;
+                    ASSERT_NEAR(matrix(a, b), matrix(b, a), 1e-3f * (1.0f + expected));
+                }
+            }
+        }
+    }
+    setSimdLevel(supported);
+
+    EXPECT_EQ(compareSides(SideDescriptorTable()).size(), 0u);
+}
+
+TEST(side_matching, reversedOrientationAndMetrics) {
+    const SyntheticBoard board = makeNoisyBoard(2, 1);
+    const SideDescriptorTable table = SideDescriptorTable::build(board.pieces);
+    ASSERT_EQ(table.size(), 8u);
+
+    SideDescriptor a = table[0];
+    SideDescriptor b = table[5];
+    const int L = SideDescriptorTable::kProfileLength;
+
+    // b with the profile of a reversed fits a perfectly
+    std::vector<float> reversed(SideDescriptorTable::kChannels * L);
+    for (int c = 0; c < SideDescriptorTable::kChannels; ++c)
+        for (int k = 0; k < L; ++k)
+            reversed[c * L + k] = a.colors[c * L + L - 1 - k];
+    b.colors = reversed.data();
+    EXPECT_EQ(compareSides(a, b, SideMetric::L1), 0.0f);
+    EXPECT_EQ(compareSides(a, b, SideMetric::L2), 0.0f);
+
+    // root mean square is never less than mean absolute difference
+    const float l1 = compareSides(table[0], table[5], SideMetric::L1);
+    const float l2 = compareSides(table[0], table[5], SideMetric::L2);
+    EXPECT_GT(l1, 0.0f);
+    EXPECT_GE(l2, l1);
+}
@@ -0,0 +1,68 @@
+#include "tests_utils.h"
+
+#include <libbase/fast_random.h>
+#include <libimages/algorithms/connected_components.h>
+#include <libimages/algorithms/foreground_segmentation.h>
+#include <libimages/algorithms/morphology.h>
+#include <libimages/image_io.h>
+
+#include <cmath>
+
+SyntheticBoard::SyntheticBoard(int cols, int rows, int cell_width, int cell_height, const BoardPixel &pixel)
+    : image(cols * cell_width, rows * cell_height, 3) {
+    image8u mask(image.width(), image.height(), 1);
+    for (int j = 0; j < image.height(); ++j) {
+        for (int i = 0; i < image.width(); ++i) {
+            const bool gap = i % cell_width < 2 || j % cell_height < 2;
+            std::uint8_t rgb[3] = {0, 0, 0};
+            pixel(i, j, gap ? -1 : (j / cell_height) * cols + i / cell_width, rgb);
+            for (int c = 0; c < 3; ++c)
+                image(j, i, c) = rgb[c];
+            if (!gap)
+                mask(j, i) = 255;
+        }
+    }
+    pieces = processPieces(image, findConnectedComponents(mask));
+}
+
+SyntheticBoard makeNoisyBoard(int cols, int rows) {
+    FastRandom r(239);
+    return SyntheticBoard(cols, rows, 20, 16, [&](int, int, int piece, std::uint8_t rgb[3]) {
+        if (piece == -1)
+            return;
+        for (int c = 0; c < 3; ++c)
+            rgb[c] = static_cast<std::uint8_t>(r.nextInt(0, 255));
+    });
+}
+
+SyntheticBoard makeColoredBoard(int cols, int rows) {
+    FastRandom r(239);
+    std::vector<int> base(cols * rows * 3);
+    for (int &value : base)
+        value = r.nextInt(40, 215);
+    return SyntheticBoard(cols, rows, 20, 16, [&](int, int, int piece, std::uint8_t rgb[3]) {
+        if (piece == -1)
+            return;
+        for (int c = 0; c < 3; ++c)
+            rgb[c] = static_cast<std::uint8_t>(base[piece * 3 + c] + r.nextInt(-40, 40));
+    });
+}
+
+SyntheticBoard makePictureBoard(int cols, int rows) {
+    FastRandom r(239);
+    return SyntheticBoard(cols, rows, 24, 20, [&](int i, int j, int, std::uint8_t rgb[3]) {
+        const double x = 0.05 * i;
+        const double y = 0.05 * j;
+        const double colors[3] = {128 + 100 * std::sin(x + 0.3 * y), 128 + 100 * std::sin(0.7 * y - 0.4 * x + 1.0), 128 + 100 * std::cos(0.5 * x * y / 8.0)};
+        for (int c = 0; c < 3; ++c)
+            rgb[c] = static_cast<std::uint8_t>(colors[c] + r.nextInt(-3, 3));
+    });
+}
+
+SamplePhoto::SamplePhoto(const PieceParams &params, bool with_openmp) : image(load_image("data/00_photo_six_parts_downscaled_x4.jpg")) {
+    const ForegroundSegmentation segmentation = segmentForeground(image);
+    components = findConnectedComponents(morphology::open(morphology::close(segmentation.mask, 3), 3));
+    pieces = processPieces(image, components, params, with_openmp);
+}
+
+SamplePhoto samplePhotoPieces(const PieceParams &params, bool with_openmp) { return SamplePhoto(params, with_openmp); }
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <libimages/algorithms/connected_components.h>
+#include <libimages/image.h>
+#include <libpuzzle/piece_processor.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Colors rgb of pixel (i, j) of a synthetic board, piece is the index of its cell or -1 for the gap between cells
+using BoardPixel = std::function<void(int i, int j, int piece, std::uint8_t rgb[3])>;
+
+// cols x rows grid of rectangular pieces of cell_width x cell_height pixels, the first 2 rows and columns of every cell
+// are the gap. pixel is called for every pixel in row-major order (rgb is black before the call).
+// Pieces are views into image, so the board is neither copied nor moved.
+struct SyntheticBoard {
+    image8u image;
+    std::vector<Piece> pieces;
+
+    SyntheticBoard(int cols, int rows, int cell_width, int cell_height, const BoardPixel &pixel);
+    SyntheticBoard(const SyntheticBoard &) = delete;
+    SyntheticBoard &operator=(const SyntheticBoard &) = delete;
+};
+
+// 20x16 cells of uniform noise, so sides do not match each other
+SyntheticBoard makeNoisyBoard(int cols, int rows);
+// 20x16 cells, every piece is noise around its own random color
+SyntheticBoard makeColoredBoard(int cols, int rows);
+// 24x20 cells of a smooth picture with weak noise, so adjacent sides have similar colors
+SyntheticBoard makePictureBoard(int cols, int rows);
+
+// data/00_photo_six_parts_downscaled_x4.jpg (6 pieces) cut into pieces like main does: foreground mask, close and open by 3,
+// connected components, processPieces with params. Pieces are views into image, so the photo is neither copied nor moved.
+struct SamplePhoto {
+    image8u image;
+    ConnectedComponents components;
+    std::vector<Piece> pieces;
+
+    explicit SamplePhoto(const PieceParams &params = {}, bool with_openmp = true);
+    SamplePhoto(const SamplePhoto &) = delete;
+    SamplePhoto &operator=(const SamplePhoto &) = delete;
+};
+
+// Expects the working directory to be configured (configureWorkingDirectory)
+SamplePhoto samplePhotoPieces(const PieceParams &params = {}, bool with_openmp = true);
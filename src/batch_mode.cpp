@@ -0,0 +1,56 @@
+#include "batch_mode.h"
+
+#include <libpuzzle/batch_solver.h>
+
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "usage: CVPuzzleSolver --batch <directory or list.txt> [--output <dir>] [--workers N] [--threads-per-worker N]" << std::endl;
+}
+
+} // namespace
+
+int runBatchMode(const std::vector<std::string> &args) {
+    std::string input;
+    BatchParams batch;
+    batch.output_dir = "batch_results";
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const bool has_value = i + 1 < args.size();
+        if (args[i] == "--batch" && has_value) {
+            input = args[++i];
+        } else if (args[i] == "--output" && has_value) {
+            batch.output_dir = args[++i];
+        } else if (args[i] == "--workers" && has_value) {
+            batch.workers = std::stoi(args[++i]);
+        } else if (args[i] == "--threads-per-worker" && has_value) {
+            batch.threads_per_worker = std::stoi(args[++i]);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (input.empty() || batch.workers < 0 || batch.threads_per_worker < 0) {
+        printUsage();
+        return 1;
+    }
+
+    const std::vector<std::string> paths = listBatchInputs(input);
+    std::cout << paths.size() << " photos to solve" << std::endl;
+    const BatchReport report = solveBatch(paths, {}, batch);
+    for (const BatchItem &item : report.items) {
+        if (item.ok) {
+            std::cout << item.name << ": " << item.result.pieces_count << " pieces assembled into " << item.result.assembly.components
+                      << " components in " << item.latency << " sec" << std::endl;
+        } else {
+            std::cerr << item.name << ": FAILED - " << item.error << std::endl;
+        }
+    }
+    std::cout << report.items.size() << " photos (" << report.failed() << " failed) solved in " << report.seconds << " sec by "
+              << report.workers << " workers x " << report.threads_per_worker << " threads: " << report.imagesPerSecond() << " images/sec, latency p50="
+              << report.latencyPercentile(50.0) << " sec p99=" << report.latencyPercentile(99.0) << " sec" << std::endl;
+    std::cout << "results are saved to " << batch.output_dir << std::endl;
+    return report.failed() == 0 ? 0 : 3;
+}
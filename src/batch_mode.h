@@ -0,0 +1,9 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// CVPuzzleSolver --batch <directory or list.txt> [--output <dir>] [--workers N] [--threads-per-worker N]
+// Solves all photos without debug output, writes <output>/<name>.json of every photo and <output>/report.json,
+// prints throughput (images/sec) and latency percentiles. Returns the exit code.
+int runBatchMode(const std::vector<std::string> &args);
@@ -2,11 +2,8 @@
 #include <libimages/draw.h>
 #include <libimages/algorithms/blur.h>
 #include <libimages/algorithms/downsample.h>
-#include <libimages/algorithms/grayscale.h>
-#include <libimages/algorithms/threshold_masking.h>
+#include <libimages/algorithms/foreground_segmentation.h>
 #include <libimages/algorithms/morphology.h>
-#include <libimages/algorithms/split_into_parts.h>
-#include <libimages/algorithms/extract_contour.h>
 #include <libimages/algorithms/simplify_contours.h>
 
 #include <libbase/stats.h>
@@ -15,16 +12,29 @@
 #include <libbase/runtime_assert.h>
 #include <libbase/configure_working_directory.h>
 #include <libimages/debug_io.h>
+#include <libimages/bit_mask.h>
 #include <libimages/image.h>
+#include <libimages/image_allocator.h>
 #include <libimages/image_io.h>
+#include <libpuzzle/assembly.h>
+#include <libpuzzle/piece_processor.h>
+#include <libpuzzle/side_candidates.h>
+#include <libpuzzle/side_descriptor.h>
 
+#include <iomanip>
 #include <iostream>
 #include <unordered_map>
 
+#include "batch_mode.h"
 #include "sides_comparison_utils.h"
 
-int main() {
+int main(int argc, char **argv) {
     try {
+        // пакетный режим: много фотографий параллельно, без отладочных картинок, результаты - в json файлах
+        if (argc > 1) {
+            return runBatchMode(std::vector<std::string>(argv + 1, argv + argc));
+        }
+
         configureWorkingDirectory();
 
         // это список картинок которые вы хотите обработать при запуске
@@ -49,6 +59,7 @@ int main() {
         for (const std::string &image_name: to_process) {
             Timer total_t;
             Timer t;
+            resetImageAllocationStats();
 
             std::string debug_dir = "debug/" + image_name + "/";
             // удаляем папку чтобы не анализировать случайно старые визуализации
@@ -60,33 +71,29 @@ int main() {
             std::cout << "image loaded in " << t.elapsed() << " sec" << std::endl;
             debug_io::dump_image(debug_dir + "00_input.jpg", image);
 
-            image32f grayscale = to_grayscale_float(image);
-            rassert(grayscale.channels() == 1, 2317812937193);
-            rassert(grayscale.width() == w && grayscale.height() == h, 7892137419283791);
-            debug_io::dump_image(debug_dir + "01_grayscale.jpg", grayscale);
-
-            std::vector<float> intensities_on_border;
-            for (int j = 0; j < h; ++j) {
-                for (int i = 0; i < w; ++i) {
-                    // пропускаем все пиксели кроме границы изображения
-                    if (i != 0 && i != w - 1 && j != 0 && j != h - 1)
-                        continue;
-                    intensities_on_border.push_back(grayscale(j, i));
-                }
-            }
-            // DONE: какой инвариант мы можем проверить про размер intensities_on_border.size()? чем он должен быть равен?
-            rassert(intensities_on_border.size() == 2 * w + 2 * h - 4, 7283197129381312);
-            std::cout << "intensities on border: " << stats::summaryStats(intensities_on_border) << std::endl;
-
-            // DONE: найдем порог разделяющий яркость на фон и объект - background_threshold
-            double background_threshold = 1.5 * stats::percentile(intensities_on_border, 90);
+            // яркость, гистограмма яркости на границе, порог и маска считаются за один проход по картинке (без float grayscale)
+            // DONE: найдем порог разделяющий яркость на фон и объект - background_threshold (1.5 * 90-й перцентиль яркости на границе)
+            // DONE: построим маску объект-фон + сохраним визуализацию на диск + выведем в лог процент пикселей на фоне
+            // маски храним по биту на пиксель - морфология работает сразу с 64 пикселями за операцию
+            ForegroundParams foreground_params;
+            foreground_params.border_percentile = 90.0;
+            foreground_params.threshold_scale = 1.5;
+            foreground_params.keep_luma = true; // только ради отладочной картинки 01_grayscale.jpg
+            ForegroundSegmentation segmentation = segmentForeground(image, foreground_params);
+            rassert(segmentation.luma.width() == w && segmentation.luma.height() == h, 7892137419283791);
+            debug_io::dump_image(debug_dir + "01_grayscale.jpg", segmentation.luma);
+
+            // DONE: какой инвариант мы можем проверить про размер границы? чем он должен быть равен?
+            rassert(segmentation.border_histogram.count() == static_cast<std::uint64_t>(2 * w + 2 * h - 4), 7283197129381312);
+            std::cout << "intensities on border: " << stats::summaryStats(segmentation.border_histogram) << std::endl;
+
+            double background_threshold = segmentation.threshold;
             std::cout << "background threshold=" << background_threshold << std::endl;
 
-            // DONE: построим маску объект-фон + сохраним визуализацию на диск + выведем в лог процент пикселей на фоне
-            image8u is_foreground_mask = threshold_masking(grayscale, background_threshold);
-            double is_foreground_sum = stats::sum(is_foreground_mask.toVector());
-            std::cout << "thresholded background: " << stats::toPercent(w * h - is_foreground_sum / 255.0, 1.0 * w * h) << std::endl;
-            debug_io::dump_image(debug_dir + "02_is_foreground_mask.png", is_foreground_mask);
+            const BitMask &is_foreground_bits = segmentation.mask;
+            double is_foreground_sum = is_foreground_bits.count();
+            std::cout << "thresholded background: " << stats::toPercent(w * h - is_foreground_sum, 1.0 * w * h) << std::endl;
+            debug_io::dump_image(debug_dir + "02_is_foreground_mask.png", is_foreground_bits.toImage());
 
             t.restart();
             // DONE: сделаем маску более гладкой и точной через Морфологию
@@ -94,22 +101,29 @@ int main() {
             int strength = 3;
 
             const bool with_openmp = true;
-            image8u dilated_mask = morphology::dilate(is_foreground_mask, strength, with_openmp);
-            image8u dilated_eroded_mask = morphology::erode(dilated_mask, strength, with_openmp);
-            image8u dilated_eroded_eroded_mask = morphology::erode(dilated_eroded_mask, strength, with_openmp);
-            image8u dilated_eroded_eroded_dilated_mask = morphology::dilate(dilated_eroded_eroded_mask, strength, with_openmp);
+            // close = dilate + erode (заделывает дырки), open = erode + dilate (убирает выбросы)
+            BitMask closed_mask = morphology::close(is_foreground_bits, strength, with_openmp);
+            BitMask closed_opened_mask = morphology::open(closed_mask, strength, with_openmp);
             std::cout << "full morphology in " << t.elapsed() << " sec" << std::endl;
 
             // TODO 1 посмотрите на RGB графики тех сторон у которых нет и не может быть соседей, то есть у белых полос
             // разумно ли они выглядят? с чем это может быть связано? как это исправить?
-            debug_io::dump_image(debug_dir + "03_is_foreground_dilated.png", dilated_mask);
-            debug_io::dump_image(debug_dir + "04_is_foreground_dilated_eroded.png", dilated_eroded_mask);
-            debug_io::dump_image(debug_dir + "05_is_foreground_dilated_eroded_eroded.png", dilated_eroded_eroded_mask);
-            debug_io::dump_image(debug_dir + "06_is_foreground_dilated_eroded_eroded_dilated.png", dilated_eroded_eroded_dilated_mask);
-
-            is_foreground_mask = dilated_eroded_eroded_dilated_mask;
-            auto [objOffsets, objImages, objMasks] = splitObjects(image, is_foreground_mask);
-            int objects_count = objImages.size();
+            debug_io::dump_image(debug_dir + "04_is_foreground_dilated_eroded.png", closed_mask.toImage());
+            debug_io::dump_image(debug_dir + "06_is_foreground_dilated_eroded_eroded_dilated.png", closed_opened_mask.toImage());
+
+            // компоненты связности ищутся по отрезкам строк прямо в битовой маске
+            ConnectedComponents components = findConnectedComponents(closed_opened_mask);
+            // каждый кусочек (маска, контур -> углы -> стороны + отладочные картинки) обрабатывается независимо - поэтому параллельно,
+            // а порядок кусочков тот же что и у компонент связности, сколько бы ни было потоков
+            t.restart();
+            PieceParams piece_params;
+            piece_params.corners = 4;
+            // углы: сначала Douglas-Peucker оставляет несколько сотен кандидатов, углы ищутся только среди них
+            piece_params.corner_method = SimplifyMethod::Prefiltered;
+            piece_params.debug_dir = debug_dir;
+            std::vector<Piece> pieces = processPieces(image, components, piece_params);
+            std::cout << "pieces processed in " << t.elapsed() << " sec" << std::endl;
+            int objects_count = pieces.size();
             std::cout << objects_count << " objects extracted" << std::endl;
             rassert(objects_count == 6 || objects_count == 8, 237189371298, objects_count);
 
@@ -117,10 +131,10 @@ int main() {
             image32i image_with_object_indices(image.width(), image.height(), 1);
             for (int obj = 0; obj < objects_count; ++obj) {
                 // это отступ - координата верхнего левого угла объекта на оригинальной картинке
-                point2i offset = objOffsets[obj];
+                point2i offset = pieces[obj].offset;
 
                 // это маска объекта
-                image8u mask = objMasks[obj];
+                const image8u &mask = pieces[obj].mask;
 
                 for (int j = 0; j < mask.height(); ++j) {
                     for (int i = 0; i < mask.width(); ++i) {
@@ -136,61 +150,6 @@ int main() {
             }
             debug_io::dump_image(debug_dir + "07_colorized_objects.jpg", debug_io::colorize_labels(image_with_object_indices, 0));
 
-            std::vector<std::vector<std::vector<point2i>>> objSides(objects_count);
-            for (int obj = 0; obj < objects_count; ++obj) {
-                std::string obj_debug_dir = debug_dir + "objects/object" + std::to_string(obj) + "/";
-
-                debug_io::dump_image(obj_debug_dir + "01_image.jpg", objImages[obj]);
-                debug_io::dump_image(obj_debug_dir + "02_mask.jpg", objMasks[obj]);
-
-                // DONE реализуйте построение маски контура-периметра, нажмите Ctrl+Click на buildContourMask:
-                image8u objContourMask = buildContourMask(objMasks[obj]);
-
-                debug_io::dump_image(obj_debug_dir + "03_mask_contour.jpg", objContourMask);
-
-                std::vector<point2i> contour = extractContour(objContourMask);
-
-                // сделаем черную картинку чтобы визуализировать контур на ней
-                image32f contour_visualization(objImages[obj].width(), objImages[obj].height(), 1);
-
-                // нарисуем на ней контур
-                for (int i = 0; i < contour.size(); ++i) {
-                    point2i pixel = contour[i];
-                    // сделаем цвет тем ярче - чем дальше пиксель в контуре (чтобы проверить что он по часовой стрелке)
-                    drawPoint(contour_visualization, pixel, color32f(i * 255.0f / contour.size()));
-                }
-
-                debug_io::dump_image(obj_debug_dir + "04_mask_contour_clockwise.jpg", contour_visualization);
-
-                // у нас теперь есть перечень пикселей на контуре объекта
-                // DONE реализуйте определение в этом контуре 4 вершин-углов и нарисуйте их на картинке, нажмите Ctrl+Click на simplifyContour:
-                std::vector<point2i> corners = simplifyContour(contour, 4);
-                rassert(corners.size() == 4, 32174819274812);
-
-                // сделаем черную картинку чтобы визуализировать вершины-углы на ней
-                image32f corners_visualization(objImages[obj].width(), objImages[obj].height(), 1);
-                for (point2i corner: corners) {
-                    drawPoint(corners_visualization, corner, color32f(255.0f), 10);
-                }
-                debug_io::dump_image(obj_debug_dir + "05_corners_visualization.jpg", corners_visualization);
-
-                // теперь извлечем стороны объекта
-                std::vector<std::vector<point2i>> sides = splitContourByCorners(contour, corners);
-                rassert(sides.size() == 4, 237897832141);
-
-                // визуализируем каждую сторону объекта отдельным цветом:
-                image8u sides_visualization(objImages[obj].width(), objImages[obj].height(), 3);
-                FastRandom r(2391);
-                for (int i = 0; i < sides.size(); ++i) {
-                    color8u random_color = {(uint8_t) r.nextInt(0, 255), (uint8_t) r.nextInt(0, 255), (uint8_t) r.nextInt(0, 255)};
-                    color8u side_color = random_color;
-                    drawPoints(sides_visualization, sides[i], side_color);
-                }
-                debug_io::dump_image(obj_debug_dir + "06_sides.jpg", sides_visualization);
-
-                objSides[obj] = sides;
-            }
-
             struct MatchedSide {
                 int objB = -1;
                 int sideB = -1;
@@ -206,137 +165,134 @@ int main() {
             // если сопоставления не нашлось: -1 -1 -1
             std::vector<std::vector<MatchedSide>> objMatchedSides(objects_count);
 
+            // дескрипторы сторон (цвета вдоль стороны фиксированной длины, форма, длина) считаются один раз на сторону,
+            // дальше попарное сравнение работает только с ними - без картинок и контуров
+            t.restart();
+            SideDescriptorTable sides_table = SideDescriptorTable::build(pieces);
+            std::cout << sides_table.size() << " side descriptors built in " << t.elapsed() << " sec" << std::endl;
+
+            // DONE 3 для каждой стороны - несколько лучших кандидатов среди сторон других объектов
+            // (средняя по отсчетам и каналам абсолютная разница цветов, сторона B обходится в обратном порядке),
+            // пары сильно отличающиеся длиной, расстоянием между углами или средним цветом отбрасываются без сравнения
+            t.restart();
+            CandidateParams candidate_params;
+            candidate_params.k = 4;
+            SideCandidateIndex side_candidates = SideCandidateIndex::build(sides_table, candidate_params);
+            std::cout << "sides compared in " << t.elapsed() << " sec (" << side_candidates.comparedPairs() << " pairs compared, "
+                      << side_candidates.prunedPairs() << " pairs pruned)" << std::endl;
+
             // теперь будем сопоставлять каждую сторону объекта с каждой другой стороной другого объекта
             std::cout << "matching sides with each other" << std::endl;
             // перебираем объект А и его сторону для которой мы будем искать сопоставление
             for (int objA = 0; objA < objects_count; ++objA) {
                 std::string obj_debug_dir = debug_dir + "objects/object" + std::to_string(objA) + "/";
-                objMatchedSides[objA].resize(objSides[objA].size());
+                objMatchedSides[objA].resize(pieces[objA].sides.size());
                 rassert(objMatchedSides[objA][0].differenceBest == -1, 23423431);
-                for (int sideA = 0; sideA < objSides[objA].size(); ++sideA) {
-                    // мы знаем из каких пикселей брать цвета для этих точек
-                    const std::vector<point2i> pixelsA = objSides[objA][sideA];
-                    // извлекаем цвета пикселей из картинки объекта A
-                    const std::vector<color8u> colorsA = extractColors(objImages[objA], pixelsA);
-                    const int channels = objImages[objA].channels();
-
-                    // перебираем другой объект B и его сторону с которой мы хотим попробовать себя сравнить
-                    for (int objB = 0; objB < objects_count; ++objB) {
-                        if (objA == objB)
-                            continue;
-                        for (int sideB = 0; sideB < objSides[objB].size(); ++sideB) {
-                            // мы знаем из каких пикселей брать цвета для точек второй стороны B
-                            std::vector<point2i> pixelsB = objSides[objB][sideB];
-                            // разворачиваем пиксели стороны в обратном порядке, ведь мы хотим как zip-молнию
-                            // сравнить их пиксель за пикселем, каждый из этих списков пикселей стороны - по часовой стрелке
-                            // значит они как борящиеся друг против друга шестеренки трутся и расходятся в противоположных направлениях
-                            // поэтому нужно их сориентировать инвертировав порядок одного из них
-                            // std::reverse(pixelsB.begin(), pixelsB.end()); // да, эту строку нужно раскомментировать
-                            // извлекаем цвета пикселей из картинки объекта A
-                            const std::vector<color8u> colorsB = extractColors(objImages[objB], pixelsB);
-                            rassert(channels == objImages[objB].channels(), 34712839741231);
-
-                            // чтобы удобно было сравнивать - нужно чтобы эти две стороны были выравнены по длине
-                            int n = std::min(colorsA.size(), colorsB.size());
-                            // TODO 2 посмотрите на графики и подумайте, может имеет смысл как-то воздействовать на снятые с границы цвета?
-                            // например сгладить? если решите попробовать - воспользуйтесь готовой функцией blur(std::vector<color8u> colors, float strength)
-                            std::vector<color8u> a = downsample(colorsA, n);
-                            std::vector<color8u> b = downsample(colorsB, n);
-                            rassert(a.size() == n && b.size() == n, 2378192321);
-
-                            // теперь давайте в каждой паре пикселей оценим насколько сильно они отличаются
+                for (int sideA = 0; sideA < pieces[objA].sides.size(); ++sideA) {
+                    // цвета пикселей стороны A уже сняты с картинки объекта A и приведены к длине kProfileLength
+                    const SideDescriptor descA = sides_table[sides_table.index(objA, sideA)];
+                    const int channels = SideDescriptorTable::kChannels;
+
+                    // перебираем лучших кандидатов - стороны B других объектов, от лучшего к худшему
+                    const auto candidates = side_candidates.candidates(sides_table.index(objA, sideA));
+                    for (std::size_t candidate = 0; candidate < candidates.size(); ++candidate) {
+                        // и цвета стороны B (каждая сторона - по часовой стрелке)
+                        // стороны как борящиеся друг против друга шестеренки трутся и расходятся в противоположных направлениях,
+                        // поэтому чтобы сравнить их пиксель за пикселем как zip-молнию - нужно обходить сторону B в обратном порядке
+                        // (i-му отсчету A соответствует отсчет n - 1 - i стороны B))
+                        const SideDescriptor descB = sides_table[candidates[candidate].side];
+                        const int objB = descB.piece;
+                        const int sideB = descB.side;
+
+                        // обе стороны уже выравнены по длине
+                        const int n = SideDescriptorTable::kProfileLength;
+                        // TODO 2 посмотрите на графики и подумайте, может имеет смысл как-то воздействовать на снятые с границы цвета?
+                        // например сгладить? если решите попробовать - воспользуйтесь готовой функцией blur(std::vector<color8u> colors, float strength)
+
+                        // DONE 4 и наконец финальный вердикт - насколько сильно отличаются эти две стороны: средняя попиксельная разница,
+                        // она уже посчитана при поиске кандидатов
+                        float total_difference = candidates[candidate].difference;
+
+                        if (candidate == 0) {
+                            // кандидаты упорядочены по разнице - первый и есть лучший ответ, а второй (если он есть) - второй по лучшевизне
+                            float second_best = candidates.size() > 1 ? candidates[1].difference : -1;
+                            objMatchedSides[objA][sideA] = {objB, sideB, total_difference, second_best};
+                        }
+
+                        if (draw_sides_matching_plots) {
+                            std::vector<color8u> a = sides_table.colorProfile(sides_table.index(objA, sideA));
+                            std::vector<color8u> b = sides_table.colorProfile(sides_table.index(objB, sideB));
+
+                            // насколько сильно отличается каждая пара отсчетов (только для графика)
                             std::vector<float> differences(n);
-                            FastRandom r(2391); // просто генератор случайных чисел
                             for (int i = 0; i < n; ++i) {
                                 float d = 0;
-                                color8u colA = a[i];
-                                color8u colB = b[i];
-                                // TODO 3 реализуйте какую-то метрику сравнивающую насколько эти два цвета colA и colB отличаются
                                 for (int c = 0; c < channels; ++c) {
-                                    uint8_t colAChannelIntensity = colA(c);
-                                    uint8_t colBChannelIntensity = colB(c);
-                                    d += r.nextInt(0, 20); // сейчас я ссуммирую случайные числа, просто чтобы что-то было видно на графике
+                                    d += std::abs(descA.colors[c * n + i] - descB.colors[c * n + n - 1 - i]);
                                 }
                                 differences[i] = d;
                             }
-                            for (int i = 0; i < n; ++i) {
-                                rassert(differences[i] >= 0.0f, 32423415214, differences[i]);
-                            }
 
-                            // TODO 4 и наконец финальный вердикт - насколько сильно отличаются эти две стороны? например это может быть медиана попиксельных разниц
-                            // (не забудьте про stats::median, stats:sum, stats::percentile)
-                            float total_difference = differences[0]; // это совсем простой вариант чтобы код просто компилировался - тут мы берем разницу первого попавшегося одного пикселя
-
-                            float previous_best = objMatchedSides[objA][sideA].differenceBest;
-                            if (previous_best == -1 || total_difference <= previous_best) {
-                                // если раньше сопоставления еще не было вовсе (-1)
-                                // если если наше сопоставление лучше (наша разница меньше старой)
-                                // то сохраняем текущее сопоставление как пока что лучший ответ (старый ответ становится вторым по лучшевизне)
-                                objMatchedSides[objA][sideA] = {objB, sideB, total_difference, previous_best};
-                            }
-
-                            if (draw_sides_matching_plots) {
-                                // сделаем небольшой предпросмотр обоих объектов с отмеченными сторонами
-                                int preview_image_width = n;
-                                int preview_image_height = n;
-
-                                int colors_rgb_line_height = 10;
-                                int separator_line_height = 3;
-                                int graph_height = 100;
-                                // визуализируем наложение этих двух сторон
-                                image8u ab_visualization(n + n, std::max(2 * preview_image_height,  2 * colors_rgb_line_height + 4 * separator_line_height + 2 * graph_height + graph_height), 3);
-
-                                // сначала нарисуем объект A + на нем отмеченная сторона A
-                                point2i offset = {0, 0}; // это точка отступа - где находится угол следующего рисуемого объекта
-                                image8u previewA = objImages[objA];
-                                drawPoints(previewA, objSides[objA][sideA], color8u(255, 0, 0), 5);
-                                previewA = downsample(blur(previewA, previewA.width() / preview_image_width), preview_image_width, preview_image_height);
-                                drawImage(ab_visualization, previewA, offset);
-                                offset.y += preview_image_height; // смещаем отступ на высоту нарисованной картинки
-
-                                // затем объект B + на нем отмеченная сторона B
-                                image8u previewB = objImages[objB];
-                                drawPoints(previewB, objSides[objB][sideB], color8u(255, 0, 0), 5);
-                                previewB = downsample(blur(previewB, previewB.width() / preview_image_width), preview_image_width, preview_image_height);
-                                drawImage(ab_visualization, previewB, offset);
-                                offset.y += preview_image_height;
-
-                                // графики рисуем в правой части картинки
-                                offset = {preview_image_width, 0};
-
-                                // сначала наложим сами цвета обеих сторон
-                                drawRGBLine(ab_visualization, a, offset, colors_rgb_line_height);
-                                offset.y += colors_rgb_line_height;
-                                drawRGBLine(ab_visualization, b, offset, colors_rgb_line_height);
-                                offset.y += colors_rgb_line_height;
-
-                                std::vector<color8u> separator_line_colors(n, color8u(0, 255, 0));
-
-                                // затем построим графики яркости этих сторон - красным цветом график яркости RED канала, зеленым и синим - GREEN/BLUE соответственно
-                                drawRGBLine(ab_visualization, separator_line_colors, offset, separator_line_height);
-                                offset.y += separator_line_height;
-                                drawGraph(ab_visualization, a, offset, graph_height);
-                                offset.y += graph_height;
-                                drawRGBLine(ab_visualization, separator_line_colors, offset, separator_line_height);
-                                offset.y += separator_line_height;
-                                drawGraph(ab_visualization, b, offset, graph_height);
-                                offset.y += graph_height;
-                                drawRGBLine(ab_visualization, separator_line_colors, offset, separator_line_height);
-                                offset.y += separator_line_height;
-
-                                // затем визуализируем графиком нашу метрику отличия
-                                float normalization_value = 100.0f; // график имеет шкалу от 0 до normalization_value
-                                drawGraph(ab_visualization, differences, offset, graph_height, normalization_value);
-                                offset.y += graph_height;
-                                drawRGBLine(ab_visualization, separator_line_colors, offset, separator_line_height);
-                                offset.y += separator_line_height;
-
-                                // заметьте что мы специально в начале файла пишем diff (еще и дополненный нулями)
-                                // благодаря этому мы прямо в списке файлов будем видеть лучшее и худшее сопоставление
-                                debug_io::dump_image(obj_debug_dir + "side" + std::to_string(sideA)
-                                    + "/diff=" + pad(total_difference, 5) + "_with_object" + std::to_string(objB) + "_side" + std::to_string(sideB) + ".png",
-                                    ab_visualization);
-                            }
+                            // сделаем небольшой предпросмотр обоих объектов с отмеченными сторонами
+                            int preview_image_width = n;
+                            int preview_image_height = n;
+
+                            int colors_rgb_line_height = 10;
+                            int separator_line_height = 3;
+                            int graph_height = 100;
+                            // визуализируем наложение этих двух сторон
+                            image8u ab_visualization(n + n, std::max(2 * preview_image_height,  2 * colors_rgb_line_height + 4 * separator_line_height + 2 * graph_height + graph_height), 3);
+
+                            // сначала нарисуем объект A + на нем отмеченная сторона A
+                            point2i offset = {0, 0}; // это точка отступа - где находится угол следующего рисуемого объекта
+                            image8u previewA = pieces[objA].image.toImage();
+                            drawPoints(previewA, pieces[objA].side(sideA).toPoints(), color8u(255, 0, 0), 5);
+                            previewA = downsample(previewA, preview_image_width, preview_image_height, DownsampleMethod::Area);
+                            drawImage(ab_visualization, previewA, offset);
+                            offset.y += preview_image_height; // смещаем отступ на высоту нарисованной картинки
+
+                            // затем объект B + на нем отмеченная сторона B
+                            image8u previewB = pieces[objB].image.toImage();
+                            drawPoints(previewB, pieces[objB].side(sideB).toPoints(), color8u(255, 0, 0), 5);
+                            previewB = downsample(previewB, preview_image_width, preview_image_height, DownsampleMethod::Area);
+                            drawImage(ab_visualization, previewB, offset);
+                            offset.y += preview_image_height;
+
+                            // графики рисуем в правой части картинки
+                            offset = {preview_image_width, 0};
+
+                            // сначала наложим сами цвета обеих сторон
+                            drawRGBLine(ab_visualization, a, offset, colors_rgb_line_height);
+                            offset.y += colors_rgb_line_height;
+                            drawRGBLine(ab_visualization, b, offset, colors_rgb_line_height);
+                            offset.y += colors_rgb_line_height;
+
+                            std::vector<color8u> separator_line_colors(n, color8u(0, 255, 0));
+
+                            // затем построим графики яркости этих сторон - красным цветом график яркости RED канала, зеленым и синим - GREEN/BLUE соответственно
+                            drawRGBLine(ab_visualization, separator_line_colors, offset, separator_line_height);
+                            offset.y += separator_line_height;
+                            drawGraph(ab_visualization, a, offset, graph_height);
+                            offset.y += graph_height;
+                            drawRGBLine(ab_visualization, separator_line_colors, offset, separator_line_height);
+                            offset.y += separator_line_height;
+                            drawGraph(ab_visualization, b, offset, graph_height);
+                            offset.y += graph_height;
+                            drawRGBLine(ab_visualization, separator_line_colors, offset, separator_line_height);
+                            offset.y += separator_line_height;
+
+                            // затем визуализируем графиком нашу метрику отличия
+                            float normalization_value = 100.0f; // график имеет шкалу от 0 до normalization_value
+                            drawGraph(ab_visualization, differences, offset, graph_height, normalization_value);
+                            offset.y += graph_height;
+                            drawRGBLine(ab_visualization, separator_line_colors, offset, separator_line_height);
+                            offset.y += separator_line_height;
+
+                            // заметьте что мы специально в начале файла пишем diff (еще и дополненный нулями)
+                            // благодаря этому мы прямо в списке файлов будем видеть лучшее и худшее сопоставление
+                            debug_io::dump_image(obj_debug_dir + "side" + std::to_string(sideA)
+                                + "/diff=" + pad(total_difference, 5) + "_with_object" + std::to_string(objB) + "_side" + std::to_string(sideB) + ".png",
+                                ab_visualization);
                         }
                     }
                 }
@@ -351,7 +307,7 @@ int main() {
                 // поэтому возможно вручную фиксировать правильный ответ
                 std::vector<std::vector<MatchedSide>> answers(objects_count);
                 for (int obj = 0; obj < objects_count; ++obj) {
-                    answers[obj].resize(objSides[obj].size());
+                    answers[obj].resize(pieces[obj].sides.size());
                 }
                 answers[0][0] = MatchedSide(1, 2, 239, 239);
                 answers[0][1] = MatchedSide(3, 3, 239, 239);
@@ -382,7 +338,7 @@ int main() {
                     // все сопоставления исходящие из сторон этого объекта - будут одного случайного цвета
                     color8u random_color_for_object = {(uint8_t) r.nextInt(0, 255), (uint8_t) r.nextInt(0, 255), (uint8_t) r.nextInt(0, 255)};
                     point2i random_shift = {r.nextInt(-segment_thickness, segment_thickness), r.nextInt(-segment_thickness, segment_thickness)}; // это нужно чтобы встречные ребра не наслоились закрыв друг друга, а было легко видеть что это два ребра
-                    for (int sideA = 0; sideA < objSides[objA].size(); ++sideA) {
+                    for (int sideA = 0; sideA < pieces[objA].sides.size(); ++sideA) {
                         auto [objB, sideB, differenceBest, differenceSecondBest] = objMatchedSides[objA][sideA];
 
                         if (correct_matches.count(image_name)) {
@@ -403,8 +359,8 @@ int main() {
                         }
 
                         std::cout << "obj" << objA << "-side" <<sideA << " -> obj" << objB << "-side" << sideB << " with difference=" << differenceBest << " (second best: " << differenceSecondBest << ")" << std::endl;
-                        point2i sideACenter = objOffsets[objA] + objSides[objA][sideA][objSides[objA][sideA].size() / 2]; // вершина в середине стороны A
-                        point2i sideBCenter = objOffsets[objB] + objSides[objB][sideB][objSides[objB][sideB].size() / 2]; // вершина в середине сопоставленной с ней стороны B
+                        point2i sideACenter = pieces[objA].offset + pieces[objA].side(sideA)[pieces[objA].side(sideA).size() / 2]; // вершина в середине стороны A
+                        point2i sideBCenter = pieces[objB].offset + pieces[objB].side(sideB)[pieces[objB].side(sideB).size() / 2]; // вершина в середине сопоставленной с ней стороны B
                         drawPoint(segments_between_matched_sides, random_shift + sideACenter, random_color_for_object, 4 * segment_thickness);
                         drawSegment(segments_between_matched_sides, random_shift + sideACenter, random_shift + sideBCenter, random_color_for_object, segment_thickness);
                     }
@@ -416,6 +372,62 @@ int main() {
                 debug_io::dump_image(debug_dir + "07_matched_sides.jpg", segments_between_matched_sides);
             }
 
+            {
+                // глобальная сборка: вместо независимых лучших сопоставлений для каждой стороны - согласованная раскладка всех объектов по сетке
+                // лучевой поиск держит несколько вариантов раскладки, поэтому не ошибается необратимо на неоднозначных кусочках
+                AssemblyParams assembly_params;
+                assembly_params.beam_width = 16;
+                t.restart();
+                Assembly assembly = assemblePuzzle(sides_table, side_candidates, assembly_params);
+                const double assembly_time = t.elapsed();
+                std::cout << "assembled into " << assembly.components << " components in " << assembly_time << " sec (" << assembly.search_nodes
+                          << " beam search nodes, " << (assembly_time > 0.0 ? assembly.search_nodes / assembly_time : 0.0) << " nodes/sec)" << std::endl;
+
+                // напечатаем раскладку каждой компоненты: в каждой клетке - номер объекта и его поворот
+                for (int component = 0; component < assembly.components; ++component) {
+                    int min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+                    for (const PiecePlacement &placement : assembly.placements) {
+                        if (placement.component != component)
+                            continue;
+                        min_x = std::min(min_x, placement.x);
+                        min_y = std::min(min_y, placement.y);
+                        max_x = std::max(max_x, placement.x);
+                        max_y = std::max(max_y, placement.y);
+                    }
+                    std::cout << "component " << component << ":" << std::endl;
+                    for (int y = min_y; y <= max_y; ++y) {
+                        for (int x = min_x; x <= max_x; ++x) {
+                            int obj = assembly.pieceAt(component, x, y);
+                            if (obj == -1) {
+                                std::cout << "     .";
+                            } else {
+                                std::cout << std::setw(4) << obj << "r" << assembly.placements[obj].rotation;
+                            }
+                        }
+                        std::cout << std::endl;
+                    }
+                }
+
+                if (correct_matches.count(image_name)) {
+                    // сколько соседств в раскладке совпадают с захардкоженными ответами
+                    int correct_neighbours_count = 0;
+                    for (int objA = 0; objA < objects_count; ++objA) {
+                        for (GridDirection direction : {GridDirection::Right, GridDirection::Down}) {
+                            auto [objB, sideB] = assembly.neighbour(objA, direction);
+                            if (objB == -1)
+                                continue;
+                            const MatchedSide &expected = correct_matches[image_name][objA][assembly.sideFacing(objA, direction)];
+                            if (expected.objB == objB && expected.sideB == sideB)
+                                correct_neighbours_count++;
+                        }
+                    }
+                    std::cout << "assembly: " << correct_neighbours_count << " of " << assembly.edges << " neighbours are correct" << std::endl;
+                }
+            }
+
+            ImageAllocationStats allocation_stats = imageAllocationStats();
+            std::cout << "image buffers: " << allocation_stats.requests << " requested (" << (allocation_stats.requested_bytes >> 20) << " MB), "
+                      << allocation_stats.allocations << " allocated (" << (allocation_stats.allocated_bytes >> 20) << " MB)" << std::endl;
             std::cout << "image " << image_name << " processed in " << total_t.elapsed() << " sec" << std::endl;
         }
         std::cout << "all images processed in " << all_images_t.elapsed() << " sec" << std::endl;
@@ -35,31 +35,7 @@ inline int sample_index_round(int i, int n, int m) {
 
 } // namespace
 
-std::vector<color8u> extractColors(const image8u &image, const std::vector<point2i> &pixels) {
-    rassert(image.channels() == 1 || image.channels() == 3, 983417231, image.channels());
-
-    std::vector<color8u> out;
-    out.reserve(pixels.size());
-
-    const int w = image.width();
-    const int h = image.height();
-    const int c = image.channels();
-
-    for (const auto& p : pixels) {
-        rassert(p.x >= 0 && p.x < w && p.y >= 0 && p.y < h, 983417232);
-
-        if (c == 3) {
-            out.emplace_back(image(p.y, p.x, 0), image(p.y, p.x, 1), image(p.y, p.x, 2));
-        } else {
-            uint8_t v = image(p.y, p.x);
-            out.emplace_back(v, v, v);
-        }
-    }
-
-    return out;
-}
-
-void drawImage(image8u &image, image8u &image_part, point2i offset) {
+void drawImage(image8u &image, ImageView<const std::uint8_t> image_part, point2i offset) {
     rassert(offset.y + image_part.height() <= image.height(), 1231412431);
     rassert(offset.x + image_part.width() <= image.width(), 64534524523);
     rassert(image.channels() == image_part.channels(), 3427823974238);
@@ -6,11 +6,10 @@
 #include <libbase/point2.h>
 #include <libimages/color.h>
 #include <libimages/image.h>
+#include <libimages/image_view.h>
 
 
-std::vector<color8u> extractColors(const image8u &image, const std::vector<point2i> &pixels);
-
-void drawImage(image8u &image, image8u &image_part, point2i offset);
+void drawImage(image8u &image, ImageView<const std::uint8_t> image_part, point2i offset);
 
 void drawRGBLine(image8u &image, std::vector<color8u> &a, point2i offset, int height);
 